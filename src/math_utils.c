@@ -1,87 +1,198 @@
+// Built two ways: as its own translation unit exporting the ABI symbols,
+// or pulled into math_utils.h as static inline definitions when the
+// includer defines MATH_UTILS_INLINE.
+#ifndef MATH_UTILS_INLINE_IMPL
+#undef MATH_UTILS_INLINE
 #include "math_utils.h"
+#endif
+
+#include <limits.h>
 
 // Add two integers
-int add(int a, int b) {
+MATH_UTILS_API int add(int a, int b) {
     return a + b;
 }
 
 // Subtract two integers
-int subtract(int a, int b) {
+MATH_UTILS_API int subtract(int a, int b) {
     return a - b;
 }
 
 // Multiply two integers
-int multiply(int a, int b) {
+MATH_UTILS_API int multiply(int a, int b) {
     return a * b;
 }
 
-// Integer absolute value
-int abs_value(int x) {
-    if (x < 0) {
-        return -x;
-    }
-    return x;
+// abs_value, max_value, min_value and is_even are branchless: a
+// comparison becomes an all-ones (or zero) mask that selects the result,
+// so random data costs no branch mispredictions even where the compiler
+// would keep a branch. Arithmetic goes through unsigned so it wraps as the
+// batch kernels do.
+
+// Integer absolute value: (x ^ mask) - mask negates x when mask is all
+// ones. INT_MIN maps to INT_MIN, as in abs_value_n.
+MATH_UTILS_API int abs_value(int x) {
+    unsigned int mask = 0u - (unsigned int)(x < 0);
+    return (int)(((unsigned int)x ^ mask) - mask);
 }
 
-// Maximum of two integers
-int max_value(int a, int b) {
-    if (a > b) {
-        return a;
-    }
-    return b;
+// Maximum of two integers: b ^ (a ^ b) is a
+MATH_UTILS_API int max_value(int a, int b) {
+    unsigned int mask = 0u - (unsigned int)(a > b);
+    return (int)((unsigned int)b ^ (((unsigned int)a ^ (unsigned int)b) & mask));
 }
 
 // Minimum of two integers
-int min_value(int a, int b) {
-    if (a < b) {
-        return a;
-    }
-    return b;
+MATH_UTILS_API int min_value(int a, int b) {
+    unsigned int mask = 0u - (unsigned int)(a < b);
+    return (int)((unsigned int)b ^ (((unsigned int)a ^ (unsigned int)b) & mask));
 }
 
-// Check if number is even
-int is_even(int x) {
-    return x % 2 == 0;
+// Check if number is even: the low bit, not a division
+MATH_UTILS_API int is_even(int x) {
+    return (x & 1) == 0;
 }
 
 // Check if number is positive
-int is_positive(int x) {
+MATH_UTILS_API int is_positive(int x) {
     return x > 0;
 }
 
-// Factorial (0 to 10)
-int factorial(int n) {
-    if (n < 0) {
-        return -1;  // Error case
+// Overflow-checked addition
+MATH_UTILS_API int checked_add(int a, int b, int *out) {
+    int result;
+    if (__builtin_add_overflow(a, b, &result)) {
+        return MATH_ERR_OVERFLOW;
     }
-    if (n == 0 || n == 1) {
-        return 1;
+    *out = result;
+    return MATH_OK;
+}
+
+// Overflow-checked subtraction
+MATH_UTILS_API int checked_subtract(int a, int b, int *out) {
+    int result;
+    if (__builtin_sub_overflow(a, b, &result)) {
+        return MATH_ERR_OVERFLOW;
+    }
+    *out = result;
+    return MATH_OK;
+}
+
+// Overflow-checked multiplication
+MATH_UTILS_API int checked_multiply(int a, int b, int *out) {
+    int result;
+    if (__builtin_mul_overflow(a, b, &result)) {
+        return MATH_ERR_OVERFLOW;
+    }
+    *out = result;
+    return MATH_OK;
+}
+
+// Overflow-checked absolute value
+MATH_UTILS_API int checked_abs_value(int x, int *out) {
+    int result = x;
+    if (x < 0 && __builtin_sub_overflow(0, x, &result)) {
+        return MATH_ERR_OVERFLOW;
+    }
+    *out = result;
+    return MATH_OK;
+}
+
+// Saturating addition
+MATH_UTILS_API int saturating_add(int a, int b) {
+    int result;
+    if (__builtin_add_overflow(a, b, &result)) {
+        return a < 0 ? INT_MIN : INT_MAX;
+    }
+    return result;
+}
+
+// Saturating subtraction
+MATH_UTILS_API int saturating_subtract(int a, int b) {
+    int result;
+    if (__builtin_sub_overflow(a, b, &result)) {
+        return a < 0 ? INT_MIN : INT_MAX;
     }
+    return result;
+}
 
-    int result = 1;
-    for (int i = 2; i <= n; i++) {
-        result *= i;
+// Saturating multiplication
+MATH_UTILS_API int saturating_multiply(int a, int b) {
+    int result;
+    if (__builtin_mul_overflow(a, b, &result)) {
+        return (a < 0) != (b < 0) ? INT_MIN : INT_MAX;
     }
     return result;
 }
 
+// Saturating absolute value
+MATH_UTILS_API int saturating_abs_value(int x) {
+    if (x == INT_MIN) {
+        return INT_MAX;
+    }
+    return x < 0 ? -x : x;
+}
+
+// factorial(0..FACTORIAL_MAX_N): every factorial that fits in an int
+static const int factorial_table[FACTORIAL_MAX_N + 1] = {
+    1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800, 479001600
+};
+
+// fibonacci(0..FIBONACCI_MAX_N): every fibonacci number that fits in an int
+static const int fibonacci_table[FIBONACCI_MAX_N + 1] = {
+    0, 1, 1, 2, 3, 5, 8, 13, 21, 34,
+    55, 89, 144, 233, 377, 610, 987, 1597, 2584, 4181,
+    6765, 10946, 17711, 28657, 46368, 75025, 121393, 196418, 317811, 514229,
+    832040, 1346269, 2178309, 3524578, 5702887, 9227465, 14930352, 24157817, 39088169, 63245986,
+    102334155, 165580141, 267914296, 433494437, 701408733, 1134903170, 1836311903
+};
+
+// Factorial (0 to FACTORIAL_MAX_N)
+MATH_UTILS_API int factorial(int n) {
+    if (n < 0) {
+        return -1;  // Error case
+    }
+    if (n > FACTORIAL_MAX_N) {
+        return -1;  // Overflow: n! does not fit in an int
+    }
+    return factorial_table[n];
+}
+
 // Fibonacci number (0-indexed)
-int fibonacci(int n) {
+MATH_UTILS_API int fibonacci(int n) {
     if (n < 0) {
         return -1;  // Error case
     }
-    if (n == 0) {
-        return 0;
+    if (n > FIBONACCI_MAX_N) {
+        return -1;  // Overflow: F(n) does not fit in an int
+    }
+    return fibonacci_table[n];
+}
+
+// factorial(first) .. factorial(first + count - 1), copied from the table
+MATH_UTILS_API int factorial_range(int first, size_t count, int *out) {
+    if (first < 0) {
+        return MATH_ERR_DOMAIN;
+    }
+    if (count > 0 && (first > FACTORIAL_MAX_N || count - 1 > (size_t)(FACTORIAL_MAX_N - first))) {
+        return MATH_ERR_OVERFLOW;
     }
-    if (n == 1) {
-        return 1;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = factorial_table[(size_t)first + i];
     }
+    return MATH_OK;
+}
 
-    int a = 0, b = 1;
-    for (int i = 2; i <= n; i++) {
-        int temp = a + b;
-        a = b;
-        b = temp;
+// fibonacci(first) .. fibonacci(first + count - 1), copied from the table
+MATH_UTILS_API int fibonacci_range(int first, size_t count, int *out) {
+    if (first < 0) {
+        return MATH_ERR_DOMAIN;
+    }
+    if (count > 0 && (first > FIBONACCI_MAX_N || count - 1 > (size_t)(FIBONACCI_MAX_N - first))) {
+        return MATH_ERR_OVERFLOW;
+    }
+    for (size_t i = 0; i < count; i++) {
+        out[i] = fibonacci_table[(size_t)first + i];
     }
-    return b;
+    return MATH_OK;
 }
@@ -1,36 +1,297 @@
 #ifndef MATH_UTILS_H
 #define MATH_UTILS_H
 
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
 // Basic math utilities for testing
 
+// Status codes returned by the extended (non-int) API
+typedef enum {
+    MATH_OK = 0,
+    MATH_ERR_DOMAIN = -1,    // Argument outside the function's domain
+    MATH_ERR_OVERFLOW = -2,  // Result does not fit in the output type
+    MATH_ERR_NOMEM = -3      // Allocation failed
+} math_status;
+
+// Defining MATH_UTILS_INLINE before including this header turns the
+// scalar functions below (those in math_utils.c) into static inline
+// definitions so callers' loops can inline and vectorize them.
+// math_utils.c still exports every symbol for non-inline callers.
+#ifdef MATH_UTILS_INLINE
+#define MATH_UTILS_API static inline
+#else
+#define MATH_UTILS_API
+#endif
+
+// Largest n whose factorial(n) / fibonacci(n) fits in an int
+#define FACTORIAL_MAX_N 12
+#define FIBONACCI_MAX_N 46
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // Add two integers
-int add(int a, int b);
+MATH_UTILS_API int add(int a, int b);
 
 // Subtract two integers
-int subtract(int a, int b);
+MATH_UTILS_API int subtract(int a, int b);
 
 // Multiply two integers
-int multiply(int a, int b);
+MATH_UTILS_API int multiply(int a, int b);
 
-// Integer absolute value
-int abs_value(int x);
+// Integer absolute value; INT_MIN maps to INT_MIN (as in abs_value_n)
+MATH_UTILS_API int abs_value(int x);
 
 // Maximum of two integers
-int max_value(int a, int b);
+MATH_UTILS_API int max_value(int a, int b);
 
 // Minimum of two integers
-int min_value(int a, int b);
+MATH_UTILS_API int min_value(int a, int b);
 
 // Check if number is even
-int is_even(int x);
+MATH_UTILS_API int is_even(int x);
 
 // Check if number is positive
-int is_positive(int x);
+MATH_UTILS_API int is_positive(int x);
+
+// Factorial, -1 if n < 0 or n > FACTORIAL_MAX_N (O(1) table lookup)
+MATH_UTILS_API int factorial(int n);
+
+// Fibonacci number (0-indexed), -1 if n < 0 or n > FIBONACCI_MAX_N
+// (O(1) table lookup)
+MATH_UTILS_API int fibonacci(int n);
+
+// factorial / fibonacci of first .. first + count - 1 into out[0..count-1],
+// in one pass over the tables. Return MATH_OK, MATH_ERR_DOMAIN for
+// first < 0, or MATH_ERR_OVERFLOW (nothing written) when the last value
+// does not fit in an int.
+MATH_UTILS_API int factorial_range(int first, size_t count, int *out);
+MATH_UTILS_API int fibonacci_range(int first, size_t count, int *out);
+
+// ============ Overflow-checked arithmetic ============
+// Return MATH_OK and store the exact result in *out, or return
+// MATH_ERR_OVERFLOW and leave *out unchanged.
+
+MATH_UTILS_API int checked_add(int a, int b, int *out);
+MATH_UTILS_API int checked_subtract(int a, int b, int *out);
+MATH_UTILS_API int checked_multiply(int a, int b, int *out);
+MATH_UTILS_API int checked_abs_value(int x, int *out);  // Overflows only for INT_MIN
+
+// ============ Saturating arithmetic ============
+// Results that would overflow are clamped to INT_MIN / INT_MAX.
+
+MATH_UTILS_API int saturating_add(int a, int b);
+MATH_UTILS_API int saturating_subtract(int a, int b);
+MATH_UTILS_API int saturating_multiply(int a, int b);
+MATH_UTILS_API int saturating_abs_value(int x);  // INT_MIN maps to INT_MAX
+
+// ============ Wide fibonacci ============
+// Each returns MATH_OK and stores F(n) in *out, or MATH_ERR_DOMAIN for
+// n < 0 and MATH_ERR_OVERFLOW when F(n) does not fit (n > 92 for int64_t,
+// n > 93 for uint64_t, n > 186 for unsigned __int128).
+//
+// The 64-bit forms read a lock-free cache shared by all threads, which is
+// extended lazily up to the largest n asked for; after that a query is one
+// shared read. The others use fast doubling, O(log n).
+
+int fibonacci_i64(int64_t n, int64_t *out);
+int fibonacci_u64(uint64_t n, uint64_t *out);
+
+// F(first) .. F(first + count - 1) into out[0..count-1] from the same
+// cache. Returns MATH_OK, or MATH_ERR_OVERFLOW (nothing written) when the
+// last one does not fit.
+int fibonacci_range_u64(uint64_t first, size_t count, uint64_t *out);
+#ifdef __SIZEOF_INT128__
+int fibonacci_u128(uint64_t n, unsigned __int128 *out);
+#endif
+
+// Arbitrary-precision unsigned integer
+typedef struct {
+    uint64_t *limbs;  // Little-endian 64-bit limbs
+    size_t len;       // Limbs in use; 0 represents zero
+} math_bigint;
+
+#define MATH_BIGINT_INIT { NULL, 0 }
+
+// Release the limbs of x and reset it to zero
+void math_bigint_free(math_bigint *x);
+
+// Decimal representation of x (caller frees), NULL on allocation failure
+char *math_bigint_to_decimal(const math_bigint *x);
+
+// F(n) for any n; *out is overwritten (free it first if reused).
+// Returns MATH_OK or MATH_ERR_NOMEM.
+int fibonacci_big(uint64_t n, math_bigint *out);
+
+// ============ Modular factorial and fibonacci ============
+// Each stores n! mod m or F(n) mod m in *out and returns MATH_OK, or
+// MATH_ERR_DOMAIN for m == 0. Products are reduced with Montgomery
+// multiplication for odd m.
+//
+// fibonacci_mod is O(log n). factorial_mod is O(1) for n >= m (the result
+// is 0) and n <= 20; otherwise it sweeps to n from a prefix table of
+// (i * 1024)! mod m, except that for prime m and n > m/2 Wilson's theorem
+// turns it into a sweep to m - 1 - n. The table is kept for the most
+// recent modulus and grows to the largest sweep asked for, so the first
+// query up to n is O(n) and later ones O(1024). It stops growing at 2^29
+// (4 MiB); past that, sweeps run on from its last entry.
+
+int factorial_mod(uint64_t n, uint64_t m, uint64_t *out);
+int fibonacci_mod(uint64_t n, uint64_t m, uint64_t *out);
+
+// The same for out[i] = x[i]! mod m or F(x[i]) mod m, over n elements
+// against one modulus, which is set up once. factorial_mod_n answers its
+// queries in one pass up to the largest one, in any input order, jumping
+// ahead through the same prefix table; it returns MATH_ERR_NOMEM when it
+// cannot allocate the sweep order.
+int factorial_mod_n(const uint64_t *x, uint64_t m, uint64_t *out, size_t n);
+int fibonacci_mod_n(const uint64_t *x, uint64_t m, uint64_t *out, size_t n);
+
+// ============ Batch (array) API ============
+// Each *_n function applies its scalar counterpart element-wise over n
+// elements: out[i] = f(a[i], b[i]) or out[i] = f(x[i]). Output may alias
+// an input. add/subtract/multiply wrap on overflow and abs_value_n maps
+// INT_MIN to INT_MIN, so every kernel gives bit-identical results.
+
+// SIMD instruction sets the batch kernels can be dispatched to
+typedef enum {
+    MATH_SIMD_SCALAR = 0,
+    MATH_SIMD_SSE2 = 1,
+    MATH_SIMD_AVX2 = 2,
+    MATH_SIMD_AVX512 = 3
+} math_simd_level;
+
+// Best SIMD level supported by the running CPU
+math_simd_level math_simd_detect(void);
+
+// SIMD level currently used by the batch functions
+math_simd_level math_simd_active(void);
+
+// Force a SIMD level (0 on success, -1 if the CPU does not support it)
+int math_simd_force(math_simd_level level);
+
+void add_n(const int *a, const int *b, int *out, size_t n);
+void subtract_n(const int *a, const int *b, int *out, size_t n);
+void multiply_n(const int *a, const int *b, int *out, size_t n);
+void max_value_n(const int *a, const int *b, int *out, size_t n);
+void min_value_n(const int *a, const int *b, int *out, size_t n);
+void abs_value_n(const int *x, int *out, size_t n);
+void is_even_n(const int *x, int *out, size_t n);
+void is_positive_n(const int *x, int *out, size_t n);
+void saturating_add_n(const int *a, const int *b, int *out, size_t n);
+void saturating_subtract_n(const int *a, const int *b, int *out, size_t n);
+void saturating_multiply_n(const int *a, const int *b, int *out, size_t n);
+void saturating_abs_value_n(const int *x, int *out, size_t n);
+void factorial_n(const int *x, int *out, size_t n);
+void fibonacci_n(const int *x, int *out, size_t n);
+
+// ============ Reductions ============
+// Horizontal SIMD reductions over n elements, dispatched like the batch
+// functions. An empty array reduces to the identity: INT_MIN for
+// max_reduce, INT_MAX for min_reduce.
+
+int max_reduce(const int *x, size_t n);
+int min_reduce(const int *x, size_t n);
+
+// Both extremes in one pass over x
+void minmax_reduce(const int *x, size_t n, int *min, int *max);
+
+// Number of elements for which is_even / is_positive holds
+size_t count_even(const int *x, size_t n);
+size_t count_positive(const int *x, size_t n);
+
+// Sum of the elements, widened to 64 bits: exact for n <= 2^32, and
+// wrapping modulo 2^64 beyond that
+int64_t sum_reduce(const int *x, size_t n);
+
+// ============ Parallel batch API ============
+// parallel_<f> gives the same result as <f> above, with the array cut into
+// cache-sized chunks that a persistent pool of worker threads shares out by
+// work stealing. The calling thread is one of the workers; the others are
+// started on first use, pinned to one CPU each and kept for later calls.
+// Calls from several threads are run one after another. Arrays of at most
+// one chunk are processed by the caller alone.
+
+// Most threads a parallel call uses
+#define MATH_PARALLEL_MAX_THREADS 256
+
+// Threads per parallel call, the caller included: 0 (the default) means
+// one per online CPU. MATH_OK, or MATH_ERR_DOMAIN above
+// MATH_PARALLEL_MAX_THREADS.
+int math_parallel_set_threads(size_t threads);
+
+// Threads a parallel call currently uses
+size_t math_parallel_threads(void);
+
+// Elements per chunk, rounded up to a multiple of 16; 0 (the default)
+// sizes chunks to share half the L2 cache between two inputs and an output
+void math_parallel_set_chunk(size_t elements);
+
+// Elements per chunk currently used
+size_t math_parallel_chunk(void);
+
+// 64-byte-aligned array of n ints. Each worker zeroes the chunks it starts
+// out owning in an n-element call (with the thread count and chunk size
+// current at allocation), without stealing, so on NUMA machines the pages
+// of worker i > 0 start out on the node of its pinned CPU. Worker 0's
+// share is zeroed by the calling thread, which is not pinned. Release with
+// free(); NULL on allocation failure.
+int *math_parallel_alloc(size_t n);
+
+void parallel_add_n(const int *a, const int *b, int *out, size_t n);
+void parallel_subtract_n(const int *a, const int *b, int *out, size_t n);
+void parallel_multiply_n(const int *a, const int *b, int *out, size_t n);
+void parallel_max_value_n(const int *a, const int *b, int *out, size_t n);
+void parallel_min_value_n(const int *a, const int *b, int *out, size_t n);
+void parallel_abs_value_n(const int *x, int *out, size_t n);
+void parallel_is_even_n(const int *x, int *out, size_t n);
+void parallel_is_positive_n(const int *x, int *out, size_t n);
+void parallel_saturating_add_n(const int *a, const int *b, int *out, size_t n);
+void parallel_saturating_subtract_n(const int *a, const int *b, int *out, size_t n);
+void parallel_saturating_multiply_n(const int *a, const int *b, int *out, size_t n);
+void parallel_saturating_abs_value_n(const int *x, int *out, size_t n);
+void parallel_factorial_n(const int *x, int *out, size_t n);
+void parallel_fibonacci_n(const int *x, int *out, size_t n);
+
+// Reductions, with the same identities and wrapping as the sequential ones
+int parallel_max_reduce(const int *x, size_t n);
+int parallel_min_reduce(const int *x, size_t n);
+int64_t parallel_sum_reduce(const int *x, size_t n);
+
+#ifdef MATH_UTILS_INLINE
+#define MATH_UTILS_INLINE_IMPL
+#include "math_utils.c"
+#undef MATH_UTILS_INLINE_IMPL
+#endif
+
+#ifdef __cplusplus
+} // extern "C"
+
+// constexpr versions of factorial() and fibonacci() for C++ callers;
+// same results and error values as the C functions.
+namespace math_utils {
+
+constexpr int factorial(int n) {
+    return (n < 0 || n > FACTORIAL_MAX_N) ? -1
+         : (n <= 1) ? 1
+         : n * factorial(n - 1);
+}
+
+namespace detail {
+// Linear tail recursion: (a, b) = (F(k), F(k+1)), n steps remaining
+constexpr int fibonacci_step(int n, int a, int b) {
+    return n == 0 ? a : n == 1 ? b : fibonacci_step(n - 1, b, a + b);
+}
+} // namespace detail
 
-// Factorial (0 to 10)
-int factorial(int n);
+constexpr int fibonacci(int n) {
+    return (n < 0 || n > FIBONACCI_MAX_N) ? -1 : detail::fibonacci_step(n, 0, 1);
+}
 
-// Fibonacci number (0-indexed)
-int fibonacci(int n);
+} // namespace math_utils
+#endif
 
 #endif // MATH_UTILS_H
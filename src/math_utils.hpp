@@ -0,0 +1,423 @@
+#ifndef MATH_UTILS_HPP
+#define MATH_UTILS_HPP
+
+#include "math_utils.h"
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+// C++20 templates over math_utils.h for every integer width.
+//
+// The scalar functions are constexpr templates over any integer type, from
+// int8_t to __int128 and the unsigned types, with the semantics of
+// math_utils.c: max_value, min_value, is_even and is_positive as there, and
+// add, subtract, multiply and abs_value under an overflow policy:
+//   wrap      the result modulo 2^bits, like add() and abs_value(INT_MIN)
+//   check     a checked<T> holding MATH_OK and the result, or
+//             MATH_ERR_OVERFLOW, like checked_add()
+//   saturate  clamped to the type's range, like saturating_add()
+//
+//   math_utils::add(a, b)              wrap
+//   math_utils::add<check>(a, b)       checked<T>
+//   math_utils::add<saturate>(a, b)    T
+//
+// The std::span forms apply them element-wise. For int they call the C
+// batch functions and so the SIMD kernel picked at run time; other widths
+// run a loop marked for the compiler to vectorize (64-bit lanes need more
+// than SSE2, e.g. -march=x86-64-v3).
+
+// Marks a batch loop for vectorization (needs -fopenmp-simd)
+#define MATH_UTILS_SIMD_REDUCTION(op, var) _Pragma(MATH_UTILS_STRINGIFY(omp simd reduction(op : var)))
+#define MATH_UTILS_STRINGIFY(x) #x
+
+namespace math_utils {
+
+// ============ Integer types ============
+
+namespace detail {
+
+// The unsigned type of the same width, for every integer type but bool
+template <class T, class = void>
+struct unsigned_of {};
+
+template <class T>
+struct unsigned_of<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    using type = std::make_unsigned_t<T>;
+};
+
+// __int128 is not an integral type under -std=c++NN, only -std=gnu++NN
+#ifdef __SIZEOF_INT128__
+template <>
+struct unsigned_of<__int128> {
+    using type = unsigned __int128;
+};
+
+template <>
+struct unsigned_of<unsigned __int128> {
+    using type = unsigned __int128;
+};
+#endif
+
+} // namespace detail
+
+template <class T>
+concept integer = std::is_same_v<T, std::remove_cv_t<T>>
+                  && requires { typename detail::unsigned_of<T>::type; };
+
+namespace detail {
+
+template <integer T>
+inline constexpr bool is_signed = T(-1) < T(0);
+
+template <integer T>
+inline constexpr T max_of = T(typename unsigned_of<T>::type(-1) >> (is_signed<T> ? 1 : 0));
+
+template <integer T>
+inline constexpr T min_of = is_signed<T> ? T(-max_of<T> - 1) : T(0);
+
+template <integer T>
+constexpr bool is_negative(T x) {
+    if constexpr (is_signed<T>) {
+        return x < T(0);
+    } else {
+        return false;
+    }
+}
+
+// Unsigned type no narrower than unsigned int: arithmetic in it wraps
+// instead of promoting to int
+template <integer T>
+using wrapping_t = decltype(typename unsigned_of<T>::type() + 0u);
+
+// Narrowest type that holds the exact product of two Ts, when one of at
+// most 64 bits does
+template <integer T>
+using product_t = std::conditional_t<
+    2 * sizeof(T) <= sizeof(int), std::conditional_t<is_signed<T>, int, unsigned>,
+    std::conditional_t<is_signed<T>, long long, unsigned long long>>;
+
+template <integer T>
+inline constexpr bool has_product_t = sizeof(T) <= sizeof(product_t<T>) / 2;
+
+} // namespace detail
+
+// ============ Overflow policies ============
+
+struct wrap {};
+struct check {};
+struct saturate {};
+
+template <class P>
+concept overflow_policy = std::is_same_v<P, wrap> || std::is_same_v<P, check>
+                          || std::is_same_v<P, saturate>;
+
+// Result under the check policy. On MATH_ERR_OVERFLOW, value holds the
+// wrapped result.
+template <integer T>
+struct checked {
+    math_status status;
+    T value;
+
+    constexpr bool ok() const { return status == MATH_OK; }
+    constexpr bool operator==(const checked &) const = default;
+};
+
+template <overflow_policy P, integer T>
+using result_t = std::conditional_t<std::is_same_v<P, check>, checked<T>, T>;
+
+namespace detail {
+
+// Result of an operation under P, given its wrapped result, whether the
+// exact one overflowed and the bound saturate clamps it to
+template <overflow_policy P, integer T>
+constexpr result_t<P, T> finish(bool overflow, T wrapped, T limit) {
+    if constexpr (std::is_same_v<P, check>) {
+        return {overflow ? MATH_ERR_OVERFLOW : MATH_OK, wrapped};
+    } else if constexpr (std::is_same_v<P, saturate>) {
+        return overflow ? limit : wrapped;
+    } else {
+        return wrapped;
+    }
+}
+
+} // namespace detail
+
+// ============ Scalar functions ============
+// Overflow is found from the wrapped result, without branches or
+// __builtin_*_overflow (which GCC does not vectorize), so the batch loops
+// over them vectorize too. multiply only falls back to the builtin for
+// 64- and 128-bit types, which have no wider type to hold the product.
+
+template <overflow_policy P = wrap, integer T>
+constexpr result_t<P, T> add(T a, T b) {
+    using W = detail::wrapping_t<T>;
+    T wrapped = T(W(a) + W(b));
+    // Signed: a and b have the same sign and the sum the other one
+    bool overflow = detail::is_signed<T> ? detail::is_negative(T((a ^ wrapped) & (b ^ wrapped)))
+                                         : wrapped < a;
+    return detail::finish<P>(overflow, wrapped,
+                             detail::is_negative(b) ? detail::min_of<T> : detail::max_of<T>);
+}
+
+template <overflow_policy P = wrap, integer T>
+constexpr result_t<P, T> subtract(T a, T b) {
+    using W = detail::wrapping_t<T>;
+    T wrapped = T(W(a) - W(b));
+    // Signed: a and b have different signs and the difference that of b
+    bool overflow = detail::is_signed<T> ? detail::is_negative(T((a ^ b) & (a ^ wrapped)))
+                                         : a < b;
+    return detail::finish<P>(overflow, wrapped,
+                             detail::is_negative(b) ? detail::max_of<T> : detail::min_of<T>);
+}
+
+template <overflow_policy P = wrap, integer T>
+constexpr result_t<P, T> multiply(T a, T b) {
+    T wrapped{};
+    bool overflow;
+    if constexpr (detail::has_product_t<T>) {
+        detail::product_t<T> exact = detail::product_t<T>(a) * detail::product_t<T>(b);
+        wrapped = T(exact);
+        overflow = exact < detail::product_t<T>(detail::min_of<T>)
+                   || exact > detail::product_t<T>(detail::max_of<T>);
+    } else {
+        overflow = __builtin_mul_overflow(a, b, &wrapped);
+    }
+    return detail::finish<P>(overflow, wrapped,
+                             detail::is_negative(a) != detail::is_negative(b) ? detail::min_of<T>
+                                                                              : detail::max_of<T>);
+}
+
+// Overflows only for the minimum of a signed type, which is its own negation
+template <overflow_policy P = wrap, integer T>
+constexpr result_t<P, T> abs_value(T x) {
+    using W = detail::wrapping_t<T>;
+    T wrapped = detail::is_negative(x) ? T(W(0) - W(x)) : x;
+    return detail::finish<P>(detail::is_negative(wrapped), wrapped, detail::max_of<T>);
+}
+
+template <integer T>
+constexpr T max_value(T a, T b) {
+    return a < b ? b : a;
+}
+
+template <integer T>
+constexpr T min_value(T a, T b) {
+    return b < a ? b : a;
+}
+
+template <integer T>
+constexpr int is_even(T x) {
+    return (x & T(1)) == T(0);
+}
+
+template <integer T>
+constexpr int is_positive(T x) {
+    return x > T(0);
+}
+
+// ============ Batch (std::span) forms ============
+// out[i] = f(a[i], b[i]) or f(x[i]) for every element of out. The inputs
+// hold at least out.size() elements and may alias out; T is deduced from
+// out. Under the check policy they return MATH_OK, or MATH_ERR_OVERFLOW
+// when any element overflowed; out then holds the wrapped results.
+
+template <overflow_policy P>
+using batch_result_t = std::conditional_t<std::is_same_v<P, check>, math_status, void>;
+
+namespace detail {
+
+template <class T>
+using input = std::span<const std::type_identity_t<T>>;
+
+using binary_kernel = void (*)(const int *, const int *, int *, size_t);
+using unary_kernel = void (*)(const int *, int *, size_t);
+
+// Stores a result in out; returns its status, 0 outside the check policy
+template <class R>
+constexpr int store(R &out, R value) {
+    out = value;
+    return 0;
+}
+
+template <class R>
+constexpr int store(R &out, checked<R> value) {
+    out = value.value;
+    return value.status;
+}
+
+// out[i] = f(i) for every element of out. GCC cannot constant-evaluate an
+// omp simd loop, hence the plain one for constant evaluation.
+template <overflow_policy P, class R, class F>
+constexpr batch_result_t<P> fill(std::span<R> out, F f) {
+    int overflow = 0;
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < out.size(); i++) {
+            overflow |= store(out[i], f(i));
+        }
+    } else {
+        MATH_UTILS_SIMD_REDUCTION(|, overflow)
+        for (std::size_t i = 0; i < out.size(); i++) {
+            overflow |= store(out[i], f(i));
+        }
+    }
+    if constexpr (std::is_same_v<P, check>) {
+        return overflow ? MATH_ERR_OVERFLOW : MATH_OK;
+    }
+}
+
+// out[i] = op(a[i], b[i]); for int outside constant evaluation, kernel
+// (a C batch function) does the work instead
+template <overflow_policy P, integer T, class R, class Op>
+constexpr batch_result_t<P> map(std::span<const T> a, std::span<const T> b, std::span<R> out,
+                                Op op, binary_kernel kernel) {
+    if constexpr (std::is_same_v<T, int> && std::is_same_v<R, int> && !std::is_same_v<P, check>) {
+        if (!std::is_constant_evaluated()) {
+            kernel(a.data(), b.data(), out.data(), out.size());
+            return;
+        }
+    }
+    return fill<P>(out, [&](std::size_t i) { return op(a[i], b[i]); });
+}
+
+template <overflow_policy P, integer T, class R, class Op>
+constexpr batch_result_t<P> map(std::span<const T> x, std::span<R> out, Op op,
+                                unary_kernel kernel) {
+    if constexpr (std::is_same_v<T, int> && std::is_same_v<R, int> && !std::is_same_v<P, check>) {
+        if (!std::is_constant_evaluated()) {
+            kernel(x.data(), out.data(), out.size());
+            return;
+        }
+    }
+    return fill<P>(out, [&](std::size_t i) { return op(x[i]); });
+}
+
+} // namespace detail
+
+template <overflow_policy P = wrap, integer T>
+constexpr batch_result_t<P> add(detail::input<T> a, detail::input<T> b, std::span<T> out) {
+    return detail::map<P, T>(a, b, out, [](T x, T y) { return add<P>(x, y); },
+                             std::is_same_v<P, saturate> ? ::saturating_add_n : ::add_n);
+}
+
+template <overflow_policy P = wrap, integer T>
+constexpr batch_result_t<P> subtract(detail::input<T> a, detail::input<T> b, std::span<T> out) {
+    return detail::map<P, T>(a, b, out, [](T x, T y) { return subtract<P>(x, y); },
+                             std::is_same_v<P, saturate> ? ::saturating_subtract_n : ::subtract_n);
+}
+
+template <overflow_policy P = wrap, integer T>
+constexpr batch_result_t<P> multiply(detail::input<T> a, detail::input<T> b, std::span<T> out) {
+    return detail::map<P, T>(a, b, out, [](T x, T y) { return multiply<P>(x, y); },
+                             std::is_same_v<P, saturate> ? ::saturating_multiply_n : ::multiply_n);
+}
+
+template <overflow_policy P = wrap, integer T>
+constexpr batch_result_t<P> abs_value(detail::input<T> x, std::span<T> out) {
+    return detail::map<P, T>(x, out, [](T v) { return abs_value<P>(v); },
+                             std::is_same_v<P, saturate> ? ::saturating_abs_value_n : ::abs_value_n);
+}
+
+template <integer T>
+constexpr void max_value(detail::input<T> a, detail::input<T> b, std::span<T> out) {
+    detail::map<wrap, T>(a, b, out, [](T x, T y) { return max_value(x, y); }, ::max_value_n);
+}
+
+template <integer T>
+constexpr void min_value(detail::input<T> a, detail::input<T> b, std::span<T> out) {
+    detail::map<wrap, T>(a, b, out, [](T x, T y) { return min_value(x, y); }, ::min_value_n);
+}
+
+// The predicates write int, as in C; T is deduced from x
+template <integer T>
+constexpr void is_even(std::span<const T> x, std::span<int> out) {
+    detail::map<wrap, T>(x, out, [](T v) { return is_even(v); }, ::is_even_n);
+}
+
+template <integer T>
+constexpr void is_positive(std::span<const T> x, std::span<int> out) {
+    detail::map<wrap, T>(x, out, [](T v) { return is_positive(v); }, ::is_positive_n);
+}
+
+// ============ Reductions ============
+// As in C: an empty span reduces to the identity, the type's minimum for
+// max_reduce and its maximum for min_reduce. int uses the C reductions.
+
+template <integer T>
+constexpr T max_reduce(std::span<const T> x) {
+    T result = detail::min_of<T>;
+    if (std::is_constant_evaluated()) {
+        for (T v : x) {
+            result = max_value(result, v);
+        }
+    } else if constexpr (std::is_same_v<T, int>) {
+        return ::max_reduce(x.data(), x.size());
+    } else {
+        MATH_UTILS_SIMD_REDUCTION(max, result)
+        for (std::size_t i = 0; i < x.size(); i++) {
+            result = max_value(result, x[i]);
+        }
+    }
+    return result;
+}
+
+template <integer T>
+constexpr T min_reduce(std::span<const T> x) {
+    T result = detail::max_of<T>;
+    if (std::is_constant_evaluated()) {
+        for (T v : x) {
+            result = min_value(result, v);
+        }
+    } else if constexpr (std::is_same_v<T, int>) {
+        return ::min_reduce(x.data(), x.size());
+    } else {
+        MATH_UTILS_SIMD_REDUCTION(min, result)
+        for (std::size_t i = 0; i < x.size(); i++) {
+            result = min_value(result, x[i]);
+        }
+    }
+    return result;
+}
+
+template <integer T>
+constexpr std::size_t count_even(std::span<const T> x) {
+    std::size_t count = 0;
+    if (std::is_constant_evaluated()) {
+        for (T v : x) {
+            count += is_even(v);
+        }
+    } else if constexpr (std::is_same_v<T, int>) {
+        return ::count_even(x.data(), x.size());
+    } else {
+        MATH_UTILS_SIMD_REDUCTION(+, count)
+        for (std::size_t i = 0; i < x.size(); i++) {
+            count += is_even(x[i]);
+        }
+    }
+    return count;
+}
+
+template <integer T>
+constexpr std::size_t count_positive(std::span<const T> x) {
+    std::size_t count = 0;
+    if (std::is_constant_evaluated()) {
+        for (T v : x) {
+            count += is_positive(v);
+        }
+    } else if constexpr (std::is_same_v<T, int>) {
+        return ::count_positive(x.data(), x.size());
+    } else {
+        MATH_UTILS_SIMD_REDUCTION(+, count)
+        for (std::size_t i = 0; i < x.size(); i++) {
+            count += is_positive(x[i]);
+        }
+    }
+    return count;
+}
+
+} // namespace math_utils
+
+#undef MATH_UTILS_SIMD_REDUCTION
+#undef MATH_UTILS_STRINGIFY
+
+#endif // MATH_UTILS_HPP
@@ -0,0 +1,775 @@
+#include <limits.h>
+#include "math_utils.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATH_UTILS_X86 1
+#include <immintrin.h>
+#endif
+
+// Batch (array) versions of the math_utils primitives, and reductions.
+// Kernels for SSE2, AVX2 and AVX-512 are compiled side by side with
+// target attributes and the best one is picked at runtime.
+
+// ============ Scalar reference kernels ============
+// Arithmetic goes through unsigned so overflow wraps exactly like the
+// SIMD lanes do.
+
+static inline int scalar_add(int a, int b) {
+    return (int)((unsigned int)a + (unsigned int)b);
+}
+
+static inline int scalar_subtract(int a, int b) {
+    return (int)((unsigned int)a - (unsigned int)b);
+}
+
+static inline int scalar_multiply(int a, int b) {
+    return (int)((unsigned int)a * (unsigned int)b);
+}
+
+static inline int scalar_max_value(int a, int b) {
+    return a > b ? a : b;
+}
+
+static inline int scalar_min_value(int a, int b) {
+    return a < b ? a : b;
+}
+
+static inline int scalar_abs_value(int x) {
+    return x < 0 ? (int)(0u - (unsigned int)x) : x;
+}
+
+static inline int scalar_is_even(int x) {
+    return (x & 1) == 0;
+}
+
+static inline int scalar_is_positive(int x) {
+    return x > 0;
+}
+
+static inline int scalar_saturating_add(int a, int b) {
+    return saturating_add(a, b);
+}
+
+static inline int scalar_saturating_subtract(int a, int b) {
+    return saturating_subtract(a, b);
+}
+
+static inline int scalar_saturating_multiply(int a, int b) {
+    return saturating_multiply(a, b);
+}
+
+static inline int scalar_saturating_abs_value(int x) {
+    return saturating_abs_value(x);
+}
+
+#define DEFINE_SCALAR_BINARY(name) \
+    static void name##_scalar(const int *a, const int *b, int *out, size_t n) { \
+        for (size_t i = 0; i < n; i++) { \
+            out[i] = scalar_##name(a[i], b[i]); \
+        } \
+    }
+
+#define DEFINE_SCALAR_UNARY(name) \
+    static void name##_scalar(const int *x, int *out, size_t n) { \
+        for (size_t i = 0; i < n; i++) { \
+            out[i] = scalar_##name(x[i]); \
+        } \
+    }
+
+DEFINE_SCALAR_BINARY(add)
+DEFINE_SCALAR_BINARY(subtract)
+DEFINE_SCALAR_BINARY(multiply)
+DEFINE_SCALAR_BINARY(max_value)
+DEFINE_SCALAR_BINARY(min_value)
+DEFINE_SCALAR_UNARY(abs_value)
+DEFINE_SCALAR_UNARY(is_even)
+DEFINE_SCALAR_UNARY(is_positive)
+DEFINE_SCALAR_BINARY(saturating_add)
+DEFINE_SCALAR_BINARY(saturating_subtract)
+DEFINE_SCALAR_BINARY(saturating_multiply)
+DEFINE_SCALAR_UNARY(saturating_abs_value)
+
+// ============ Scalar reductions ============
+// An empty array reduces to the identity: INT_MIN for max, INT_MAX for min
+
+static int max_reduce_scalar(const int *x, size_t n) {
+    int result = INT_MIN;
+    for (size_t i = 0; i < n; i++) {
+        result = scalar_max_value(result, x[i]);
+    }
+    return result;
+}
+
+static int min_reduce_scalar(const int *x, size_t n) {
+    int result = INT_MAX;
+    for (size_t i = 0; i < n; i++) {
+        result = scalar_min_value(result, x[i]);
+    }
+    return result;
+}
+
+static void minmax_reduce_scalar(const int *x, size_t n, int *min, int *max) {
+    int low = INT_MAX, high = INT_MIN;
+    for (size_t i = 0; i < n; i++) {
+        low = scalar_min_value(low, x[i]);
+        high = scalar_max_value(high, x[i]);
+    }
+    *min = low;
+    *max = high;
+}
+
+// Widened to 64 bits per element; the total wraps modulo 2^64
+static int64_t sum_reduce_scalar(const int *x, size_t n) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += (uint64_t)(int64_t)x[i];
+    }
+    return (int64_t)total;
+}
+
+static size_t count_even_scalar(const int *x, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += (size_t)scalar_is_even(x[i]);
+    }
+    return count;
+}
+
+static size_t count_positive_scalar(const int *x, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += (size_t)scalar_is_positive(x[i]);
+    }
+    return count;
+}
+
+#ifdef MATH_UTILS_X86
+
+// Generic vector loops: full vectors first, then a scalar tail
+#define DEFINE_SIMD_BINARY(isa, name, vec, width, load, store) \
+    static __attribute__((target(ISA_TARGET_##isa))) \
+    void name##_##isa(const int *a, const int *b, int *out, size_t n) { \
+        size_t i = 0; \
+        for (; i + (width) <= n; i += (width)) { \
+            vec va = load((const void *)(a + i)); \
+            vec vb = load((const void *)(b + i)); \
+            store((void *)(out + i), isa##_##name(va, vb)); \
+        } \
+        for (; i < n; i++) { \
+            out[i] = scalar_##name(a[i], b[i]); \
+        } \
+    }
+
+#define DEFINE_SIMD_UNARY(isa, name, vec, width, load, store) \
+    static __attribute__((target(ISA_TARGET_##isa))) \
+    void name##_##isa(const int *x, int *out, size_t n) { \
+        size_t i = 0; \
+        for (; i + (width) <= n; i += (width)) { \
+            vec vx = load((const void *)(x + i)); \
+            store((void *)(out + i), isa##_##name(vx)); \
+        } \
+        for (; i < n; i++) { \
+            out[i] = scalar_##name(x[i]); \
+        } \
+    }
+
+// Reductions keep one vector accumulator and fold it to a scalar with
+// shuffles (isa_fold_op) before the scalar tail
+#define DEFINE_SIMD_REDUCE(isa, reduce, op, vec, width, load, identity) \
+    static __attribute__((target(ISA_TARGET_##isa))) \
+    int reduce##_##isa(const int *x, size_t n) { \
+        vec acc = isa##_set1(identity); \
+        size_t i = 0; \
+        for (; i + (width) <= n; i += (width)) { \
+            acc = isa##_##op(acc, load((const void *)(x + i))); \
+        } \
+        int result = isa##_fold_##op(acc); \
+        for (; i < n; i++) { \
+            result = scalar_##op(result, x[i]); \
+        } \
+        return result; \
+    }
+
+#define DEFINE_SIMD_MINMAX(isa, vec, width, load) \
+    static __attribute__((target(ISA_TARGET_##isa))) \
+    void minmax_reduce_##isa(const int *x, size_t n, int *min, int *max) { \
+        vec low = isa##_set1(INT_MAX); \
+        vec high = isa##_set1(INT_MIN); \
+        size_t i = 0; \
+        for (; i + (width) <= n; i += (width)) { \
+            vec vx = load((const void *)(x + i)); \
+            low = isa##_min_value(low, vx); \
+            high = isa##_max_value(high, vx); \
+        } \
+        int low_result = isa##_fold_min_value(low); \
+        int high_result = isa##_fold_max_value(high); \
+        for (; i < n; i++) { \
+            low_result = scalar_min_value(low_result, x[i]); \
+            high_result = scalar_max_value(high_result, x[i]); \
+        } \
+        *min = low_result; \
+        *max = high_result; \
+    }
+
+// Sums sign-extend each vector into 64-bit lanes (isa_add_widened) so the
+// accumulator cannot wrap before the 64-bit total does
+#define DEFINE_SIMD_SUM(isa, vec, width, load) \
+    static __attribute__((target(ISA_TARGET_##isa))) \
+    int64_t sum_reduce_##isa(const int *x, size_t n) { \
+        vec acc = isa##_set1(0); \
+        size_t i = 0; \
+        for (; i + (width) <= n; i += (width)) { \
+            acc = isa##_add_widened(acc, load((const void *)(x + i))); \
+        } \
+        uint64_t total = isa##_fold_add64(acc); \
+        for (; i < n; i++) { \
+            total += (uint64_t)(int64_t)x[i]; \
+        } \
+        return (int64_t)total; \
+    }
+
+// Counts add the 0/1 lanes of a predicate kernel. Lane counters are 32
+// bits, so they are folded every COUNT_BLOCK elements, before the block
+// total (at most COUNT_BLOCK) can wrap.
+#define COUNT_BLOCK ((size_t)1 << 30)
+
+#define DEFINE_SIMD_COUNT(isa, count, op, vec, width, load) \
+    static __attribute__((target(ISA_TARGET_##isa))) \
+    size_t count##_##isa(const int *x, size_t n) { \
+        size_t total = 0, i = 0; \
+        while (i + (width) <= n) { \
+            size_t end = n - i > COUNT_BLOCK ? i + COUNT_BLOCK : n; \
+            vec acc = isa##_set1(0); \
+            for (; i + (width) <= end; i += (width)) { \
+                acc = isa##_add(acc, isa##_##op(load((const void *)(x + i)))); \
+            } \
+            total += (unsigned int)isa##_fold_add(acc); \
+        } \
+        for (; i < n; i++) { \
+            total += (size_t)scalar_##op(x[i]); \
+        } \
+        return total; \
+    }
+
+#define ISA_TARGET_sse2 "sse2"
+#define ISA_TARGET_avx2 "avx2"
+#define ISA_TARGET_avx512 "avx512f"
+
+// ============ SSE2 kernels ============
+
+#define SSE2_INLINE static inline __attribute__((always_inline, target("sse2")))
+#define sse2_load(p) _mm_loadu_si128((const __m128i *)(p))
+#define sse2_store(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+#define sse2_set1(x) _mm_set1_epi32(x)
+
+SSE2_INLINE __m128i sse2_add(__m128i a, __m128i b) {
+    return _mm_add_epi32(a, b);
+}
+
+SSE2_INLINE __m128i sse2_subtract(__m128i a, __m128i b) {
+    return _mm_sub_epi32(a, b);
+}
+
+// SSE2 has no 32-bit low multiply; combine two 32x32->64 products
+SSE2_INLINE __m128i sse2_multiply(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+SSE2_INLINE __m128i sse2_select(__m128i mask, __m128i when_set, __m128i when_clear) {
+    return _mm_or_si128(_mm_and_si128(mask, when_set), _mm_andnot_si128(mask, when_clear));
+}
+
+SSE2_INLINE __m128i sse2_max_value(__m128i a, __m128i b) {
+    return sse2_select(_mm_cmpgt_epi32(a, b), a, b);
+}
+
+SSE2_INLINE __m128i sse2_min_value(__m128i a, __m128i b) {
+    return sse2_select(_mm_cmplt_epi32(a, b), a, b);
+}
+
+SSE2_INLINE __m128i sse2_abs_value(__m128i x) {
+    __m128i sign = _mm_srai_epi32(x, 31);
+    return _mm_sub_epi32(_mm_xor_si128(x, sign), sign);
+}
+
+SSE2_INLINE __m128i sse2_is_even(__m128i x) {
+    return _mm_andnot_si128(x, _mm_set1_epi32(1));
+}
+
+SSE2_INLINE __m128i sse2_is_positive(__m128i x) {
+    return _mm_srli_epi32(_mm_cmpgt_epi32(x, _mm_setzero_si128()), 31);
+}
+
+// Saturation is branchless: compute the wrapped result, derive an
+// all-ones overflow mask from the sign bits and blend in the clamp value
+// (INT_MAX, or INT_MIN when the true result is negative).
+
+SSE2_INLINE __m128i sse2_saturating_add(__m128i a, __m128i b) {
+    __m128i sum = _mm_add_epi32(a, b);
+    __m128i overflow = _mm_srai_epi32(
+        _mm_and_si128(_mm_xor_si128(a, sum), _mm_xor_si128(b, sum)), 31);
+    __m128i clamp = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(INT_MAX));
+    return sse2_select(overflow, clamp, sum);
+}
+
+SSE2_INLINE __m128i sse2_saturating_subtract(__m128i a, __m128i b) {
+    __m128i diff = _mm_sub_epi32(a, b);
+    __m128i overflow = _mm_srai_epi32(
+        _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, diff)), 31);
+    __m128i clamp = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(INT_MAX));
+    return sse2_select(overflow, clamp, diff);
+}
+
+// |INT_MIN| wraps back to INT_MIN; subtracting its sign bit gives INT_MAX
+SSE2_INLINE __m128i sse2_saturating_abs_value(__m128i x) {
+    __m128i abs = sse2_abs_value(x);
+    return _mm_sub_epi32(abs, _mm_srli_epi32(abs, 31));
+}
+
+DEFINE_SIMD_BINARY(sse2, add, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_BINARY(sse2, subtract, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_BINARY(sse2, multiply, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_BINARY(sse2, max_value, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_BINARY(sse2, min_value, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_UNARY(sse2, abs_value, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_UNARY(sse2, is_even, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_UNARY(sse2, is_positive, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_BINARY(sse2, saturating_add, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_BINARY(sse2, saturating_subtract, __m128i, 4, sse2_load, sse2_store)
+DEFINE_SIMD_UNARY(sse2, saturating_abs_value, __m128i, 4, sse2_load, sse2_store)
+
+// Horizontal folds: swap the 64-bit halves, then the 32-bit lanes
+#define DEFINE_SSE2_FOLD(op) \
+    SSE2_INLINE int sse2_fold_##op(__m128i v) { \
+        v = sse2_##op(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2))); \
+        v = sse2_##op(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1))); \
+        return _mm_cvtsi128_si32(v); \
+    }
+
+DEFINE_SSE2_FOLD(add)
+DEFINE_SSE2_FOLD(max_value)
+DEFINE_SSE2_FOLD(min_value)
+
+// The four lanes of v sign-extended, added to the two 64-bit lanes of acc
+SSE2_INLINE __m128i sse2_add_widened(__m128i acc, __m128i v) {
+    __m128i sign = _mm_srai_epi32(v, 31);
+    __m128i pairs = _mm_add_epi64(_mm_unpacklo_epi32(v, sign), _mm_unpackhi_epi32(v, sign));
+    return _mm_add_epi64(acc, pairs);
+}
+
+SSE2_INLINE uint64_t sse2_fold_add64(__m128i v) {
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, v);
+    return lanes[0] + lanes[1];
+}
+
+DEFINE_SIMD_REDUCE(sse2, max_reduce, max_value, __m128i, 4, sse2_load, INT_MIN)
+DEFINE_SIMD_REDUCE(sse2, min_reduce, min_value, __m128i, 4, sse2_load, INT_MAX)
+DEFINE_SIMD_MINMAX(sse2, __m128i, 4, sse2_load)
+DEFINE_SIMD_COUNT(sse2, count_even, is_even, __m128i, 4, sse2_load)
+DEFINE_SIMD_COUNT(sse2, count_positive, is_positive, __m128i, 4, sse2_load)
+DEFINE_SIMD_SUM(sse2, __m128i, 4, sse2_load)
+
+// SSE2 lacks a signed 32x32->64 multiply; use the scalar loop
+static void saturating_multiply_sse2(const int *a, const int *b, int *out, size_t n) {
+    saturating_multiply_scalar(a, b, out, n);
+}
+
+// ============ AVX2 kernels ============
+
+#define AVX2_INLINE static inline __attribute__((always_inline, target("avx2")))
+#define avx2_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#define avx2_store(p, v) _mm256_storeu_si256((__m256i *)(p), (v))
+#define avx2_set1(x) _mm256_set1_epi32(x)
+
+AVX2_INLINE __m256i avx2_add(__m256i a, __m256i b) {
+    return _mm256_add_epi32(a, b);
+}
+
+AVX2_INLINE __m256i avx2_subtract(__m256i a, __m256i b) {
+    return _mm256_sub_epi32(a, b);
+}
+
+AVX2_INLINE __m256i avx2_multiply(__m256i a, __m256i b) {
+    return _mm256_mullo_epi32(a, b);
+}
+
+AVX2_INLINE __m256i avx2_max_value(__m256i a, __m256i b) {
+    return _mm256_max_epi32(a, b);
+}
+
+AVX2_INLINE __m256i avx2_min_value(__m256i a, __m256i b) {
+    return _mm256_min_epi32(a, b);
+}
+
+AVX2_INLINE __m256i avx2_abs_value(__m256i x) {
+    return _mm256_abs_epi32(x);
+}
+
+AVX2_INLINE __m256i avx2_is_even(__m256i x) {
+    return _mm256_andnot_si256(x, _mm256_set1_epi32(1));
+}
+
+AVX2_INLINE __m256i avx2_is_positive(__m256i x) {
+    return _mm256_srli_epi32(_mm256_cmpgt_epi32(x, _mm256_setzero_si256()), 31);
+}
+
+AVX2_INLINE __m256i avx2_saturating_add(__m256i a, __m256i b) {
+    __m256i sum = _mm256_add_epi32(a, b);
+    __m256i overflow = _mm256_srai_epi32(
+        _mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum)), 31);
+    __m256i clamp = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT_MAX));
+    return _mm256_blendv_epi8(sum, clamp, overflow);
+}
+
+AVX2_INLINE __m256i avx2_saturating_subtract(__m256i a, __m256i b) {
+    __m256i diff = _mm256_sub_epi32(a, b);
+    __m256i overflow = _mm256_srai_epi32(
+        _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, diff)), 31);
+    __m256i clamp = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT_MAX));
+    return _mm256_blendv_epi8(diff, clamp, overflow);
+}
+
+// Full 64-bit products of the even and odd lanes; the product fits when
+// its high half is the sign extension of its low half
+AVX2_INLINE __m256i avx2_saturating_multiply(__m256i a, __m256i b) {
+    __m256i even = _mm256_mul_epi32(a, b);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    __m256i lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    __m256i overflow = _mm256_xor_si256(
+        _mm256_cmpeq_epi32(hi, _mm256_srai_epi32(lo, 31)), _mm256_set1_epi32(-1));
+    __m256i clamp = _mm256_xor_si256(_mm256_srai_epi32(_mm256_xor_si256(a, b), 31),
+                                     _mm256_set1_epi32(INT_MAX));
+    return _mm256_blendv_epi8(lo, clamp, overflow);
+}
+
+AVX2_INLINE __m256i avx2_saturating_abs_value(__m256i x) {
+    __m256i abs = _mm256_abs_epi32(x);
+    return _mm256_sub_epi32(abs, _mm256_srli_epi32(abs, 31));
+}
+
+DEFINE_SIMD_BINARY(avx2, add, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_BINARY(avx2, subtract, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_BINARY(avx2, multiply, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_BINARY(avx2, max_value, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_BINARY(avx2, min_value, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_UNARY(avx2, abs_value, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_UNARY(avx2, is_even, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_UNARY(avx2, is_positive, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_BINARY(avx2, saturating_add, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_BINARY(avx2, saturating_subtract, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_BINARY(avx2, saturating_multiply, __m256i, 8, avx2_load, avx2_store)
+DEFINE_SIMD_UNARY(avx2, saturating_abs_value, __m256i, 8, avx2_load, avx2_store)
+
+// Fold the upper 128 bits into the lower ones, then as SSE2
+#define DEFINE_AVX2_FOLD(op, op128) \
+    AVX2_INLINE int avx2_fold_##op(__m256i v) { \
+        return sse2_fold_##op(op128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1))); \
+    }
+
+DEFINE_AVX2_FOLD(add, _mm_add_epi32)
+DEFINE_AVX2_FOLD(max_value, _mm_max_epi32)
+DEFINE_AVX2_FOLD(min_value, _mm_min_epi32)
+
+AVX2_INLINE __m256i avx2_add_widened(__m256i acc, __m256i v) {
+    __m256i low = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v));
+    __m256i high = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1));
+    return _mm256_add_epi64(acc, _mm256_add_epi64(low, high));
+}
+
+AVX2_INLINE uint64_t avx2_fold_add64(__m256i v) {
+    return sse2_fold_add64(_mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+
+DEFINE_SIMD_REDUCE(avx2, max_reduce, max_value, __m256i, 8, avx2_load, INT_MIN)
+DEFINE_SIMD_REDUCE(avx2, min_reduce, min_value, __m256i, 8, avx2_load, INT_MAX)
+DEFINE_SIMD_MINMAX(avx2, __m256i, 8, avx2_load)
+DEFINE_SIMD_COUNT(avx2, count_even, is_even, __m256i, 8, avx2_load)
+DEFINE_SIMD_COUNT(avx2, count_positive, is_positive, __m256i, 8, avx2_load)
+DEFINE_SIMD_SUM(avx2, __m256i, 8, avx2_load)
+
+// ============ AVX-512 kernels ============
+
+#define AVX512_INLINE static inline __attribute__((always_inline, target("avx512f")))
+#define avx512_load(p) _mm512_loadu_si512((const void *)(p))
+#define avx512_store(p, v) _mm512_storeu_si512((void *)(p), (v))
+#define avx512_set1(x) _mm512_set1_epi32(x)
+
+AVX512_INLINE __m512i avx512_add(__m512i a, __m512i b) {
+    return _mm512_add_epi32(a, b);
+}
+
+AVX512_INLINE __m512i avx512_subtract(__m512i a, __m512i b) {
+    return _mm512_sub_epi32(a, b);
+}
+
+AVX512_INLINE __m512i avx512_multiply(__m512i a, __m512i b) {
+    return _mm512_mullo_epi32(a, b);
+}
+
+AVX512_INLINE __m512i avx512_max_value(__m512i a, __m512i b) {
+    return _mm512_max_epi32(a, b);
+}
+
+AVX512_INLINE __m512i avx512_min_value(__m512i a, __m512i b) {
+    return _mm512_min_epi32(a, b);
+}
+
+AVX512_INLINE __m512i avx512_abs_value(__m512i x) {
+    return _mm512_abs_epi32(x);
+}
+
+AVX512_INLINE __m512i avx512_is_even(__m512i x) {
+    return _mm512_andnot_si512(x, _mm512_set1_epi32(1));
+}
+
+AVX512_INLINE __m512i avx512_is_positive(__m512i x) {
+    __mmask16 positive = _mm512_cmpgt_epi32_mask(x, _mm512_setzero_si512());
+    return _mm512_maskz_mov_epi32(positive, _mm512_set1_epi32(1));
+}
+
+AVX512_INLINE __m512i avx512_saturating_add(__m512i a, __m512i b) {
+    __m512i sum = _mm512_add_epi32(a, b);
+    __mmask16 overflow = _mm512_cmplt_epi32_mask(
+        _mm512_and_si512(_mm512_xor_si512(a, sum), _mm512_xor_si512(b, sum)),
+        _mm512_setzero_si512());
+    __m512i clamp = _mm512_xor_si512(_mm512_srai_epi32(a, 31), _mm512_set1_epi32(INT_MAX));
+    return _mm512_mask_blend_epi32(overflow, sum, clamp);
+}
+
+AVX512_INLINE __m512i avx512_saturating_subtract(__m512i a, __m512i b) {
+    __m512i diff = _mm512_sub_epi32(a, b);
+    __mmask16 overflow = _mm512_cmplt_epi32_mask(
+        _mm512_and_si512(_mm512_xor_si512(a, b), _mm512_xor_si512(a, diff)),
+        _mm512_setzero_si512());
+    __m512i clamp = _mm512_xor_si512(_mm512_srai_epi32(a, 31), _mm512_set1_epi32(INT_MAX));
+    return _mm512_mask_blend_epi32(overflow, diff, clamp);
+}
+
+AVX512_INLINE __m512i avx512_saturating_multiply(__m512i a, __m512i b) {
+    __m512i even = _mm512_mul_epi32(a, b);
+    __m512i odd = _mm512_mul_epi32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+    __m512i lo = _mm512_mask_blend_epi32(0xAAAA, even, _mm512_slli_epi64(odd, 32));
+    __m512i hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+    __mmask16 overflow = _mm512_cmpneq_epi32_mask(hi, _mm512_srai_epi32(lo, 31));
+    __m512i clamp = _mm512_xor_si512(_mm512_srai_epi32(_mm512_xor_si512(a, b), 31),
+                                     _mm512_set1_epi32(INT_MAX));
+    return _mm512_mask_blend_epi32(overflow, lo, clamp);
+}
+
+AVX512_INLINE __m512i avx512_saturating_abs_value(__m512i x) {
+    __m512i abs = _mm512_abs_epi32(x);
+    return _mm512_sub_epi32(abs, _mm512_srli_epi32(abs, 31));
+}
+
+DEFINE_SIMD_BINARY(avx512, add, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_BINARY(avx512, subtract, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_BINARY(avx512, multiply, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_BINARY(avx512, max_value, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_BINARY(avx512, min_value, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_UNARY(avx512, abs_value, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_UNARY(avx512, is_even, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_UNARY(avx512, is_positive, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_BINARY(avx512, saturating_add, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_BINARY(avx512, saturating_subtract, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_BINARY(avx512, saturating_multiply, __m512i, 16, avx512_load, avx512_store)
+DEFINE_SIMD_UNARY(avx512, saturating_abs_value, __m512i, 16, avx512_load, avx512_store)
+
+#define avx512_fold_add(v) _mm512_reduce_add_epi32(v)
+#define avx512_fold_max_value(v) _mm512_reduce_max_epi32(v)
+#define avx512_fold_min_value(v) _mm512_reduce_min_epi32(v)
+#define avx512_fold_add64(v) ((uint64_t)_mm512_reduce_add_epi64(v))
+
+AVX512_INLINE __m512i avx512_add_widened(__m512i acc, __m512i v) {
+    __m512i low = _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v));
+    __m512i high = _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1));
+    return _mm512_add_epi64(acc, _mm512_add_epi64(low, high));
+}
+
+DEFINE_SIMD_REDUCE(avx512, max_reduce, max_value, __m512i, 16, avx512_load, INT_MIN)
+DEFINE_SIMD_REDUCE(avx512, min_reduce, min_value, __m512i, 16, avx512_load, INT_MAX)
+DEFINE_SIMD_MINMAX(avx512, __m512i, 16, avx512_load)
+DEFINE_SIMD_COUNT(avx512, count_even, is_even, __m512i, 16, avx512_load)
+DEFINE_SIMD_COUNT(avx512, count_positive, is_positive, __m512i, 16, avx512_load)
+DEFINE_SIMD_SUM(avx512, __m512i, 16, avx512_load)
+
+#endif // MATH_UTILS_X86
+
+// ============ Runtime dispatch ============
+
+typedef void (*binary_kernel)(const int *a, const int *b, int *out, size_t n);
+typedef void (*unary_kernel)(const int *x, int *out, size_t n);
+typedef int (*reduce_kernel)(const int *x, size_t n);
+typedef void (*minmax_kernel)(const int *x, size_t n, int *min, int *max);
+typedef size_t (*count_kernel)(const int *x, size_t n);
+typedef int64_t (*sum_kernel)(const int *x, size_t n);
+
+struct batch_kernels {
+    binary_kernel add;
+    binary_kernel subtract;
+    binary_kernel multiply;
+    binary_kernel max_value;
+    binary_kernel min_value;
+    unary_kernel abs_value;
+    unary_kernel is_even;
+    unary_kernel is_positive;
+    binary_kernel saturating_add;
+    binary_kernel saturating_subtract;
+    binary_kernel saturating_multiply;
+    unary_kernel saturating_abs_value;
+    reduce_kernel max_reduce;
+    reduce_kernel min_reduce;
+    minmax_kernel minmax_reduce;
+    count_kernel count_even;
+    count_kernel count_positive;
+    sum_kernel sum_reduce;
+};
+
+#define KERNEL_TABLE(isa) { \
+    add_##isa, subtract_##isa, multiply_##isa, max_value_##isa, min_value_##isa, \
+    abs_value_##isa, is_even_##isa, is_positive_##isa, \
+    saturating_add_##isa, saturating_subtract_##isa, saturating_multiply_##isa, \
+    saturating_abs_value_##isa, \
+    max_reduce_##isa, min_reduce_##isa, minmax_reduce_##isa, \
+    count_even_##isa, count_positive_##isa, sum_reduce_##isa \
+}
+
+static const struct batch_kernels kernel_tables[] = {
+    KERNEL_TABLE(scalar),
+#ifdef MATH_UTILS_X86
+    KERNEL_TABLE(sse2),
+    KERNEL_TABLE(avx2),
+    KERNEL_TABLE(avx512),
+#endif
+};
+
+// Selected table; NULL until the first batch call or math_simd_force()
+static const struct batch_kernels *active_kernels = NULL;
+
+math_simd_level math_simd_detect(void) {
+#ifdef MATH_UTILS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return MATH_SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return MATH_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return MATH_SIMD_SSE2;
+    }
+#endif
+    return MATH_SIMD_SCALAR;
+}
+
+static const struct batch_kernels *get_kernels(void) {
+    const struct batch_kernels *kernels = __atomic_load_n(&active_kernels, __ATOMIC_ACQUIRE);
+    if (kernels == NULL) {
+        kernels = &kernel_tables[math_simd_detect()];
+        __atomic_store_n(&active_kernels, kernels, __ATOMIC_RELEASE);
+    }
+    return kernels;
+}
+
+math_simd_level math_simd_active(void) {
+    return (math_simd_level)(get_kernels() - kernel_tables);
+}
+
+int math_simd_force(math_simd_level level) {
+    if (level < MATH_SIMD_SCALAR || level > math_simd_detect()) {
+        return -1;  // Error case
+    }
+    __atomic_store_n(&active_kernels, &kernel_tables[level], __ATOMIC_RELEASE);
+    return 0;
+}
+
+// ============ Public batch API ============
+
+void add_n(const int *a, const int *b, int *out, size_t n) {
+    get_kernels()->add(a, b, out, n);
+}
+
+void subtract_n(const int *a, const int *b, int *out, size_t n) {
+    get_kernels()->subtract(a, b, out, n);
+}
+
+void multiply_n(const int *a, const int *b, int *out, size_t n) {
+    get_kernels()->multiply(a, b, out, n);
+}
+
+void max_value_n(const int *a, const int *b, int *out, size_t n) {
+    get_kernels()->max_value(a, b, out, n);
+}
+
+void min_value_n(const int *a, const int *b, int *out, size_t n) {
+    get_kernels()->min_value(a, b, out, n);
+}
+
+void abs_value_n(const int *x, int *out, size_t n) {
+    get_kernels()->abs_value(x, out, n);
+}
+
+void is_even_n(const int *x, int *out, size_t n) {
+    get_kernels()->is_even(x, out, n);
+}
+
+void is_positive_n(const int *x, int *out, size_t n) {
+    get_kernels()->is_positive(x, out, n);
+}
+
+void saturating_add_n(const int *a, const int *b, int *out, size_t n) {
+    get_kernels()->saturating_add(a, b, out, n);
+}
+
+void saturating_subtract_n(const int *a, const int *b, int *out, size_t n) {
+    get_kernels()->saturating_subtract(a, b, out, n);
+}
+
+void saturating_multiply_n(const int *a, const int *b, int *out, size_t n) {
+    get_kernels()->saturating_multiply(a, b, out, n);
+}
+
+void saturating_abs_value_n(const int *x, int *out, size_t n) {
+    get_kernels()->saturating_abs_value(x, out, n);
+}
+
+int max_reduce(const int *x, size_t n) {
+    return get_kernels()->max_reduce(x, n);
+}
+
+int min_reduce(const int *x, size_t n) {
+    return get_kernels()->min_reduce(x, n);
+}
+
+void minmax_reduce(const int *x, size_t n, int *min, int *max) {
+    get_kernels()->minmax_reduce(x, n, min, max);
+}
+
+size_t count_even(const int *x, size_t n) {
+    return get_kernels()->count_even(x, n);
+}
+
+size_t count_positive(const int *x, size_t n) {
+    return get_kernels()->count_positive(x, n);
+}
+
+int64_t sum_reduce(const int *x, size_t n) {
+    return get_kernels()->sum_reduce(x, n);
+}
+
+// factorial and fibonacci are loop-carried; call the scalar versions
+void factorial_n(const int *x, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = factorial(x[i]);
+    }
+}
+
+void fibonacci_n(const int *x, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = fibonacci(x[i]);
+    }
+}
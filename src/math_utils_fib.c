@@ -0,0 +1,408 @@
+#include <stdlib.h>
+#include <string.h>
+#include "math_utils.h"
+
+// Wide and arbitrary-precision fibonacci. The 64-bit results come from a
+// memoized sequence; the 128-bit and big ones use fast doubling.
+//
+// With (a, b) = (F(k), F(k+1)):
+//   F(2k)   = a * (2b - a)
+//   F(2k+1) = a^2 + b^2
+// Walking the bits of n from the top gives F(n) in O(log n) steps.
+
+// ============ Fixed-width variants ============
+
+// Largest n with F(n) representable in each type
+#define FIB_MAX_I64 92
+#define FIB_MAX_U64 93
+#define FIB_MAX_U128 186
+
+// ============ Memoized 64-bit sequence ============
+// F(0) .. F(FIB_MAX_U64), filled in order as larger n are asked for.
+// Entries below fib_memo_count are final. A thread that needs more extends
+// the prefix itself, one addition per entry, then moves the count forward
+// with a release CAS; racing extenders store identical values, so no lock
+// is needed and readers pay one acquire load plus one load.
+
+static uint64_t fib_memo[FIB_MAX_U64 + 1];
+static size_t fib_memo_count = 0;
+
+// F(n) for n <= FIB_MAX_U64
+static uint64_t fib_memo_get(uint64_t n) {
+    size_t count = __atomic_load_n(&fib_memo_count, __ATOMIC_ACQUIRE);
+    if (n < count) {
+        return __atomic_load_n(&fib_memo[n], __ATOMIC_RELAXED);
+    }
+
+    for (size_t i = count; i <= n; i++) {
+        uint64_t value = i < 2 ? i
+                       : __atomic_load_n(&fib_memo[i - 1], __ATOMIC_RELAXED) +
+                         __atomic_load_n(&fib_memo[i - 2], __ATOMIC_RELAXED);
+        __atomic_store_n(&fib_memo[i], value, __ATOMIC_RELAXED);
+    }
+    while (count <= n && !__atomic_compare_exchange_n(&fib_memo_count, &count, (size_t)n + 1, 1,
+                                                      __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+        // Another thread moved the count; stop once it covers n
+    }
+    return __atomic_load_n(&fib_memo[n], __ATOMIC_RELAXED);
+}
+
+int fibonacci_i64(int64_t n, int64_t *out) {
+    if (n < 0) {
+        return MATH_ERR_DOMAIN;
+    }
+    if (n > FIB_MAX_I64) {
+        return MATH_ERR_OVERFLOW;
+    }
+    *out = (int64_t)fib_memo_get((uint64_t)n);
+    return MATH_OK;
+}
+
+int fibonacci_u64(uint64_t n, uint64_t *out) {
+    if (n > FIB_MAX_U64) {
+        return MATH_ERR_OVERFLOW;
+    }
+    *out = fib_memo_get(n);
+    return MATH_OK;
+}
+
+int fibonacci_range_u64(uint64_t first, size_t count, uint64_t *out) {
+    if (count == 0) {
+        return MATH_OK;
+    }
+    if (first > FIB_MAX_U64 || count - 1 > FIB_MAX_U64 - first) {
+        return MATH_ERR_OVERFLOW;
+    }
+    fib_memo_get(first + count - 1);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = __atomic_load_n(&fib_memo[first + i], __ATOMIC_RELAXED);
+    }
+    return MATH_OK;
+}
+
+#ifdef __SIZEOF_INT128__
+int fibonacci_u128(uint64_t n, unsigned __int128 *out) {
+    if (n > FIB_MAX_U128) {
+        return MATH_ERR_OVERFLOW;
+    }
+    unsigned __int128 a = 0, b = 1;
+    for (int bit = 7; bit >= 0; bit--) {
+        unsigned __int128 c = a * (2 * b - a);
+        unsigned __int128 d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    *out = a;
+    return MATH_OK;
+}
+#endif
+
+// ============ Limb arithmetic ============
+// Little-endian arrays of 64-bit limbs. Lengths may include leading
+// zero limbs unless noted.
+
+// Below this many limbs schoolbook multiplication beats Karatsuba
+#define KARATSUBA_THRESHOLD 32
+
+// Full 64x64 -> 128-bit product, returned as (hi, lo)
+static inline uint64_t mul_wide(uint64_t a, uint64_t b, uint64_t *hi) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *hi = (uint64_t)(p >> 64);
+    return (uint64_t)p;
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+    *hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+#endif
+}
+
+static size_t limbs_trim(const uint64_t *x, size_t n) {
+    while (n > 0 && x[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
+// r[0..rn) += a[0..an), rn >= an; returns the carry out of r
+static uint64_t limbs_add_into(uint64_t *r, size_t rn, const uint64_t *a, size_t an) {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < an; i++) {
+        uint64_t s = r[i] + carry;
+        carry = s < carry;
+        r[i] = s + a[i];
+        carry += r[i] < s;
+    }
+    for (; carry && i < rn; i++) {
+        r[i]++;
+        carry = r[i] == 0;
+    }
+    return carry;
+}
+
+// r[0..rn) -= a[0..an), rn >= an; requires r >= a
+static void limbs_sub_from(uint64_t *r, size_t rn, const uint64_t *a, size_t an) {
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i < an; i++) {
+        uint64_t d = r[i] - a[i];
+        uint64_t b1 = r[i] < a[i];
+        r[i] = d - borrow;
+        borrow = b1 | (d < borrow);
+    }
+    for (; borrow && i < rn; i++) {
+        borrow = r[i] == 0;
+        r[i]--;
+    }
+}
+
+// r[0..an+bn) = a * b, schoolbook
+static void limbs_mul_basecase(uint64_t *r, const uint64_t *a, size_t an,
+                               const uint64_t *b, size_t bn) {
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (size_t i = 0; i < an; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bn; j++) {
+            uint64_t hi;
+            uint64_t lo = mul_wide(a[i], b[j], &hi);
+            lo += carry;
+            hi += lo < carry;
+            lo += r[i + j];
+            hi += lo < r[i + j];
+            r[i + j] = lo;
+            carry = hi;
+        }
+        r[i + bn] = carry;
+    }
+}
+
+// r[0..an+bn) = a * b; r must not overlap a or b
+static int limbs_mul(uint64_t *r, const uint64_t *a, size_t an,
+                     const uint64_t *b, size_t bn) {
+    if (an < bn) {
+        const uint64_t *t = a;
+        a = b;
+        b = t;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn < KARATSUBA_THRESHOLD) {
+        limbs_mul_basecase(r, a, an, b, bn);
+        return MATH_OK;
+    }
+
+    size_t m = an / 2;
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+
+    if (bn <= m) {
+        // Unbalanced: r = a0 * b + (a1 * b) << m
+        uint64_t *t = malloc((an - m + bn) * sizeof(uint64_t));
+        if (t == NULL) {
+            return MATH_ERR_NOMEM;
+        }
+        int status = limbs_mul(r, a, m, b, bn);
+        if (status == MATH_OK) {
+            status = limbs_mul(t, a + m, an - m, b, bn);
+        }
+        if (status == MATH_OK) {
+            limbs_add_into(r + m, an + bn - m, t, an - m + bn);
+        }
+        free(t);
+        return status;
+    }
+
+    // Karatsuba: z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    size_t a1n = an - m, b1n = bn - m;
+    size_t sn = a1n + 1;
+    uint64_t *buf = malloc((2 * sn + 2 * sn) * sizeof(uint64_t));
+    if (buf == NULL) {
+        return MATH_ERR_NOMEM;
+    }
+    uint64_t *sa = buf;
+    uint64_t *sb = buf + sn;
+    uint64_t *z1 = buf + 2 * sn;
+
+    memset(sa, 0, 2 * sn * sizeof(uint64_t));
+    memcpy(sa, a + m, a1n * sizeof(uint64_t));
+    limbs_add_into(sa, sn, a, m);
+    memcpy(sb, b + m, b1n * sizeof(uint64_t));
+    limbs_add_into(sb, sn, b, m);
+
+    size_t san = limbs_trim(sa, sn), sbn = limbs_trim(sb, sn);
+    memset(z1, 0, 2 * sn * sizeof(uint64_t));
+
+    // z0 lands in r[0..2m), z2 in r[2m..an+bn)
+    int status = limbs_mul(r, a, m, b, m);
+    if (status == MATH_OK) {
+        status = limbs_mul(r + 2 * m, a + m, a1n, b + m, b1n);
+    }
+    if (status == MATH_OK && san > 0 && sbn > 0) {
+        status = limbs_mul(z1, sa, san, sb, sbn);
+    }
+    if (status == MATH_OK) {
+        limbs_sub_from(z1, 2 * sn, r, 2 * m);
+        limbs_sub_from(z1, 2 * sn, r + 2 * m, a1n + b1n);
+        size_t z1n = limbs_trim(z1, 2 * sn);
+        limbs_add_into(r + m, an + bn - m, z1, z1n);
+    }
+    free(buf);
+    return status;
+}
+
+// ============ Arbitrary-precision variant ============
+
+void math_bigint_free(math_bigint *x) {
+    free(x->limbs);
+    x->limbs = NULL;
+    x->len = 0;
+}
+
+char *math_bigint_to_decimal(const math_bigint *x) {
+    // Each 64-bit limb contributes at most 20 decimal digits
+    size_t max_digits = x->len * 20 + 1;
+    char *digits = malloc(max_digits + 1);
+    uint64_t *work = malloc((x->len + 1) * sizeof(uint64_t));
+    if (digits == NULL || work == NULL) {
+        free(digits);
+        free(work);
+        return NULL;
+    }
+
+    size_t n = x->len;
+    if (n > 0) {
+        memcpy(work, x->limbs, n * sizeof(uint64_t));
+    }
+    size_t pos = max_digits;
+    digits[pos] = '\0';
+
+    // Peel off 9 digits at a time by dividing by 10^9 in 32-bit halves
+    const uint64_t chunk = 1000000000u;
+    while (n > 0) {
+        uint64_t rem = 0;
+        for (size_t i = n; i-- > 0;) {
+            uint64_t hi = (rem << 32) | (work[i] >> 32);
+            uint64_t q_hi = hi / chunk;
+            rem = hi % chunk;
+            uint64_t lo = (rem << 32) | (work[i] & 0xFFFFFFFFu);
+            uint64_t q_lo = lo / chunk;
+            rem = lo % chunk;
+            work[i] = (q_hi << 32) | q_lo;
+        }
+        n = limbs_trim(work, n);
+        for (int d = 0; d < 9 && (n > 0 || rem > 0); d++) {
+            digits[--pos] = (char)('0' + rem % 10);
+            rem /= 10;
+        }
+    }
+    if (pos == max_digits) {
+        digits[--pos] = '0';
+    }
+    free(work);
+
+    memmove(digits, digits + pos, max_digits - pos + 1);
+    return digits;
+}
+
+int fibonacci_big(uint64_t n, math_bigint *out) {
+    out->limbs = NULL;
+    out->len = 0;
+
+    // F(n+1) < phi^(n+1) and log2(phi) < 0.6943, plus slack for 2b - a
+    size_t cap = (size_t)(n / 64 * 0.6943) + (size_t)((n % 64) * 0.6943 / 64) + 3;
+    if (cap > SIZE_MAX / (8 * sizeof(uint64_t))) {
+        return MATH_ERR_NOMEM;
+    }
+
+    // a = F(k), b = F(k+1), t = 2b - a, d = F(2k+1); c and sq hold products
+    uint64_t *buf = calloc(8 * cap, sizeof(uint64_t));
+    if (buf == NULL) {
+        return MATH_ERR_NOMEM;
+    }
+    uint64_t *a = buf, *b = buf + cap, *t = buf + 2 * cap, *d = buf + 3 * cap;
+    uint64_t *c = buf + 4 * cap, *sq = buf + 6 * cap;
+    size_t an = 0, bn = 1;
+    b[0] = 1;
+
+    int top = 63;
+    while (top >= 0 && ((n >> top) & 1) == 0) {
+        top--;
+    }
+
+    int status = MATH_OK;
+    for (int bit = top; bit >= 0; bit--) {
+        // t = 2b - a
+        size_t tn = bn + 1;
+        memcpy(t, b, bn * sizeof(uint64_t));
+        t[bn] = 0;
+        limbs_add_into(t, tn, b, bn);
+        limbs_sub_from(t, tn, a, an);
+        tn = limbs_trim(t, tn);
+
+        // c = F(2k) = a * t
+        size_t cn = 0;
+        if (an > 0) {
+            status = limbs_mul(c, a, an, t, tn);
+            if (status != MATH_OK) {
+                break;
+            }
+            cn = limbs_trim(c, an + tn);
+        }
+
+        // d = F(2k+1) = b^2 + a^2
+        status = limbs_mul(sq, b, bn, b, bn);
+        if (status != MATH_OK) {
+            break;
+        }
+        size_t dn = limbs_trim(sq, 2 * bn);
+        memcpy(d, sq, dn * sizeof(uint64_t));
+        memset(d + dn, 0, (cap - dn) * sizeof(uint64_t));
+        if (an > 0) {
+            status = limbs_mul(sq, a, an, a, an);
+            if (status != MATH_OK) {
+                break;
+            }
+            limbs_add_into(d, cap, sq, limbs_trim(sq, 2 * an));
+            dn = limbs_trim(d, cap);
+        }
+
+        if ((n >> bit) & 1) {
+            // (a, b) = (F(2k+1), F(2k) + F(2k+1))
+            memcpy(b, d, cap * sizeof(uint64_t));
+            limbs_add_into(b, cap, c, cn);
+            bn = limbs_trim(b, cap);
+            memcpy(a, d, cap * sizeof(uint64_t));
+            an = dn;
+        } else {
+            // (a, b) = (F(2k), F(2k+1))
+            memset(a, 0, cap * sizeof(uint64_t));
+            memcpy(a, c, cn * sizeof(uint64_t));
+            an = cn;
+            memcpy(b, d, cap * sizeof(uint64_t));
+            bn = dn;
+        }
+    }
+
+    if (status != MATH_OK) {
+        free(buf);
+        return status;
+    }
+
+    // a already sits at the front of buf; shrink to fit
+    uint64_t *limbs = realloc(buf, (an > 0 ? an : 1) * sizeof(uint64_t));
+    out->limbs = limbs != NULL ? limbs : buf;
+    out->len = an;
+    return MATH_OK;
+}
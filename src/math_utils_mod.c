@@ -0,0 +1,396 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include "math_utils.h"
+
+// factorial and fibonacci modulo a 64-bit m.
+//
+// Products are reduced with Montgomery multiplication when m is odd (every
+// prime but 2): values are kept as x * 2^64 mod m, and a product needs two
+// 64x64 multiplies and a subtraction instead of a 128-by-64 division. Even
+// moduli fall back to the plain 128-bit remainder.
+//
+// factorial_mod keeps a prefix table of checkpoints (i * 1024)! mod m for
+// the most recent modulus, extended on demand, so a query sweeps at most
+// 1023 factors past the nearest checkpoint once the table reaches it.
+
+// n! for n <= 20, every factorial that fits in a uint64_t: the start of
+// every factorial sweep
+#define FACTORIAL_TABLE_U64_MAX 20
+
+static const uint64_t factorial_table_u64[FACTORIAL_TABLE_U64_MAX + 1] = {
+    1ULL, 1ULL, 2ULL, 6ULL, 24ULL, 120ULL, 720ULL, 5040ULL, 40320ULL, 362880ULL,
+    3628800ULL, 39916800ULL, 479001600ULL, 6227020800ULL, 87178291200ULL,
+    1307674368000ULL, 20922789888000ULL, 355687428096000ULL, 6402373705728000ULL,
+    121645100408832000ULL, 2432902008176640000ULL
+};
+
+// Factors between factorial checkpoints, and the most checkpoints kept
+// (4 MiB, reaching n < 2^29); larger n sweep on from the last one
+#define FACTORIAL_CHECKPOINT_STRIDE 1024
+#define FACTORIAL_CHECKPOINTS_MAX ((size_t)1 << 19)
+
+// prefix[i] = (i * FACTORIAL_CHECKPOINT_STRIDE)! in the working form of m,
+// for i < count. A call with another modulus starts the table over.
+static struct {
+    pthread_mutex_t lock;
+    uint64_t m;  // 0 = no table yet
+    uint64_t *prefix;
+    size_t count;
+    size_t capacity;
+} checkpoints = {PTHREAD_MUTEX_INITIALIZER, 0, NULL, 0, 0};
+
+// ============ Arithmetic modulo m ============
+
+// Full 64x64 -> 128-bit product, returned as (hi, lo)
+static inline uint64_t mul_wide(uint64_t a, uint64_t b, uint64_t *hi) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *hi = (uint64_t)(p >> 64);
+    return (uint64_t)p;
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+    *hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+#endif
+}
+
+// (hi * 2^64 + lo) mod m, for hi < m
+static uint64_t mod_wide(uint64_t hi, uint64_t lo, uint64_t m) {
+#ifdef __SIZEOF_INT128__
+    return (uint64_t)((((unsigned __int128)hi << 64) | lo) % m);
+#else
+    // Shift-subtract, one bit of lo at a time; hi stays below m
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t top = hi >> 63;
+        hi = (hi << 1) | ((lo >> bit) & 1);
+        if (top || hi >= m) {
+            hi -= m;
+        }
+    }
+    return hi;
+#endif
+}
+
+// Residues modulo m in the working form: Montgomery form for odd m, plain
+// residues otherwise
+typedef struct {
+    uint64_t m;
+    uint64_t inv;   // m^-1 mod 2^64 when m is odd, else 0
+    uint64_t r2;    // 2^128 mod m, to enter Montgomery form
+    uint64_t one;   // 1 in the working form
+} mod_ring;
+
+static void ring_init(mod_ring *r, uint64_t m) {
+    r->m = m;
+    r->inv = 0;
+    r->r2 = 0;
+    r->one = 1 % m;
+    if (m & 1) {
+        // Newton's iteration doubles the correct low bits: 3, 6, ..., 96
+        uint64_t inv = m;
+        for (int i = 0; i < 5; i++) {
+            inv *= 2 - m * inv;
+        }
+        r->inv = inv;
+        r->one = (0 - m) % m;                  // 2^64 mod m
+        r->r2 = mod_wide(r->one, 0, m);        // 2^128 mod m
+    }
+}
+
+// (hi * 2^64 + lo) / 2^64 mod m, for hi < m. With u = lo * m^-1, u * m
+// has the same low word as the input, so the high words can be subtracted.
+static inline uint64_t montgomery_reduce(const mod_ring *r, uint64_t hi, uint64_t lo) {
+    uint64_t u_hi;
+    mul_wide(lo * r->inv, r->m, &u_hi);
+    return hi >= u_hi ? hi - u_hi : hi - u_hi + r->m;
+}
+
+static inline uint64_t ring_mul(const mod_ring *r, uint64_t a, uint64_t b) {
+    uint64_t hi;
+    uint64_t lo = mul_wide(a, b, &hi);
+    return r->inv != 0 ? montgomery_reduce(r, hi, lo) : mod_wide(hi, lo, r->m);
+}
+
+static inline uint64_t ring_add(const mod_ring *r, uint64_t a, uint64_t b) {
+    return a >= r->m - b ? a - (r->m - b) : a + b;
+}
+
+static inline uint64_t ring_sub(const mod_ring *r, uint64_t a, uint64_t b) {
+    return a >= b ? a - b : a + (r->m - b);
+}
+
+// Plain value -> working form, and back
+static inline uint64_t ring_enter(const mod_ring *r, uint64_t x) {
+    x %= r->m;
+    return r->inv != 0 ? ring_mul(r, x, r->r2) : x;
+}
+
+static inline uint64_t ring_leave(const mod_ring *r, uint64_t x) {
+    return r->inv != 0 ? montgomery_reduce(r, 0, x) : x;
+}
+
+static uint64_t ring_pow(const mod_ring *r, uint64_t base, uint64_t e) {
+    uint64_t result = r->one;
+    while (e > 0) {
+        if (e & 1) {
+            result = ring_mul(r, result, base);
+        }
+        base = ring_mul(r, base, base);
+        e >>= 1;
+    }
+    return result;
+}
+
+// Deterministic Miller-Rabin: these bases decide every m < 2^64
+static int ring_is_prime(const mod_ring *r) {
+    static const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    uint64_t m = r->m;
+
+    if (m < 2 || (m & 1) == 0) {
+        return m == 2;
+    }
+    uint64_t d = m - 1;
+    int s = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        s++;
+    }
+    uint64_t minus_one = ring_sub(r, 0, r->one);
+    for (size_t i = 0; i < sizeof(bases) / sizeof(bases[0]); i++) {
+        if (bases[i] % m == 0) {
+            return 1;  // m is one of the bases
+        }
+        uint64_t x = ring_pow(r, ring_enter(r, bases[i]), d);
+        if (x == r->one || x == minus_one) {
+            continue;
+        }
+        int witness = 1;
+        for (int k = 1; k < s && witness; k++) {
+            x = ring_mul(r, x, x);
+            witness = x != minus_one;
+        }
+        if (witness) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// ============ factorial mod m ============
+
+// k! in working form by a sweep from the u64 table, k < m. Stops early
+// once the product is 0 (composite m).
+static uint64_t factorial_sweep(const mod_ring *r, uint64_t from, uint64_t product,
+                                uint64_t to) {
+    uint64_t factor = ring_enter(r, from + 1);
+    for (uint64_t k = from + 1; k <= to && product != 0; k++) {
+        product = ring_mul(r, product, factor);
+        factor = ring_add(r, factor, r->one);
+    }
+    return product;
+}
+
+// Where a sweep to k! starts: the largest table entry up to k
+static uint64_t table_start(uint64_t k) {
+    return k < FACTORIAL_TABLE_U64_MAX ? k : FACTORIAL_TABLE_U64_MAX;
+}
+
+// Makes room for checkpoint want; on allocation failure the table just
+// stops growing
+static void checkpoints_reserve(size_t want) {
+    if (want < checkpoints.capacity) {
+        return;
+    }
+    size_t capacity = checkpoints.capacity * 2 > want ? checkpoints.capacity * 2 : want + 1;
+    capacity = capacity < FACTORIAL_CHECKPOINTS_MAX ? capacity : FACTORIAL_CHECKPOINTS_MAX;
+    uint64_t *prefix = realloc(checkpoints.prefix, capacity * sizeof(*prefix));
+    if (prefix != NULL) {
+        checkpoints.prefix = prefix;
+        checkpoints.capacity = capacity;
+    }
+}
+
+// Where a sweep to k! starts, k < m: the largest checkpoint or u64 table
+// entry up to k, with its factorial in *product. Extends the checkpoints
+// for m up to k first, which costs one sweep the first time.
+static uint64_t sweep_start(const mod_ring *r, uint64_t k, uint64_t *product) {
+    uint64_t start = table_start(k);
+    size_t want = k / FACTORIAL_CHECKPOINT_STRIDE < FACTORIAL_CHECKPOINTS_MAX
+                      ? (size_t)(k / FACTORIAL_CHECKPOINT_STRIDE)
+                      : FACTORIAL_CHECKPOINTS_MAX - 1;
+
+    *product = ring_enter(r, factorial_table_u64[start]);
+    if (want == 0) {
+        return start;
+    }
+    pthread_mutex_lock(&checkpoints.lock);
+    if (checkpoints.m != r->m) {
+        checkpoints.m = r->m;
+        checkpoints.count = 0;
+    }
+    checkpoints_reserve(want);
+    if (checkpoints.count == 0 && checkpoints.capacity > 0) {
+        checkpoints.prefix[0] = r->one;
+        checkpoints.count = 1;
+    }
+    while (checkpoints.count <= want && checkpoints.count < checkpoints.capacity) {
+        size_t i = checkpoints.count;
+        checkpoints.prefix[i] = factorial_sweep(r, (i - 1) * (uint64_t)FACTORIAL_CHECKPOINT_STRIDE,
+                                                checkpoints.prefix[i - 1],
+                                                i * (uint64_t)FACTORIAL_CHECKPOINT_STRIDE);
+        checkpoints.count++;
+    }
+    if (checkpoints.count > 1) {
+        size_t i = checkpoints.count - 1 < want ? checkpoints.count - 1 : want;
+        start = i * (uint64_t)FACTORIAL_CHECKPOINT_STRIDE;
+        *product = checkpoints.prefix[i];
+    }
+    pthread_mutex_unlock(&checkpoints.lock);
+    return start;
+}
+
+// Wilson's theorem, (p-1)! = -1 mod p, gives n! = (-1)^(p-n) / (p-1-n)!
+// for prime p: a shorter sweep once n is past p/2. Takes (p-1-n)!.
+static uint64_t wilson_finish(const mod_ring *r, uint64_t n, uint64_t reflected) {
+    uint64_t result = ring_pow(r, reflected, r->m - 2);  // Inverse by Fermat
+    return ((r->m - n) & 1) ? ring_sub(r, 0, result) : result;
+}
+
+int factorial_mod(uint64_t n, uint64_t m, uint64_t *out) {
+    mod_ring r;
+
+    if (m == 0) {
+        return MATH_ERR_DOMAIN;
+    }
+    if (n >= m) {
+        *out = 0;  // m is one of the factors
+        return MATH_OK;
+    }
+    if (n <= FACTORIAL_TABLE_U64_MAX) {
+        *out = factorial_table_u64[n] % m;
+        return MATH_OK;
+    }
+    ring_init(&r, m);
+    int wilson = m - 1 - n < n && ring_is_prime(&r);
+    uint64_t k = wilson ? m - 1 - n : n;
+    uint64_t product;
+    uint64_t start = sweep_start(&r, k, &product);
+    product = factorial_sweep(&r, start, product, k);
+    *out = ring_leave(&r, wilson ? wilson_finish(&r, n, product) : product);
+    return MATH_OK;
+}
+
+// A query of factorial_mod_n: the factorial to sweep to, and where it goes
+typedef struct {
+    uint64_t k;
+    size_t index;
+} factorial_query;
+
+static int compare_queries(const void *a, const void *b) {
+    uint64_t ka = ((const factorial_query *)a)->k, kb = ((const factorial_query *)b)->k;
+    return (ka > kb) - (ka < kb);
+}
+
+int factorial_mod_n(const uint64_t *x, uint64_t m, uint64_t *out, size_t n) {
+    mod_ring r;
+
+    if (m == 0) {
+        return MATH_ERR_DOMAIN;
+    }
+    factorial_query *queries = malloc((n > 0 ? n : 1) * sizeof(*queries));
+    if (queries == NULL) {
+        return MATH_ERR_NOMEM;
+    }
+    ring_init(&r, m);
+
+    // Answer the trivial queries; the rest become one sorted sweep
+    int prime = -1;  // Decided on the first query that could use it
+    size_t pending = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (x[i] >= m) {
+            out[i] = 0;
+        } else if (x[i] <= FACTORIAL_TABLE_U64_MAX) {
+            out[i] = factorial_table_u64[x[i]] % m;
+        } else {
+            int wilson = m - 1 - x[i] < x[i];
+            if (wilson && prime < 0) {
+                prime = ring_is_prime(&r);
+            }
+            queries[pending].k = wilson && prime ? m - 1 - x[i] : x[i];
+            queries[pending].index = i;
+            pending++;
+        }
+    }
+    qsort(queries, pending, sizeof(*queries), compare_queries);
+
+    uint64_t k = 0, product = r.one;
+    for (size_t q = 0; q < pending; q++) {
+        size_t i = queries[q].index;
+        if (k <= FACTORIAL_TABLE_U64_MAX || queries[q].k - k >= FACTORIAL_CHECKPOINT_STRIDE) {
+            uint64_t start_product;
+            uint64_t start = sweep_start(&r, queries[q].k, &start_product);
+            if (start > k) {
+                k = start;
+                product = start_product;
+            }
+        }
+        product = factorial_sweep(&r, k, product, queries[q].k);
+        k = queries[q].k;
+        out[i] = ring_leave(&r, queries[q].k != x[i] ? wilson_finish(&r, x[i], product) : product);
+    }
+    free(queries);
+    return MATH_OK;
+}
+
+// ============ fibonacci mod m ============
+
+// Fast doubling (see math_utils_fib.c) in working form, O(log n)
+static uint64_t fibonacci_doubling(const mod_ring *r, uint64_t n) {
+    uint64_t a = 0, b = r->one;
+    int top = 63;
+    while (top >= 0 && ((n >> top) & 1) == 0) {
+        top--;
+    }
+    for (int bit = top; bit >= 0; bit--) {
+        uint64_t c = ring_mul(r, a, ring_sub(r, ring_add(r, b, b), a));
+        uint64_t d = ring_add(r, ring_mul(r, a, a), ring_mul(r, b, b));
+        if ((n >> bit) & 1) {
+            a = d;
+            b = ring_add(r, c, d);
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return ring_leave(r, a);
+}
+
+int fibonacci_mod(uint64_t n, uint64_t m, uint64_t *out) {
+    mod_ring r;
+
+    if (m == 0) {
+        return MATH_ERR_DOMAIN;
+    }
+    ring_init(&r, m);
+    *out = fibonacci_doubling(&r, n);
+    return MATH_OK;
+}
+
+int fibonacci_mod_n(const uint64_t *x, uint64_t m, uint64_t *out, size_t n) {
+    mod_ring r;
+
+    if (m == 0) {
+        return MATH_ERR_DOMAIN;
+    }
+    ring_init(&r, m);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = fibonacci_doubling(&r, x[i]);
+    }
+    return MATH_OK;
+}
@@ -0,0 +1,447 @@
+#ifdef __linux__
+#define _GNU_SOURCE  // sched_getaffinity, pthread_setaffinity_np
+#include <sched.h>
+#endif
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "math_utils.h"
+
+// Parallel batch API: the batch functions over chunks of an array, run by a
+// persistent pool of worker threads.
+//
+// An array of n elements is cut into chunks of about half an L2 cache (two
+// inputs and an output together). Worker i starts out owning the chunk
+// range [chunks * i / T, chunks * (i + 1) / T) of a T-worker job; once it
+// runs dry it steals the upper half of the fullest other range, as the
+// exhaustive property engine does. The calling thread is worker 0; the
+// others sleep on a condition variable between jobs and are pinned to one
+// CPU each. math_parallel_alloc zeroes each starting range from its own
+// worker without stealing, so the pages of a pinned worker's range stay on
+// that worker's NUMA node.
+
+// Elements per chunk are a multiple of this: one AVX-512 vector, so only
+// the last chunk of an array has a scalar tail
+#define CHUNK_ALIGN 16
+
+// Default chunks are whole pages, so no page is shared between workers
+#define PAGE_ELEMENTS (4096 / sizeof(int))
+
+// Used when the L2 size cannot be queried
+#define DEFAULT_L2_BYTES (256 * 1024)
+
+// Partial results of one worker, merged after the job
+typedef struct {
+    uint64_t sum;  // Wraps like sum_reduce
+    int min;
+    int max;
+} partial;
+
+// A worker owns the chunk range [next, end); padded to a cache line so
+// workers updating their partials do not share one
+typedef struct {
+    pthread_mutex_t lock;
+    size_t next;
+    size_t end;
+    partial acc;
+    uint64_t generation;  // Pool generation when its thread was started
+} __attribute__((aligned(64))) worker;
+
+typedef struct job job;
+
+// Processes elements [first, first + count) of the job into acc
+typedef void (*chunk_fn)(const job *jb, size_t first, size_t count, partial *acc);
+
+struct job {
+    chunk_fn run;
+    const int *a;
+    const int *b;
+    int *out;
+    void (*binary)(const int *a, const int *b, int *out, size_t n);
+    void (*unary)(const int *x, int *out, size_t n);
+    size_t n;
+    size_t chunk;
+    size_t worker_count;
+    int steal;  // 0: each worker does exactly its starting range
+};
+
+static worker workers[MATH_PARALLEL_MAX_THREADS];
+
+// Pool state. run_lock serializes jobs; lock guards the rest. A new job
+// bumps generation and wakes every thread; workers 1 .. worker_count - 1
+// take part and the caller waits for running to drop to zero. job is NULL
+// between jobs.
+static struct {
+    pthread_mutex_t run_lock;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    const job *job;
+    uint64_t generation;
+    size_t running;
+    size_t started;  // Pool threads alive: workers 1 .. started
+} pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+          PTHREAD_COND_INITIALIZER, NULL, 0, 0, 0};
+
+static size_t thread_setting = 0;  // 0 = one per online CPU
+static size_t chunk_setting = 0;   // 0 = sized from the L2 cache
+
+// ============ Chunk functions ============
+
+static void run_binary(const job *jb, size_t first, size_t count, partial *acc) {
+    (void)acc;
+    jb->binary(jb->a + first, jb->b + first, jb->out + first, count);
+}
+
+static void run_unary(const job *jb, size_t first, size_t count, partial *acc) {
+    (void)acc;
+    jb->unary(jb->a + first, jb->out + first, count);
+}
+
+static void run_max(const job *jb, size_t first, size_t count, partial *acc) {
+    int max = max_reduce(jb->a + first, count);
+    acc->max = max > acc->max ? max : acc->max;
+}
+
+static void run_min(const job *jb, size_t first, size_t count, partial *acc) {
+    int min = min_reduce(jb->a + first, count);
+    acc->min = min < acc->min ? min : acc->min;
+}
+
+static void run_sum(const job *jb, size_t first, size_t count, partial *acc) {
+    acc->sum += (uint64_t)sum_reduce(jb->a + first, count);
+}
+
+static void run_touch(const job *jb, size_t first, size_t count, partial *acc) {
+    (void)acc;
+    memset(jb->out + first, 0, count * sizeof(int));
+}
+
+// ============ Work stealing ============
+
+static int take_own(worker *w, size_t *chunk) {
+    int found = 0;
+
+    pthread_mutex_lock(&w->lock);
+    if (w->next < w->end) {
+        *chunk = w->next++;
+        found = 1;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return found;
+}
+
+// Moves the upper half of the fullest other range into w's own range
+static int steal(const job *jb, worker *w) {
+    for (;;) {
+        worker *victim = NULL;
+        size_t most = 0;
+
+        for (size_t i = 0; i < jb->worker_count; i++) {
+            worker *other = &workers[i];
+            if (other == w) {
+                continue;
+            }
+            pthread_mutex_lock(&other->lock);
+            size_t remaining = other->end - other->next;
+            pthread_mutex_unlock(&other->lock);
+            if (remaining > most) {
+                most = remaining;
+                victim = other;
+            }
+        }
+        if (victim == NULL) {
+            return 0;
+        }
+
+        size_t first = 0, last = 0;
+        pthread_mutex_lock(&victim->lock);
+        if (victim->end > victim->next) {
+            first = victim->next + (victim->end - victim->next) / 2;
+            last = victim->end;
+            victim->end = first;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (first < last) {
+            pthread_mutex_lock(&w->lock);
+            w->next = first;
+            w->end = last;
+            pthread_mutex_unlock(&w->lock);
+            return 1;
+        }
+    }
+}
+
+static void work(const job *jb, worker *w) {
+    size_t chunk;
+
+    do {
+        while (take_own(w, &chunk)) {
+            size_t first = chunk * jb->chunk;
+            size_t count = jb->n - first < jb->chunk ? jb->n - first : jb->chunk;
+            jb->run(jb, first, count, &w->acc);
+        }
+    } while (jb->steal && steal(jb, w));
+}
+
+// ============ Pool ============
+
+// Pins the calling pool thread to the index-th CPU it may run on
+static void pin_to_cpu(size_t index) {
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+        return;
+    }
+    size_t skip = index % (size_t)CPU_COUNT(&allowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed) && skip-- == 0) {
+            cpu_set_t one;
+            CPU_ZERO(&one);
+            CPU_SET(cpu, &one);
+            pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+            return;
+        }
+    }
+#else
+    (void)index;
+#endif
+}
+
+static void *pool_thread(void *arg) {
+    size_t index = (size_t)(uintptr_t)arg;
+    uint64_t seen;
+
+    pin_to_cpu(index);
+    pthread_mutex_lock(&pool.lock);
+    seen = workers[index].generation;
+    for (;;) {
+        while (pool.generation == seen) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        seen = pool.generation;
+        const job *jb = pool.job;
+        if (jb == NULL || index >= jb->worker_count) {
+            continue;  // Not part of this job, or woke after it finished
+        }
+        pthread_mutex_unlock(&pool.lock);
+        work(jb, &workers[index]);
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.running == 0) {
+            pthread_cond_signal(&pool.done);
+        }
+    }
+    return NULL;
+}
+
+// A forked child has only the thread that forked: start the pool over
+static void pool_after_fork(void) {
+    pthread_mutex_init(&pool.run_lock, NULL);
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.wake, NULL);
+    pthread_cond_init(&pool.done, NULL);
+    for (size_t i = 0; i < MATH_PARALLEL_MAX_THREADS; i++) {
+        pthread_mutex_init(&workers[i].lock, NULL);
+    }
+    pool.started = 0;
+}
+
+// Starts pool threads until workers 1 .. wanted exist; called with
+// run_lock held. Returns the number alive, which is less when thread
+// creation fails.
+static size_t pool_grow(size_t wanted) {
+    static int registered = 0;
+    pthread_attr_t attr;
+
+    if (!registered) {
+        pthread_atfork(NULL, NULL, pool_after_fork);
+        for (size_t i = 0; i < MATH_PARALLEL_MAX_THREADS; i++) {
+            pthread_mutex_init(&workers[i].lock, NULL);
+        }
+        registered = 1;
+    }
+    if (pool.started >= wanted || pthread_attr_init(&attr) != 0) {
+        return pool.started;
+    }
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    while (pool.started < wanted) {
+        pthread_t thread;
+        size_t index = pool.started + 1;
+        // The thread may first look at the pool after the next job has
+        // been posted; it takes part in every job after this generation
+        workers[index].generation = pool.generation;
+        if (pthread_create(&thread, &attr, pool_thread, (void *)(uintptr_t)index) != 0) {
+            break;
+        }
+        pool.started++;
+    }
+    pthread_attr_destroy(&attr);
+    return pool.started;
+}
+
+static size_t online_cpus(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (size_t)cores : 1;
+}
+
+// Elements per chunk: half the L2 cache over two inputs and an output,
+// in whole pages. Every job uses it, so a given length always maps the
+// same elements to the same worker.
+static size_t chunk_elements(void) {
+    size_t chunk = __atomic_load_n(&chunk_setting, __ATOMIC_RELAXED);
+    if (chunk != 0) {
+        return chunk;
+    }
+    long l2 = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    size_t bytes = l2 > 0 ? (size_t)l2 : DEFAULT_L2_BYTES;
+    chunk = bytes / 2 / (3 * sizeof(int)) / PAGE_ELEMENTS * PAGE_ELEMENTS;
+    return chunk > PAGE_ELEMENTS ? chunk : PAGE_ELEMENTS;
+}
+
+// Runs jb over its n elements and returns the merged partials
+static partial run_job(job *jb) {
+    partial result = {0, INT_MAX, INT_MIN};
+    size_t chunks = (jb->n + jb->chunk - 1) / jb->chunk;
+    size_t threads = math_parallel_threads();
+
+    if (threads > chunks) {
+        threads = chunks;
+    }
+    if (threads <= 1) {
+        jb->run(jb, 0, jb->n, &result);
+        return result;
+    }
+
+    pthread_mutex_lock(&pool.run_lock);
+    size_t alive = pool_grow(threads - 1);
+    if (threads > alive + 1) {
+        threads = alive + 1;
+    }
+    jb->worker_count = threads;
+    for (size_t i = 0; i < threads; i++) {
+        workers[i].next = chunks * i / threads;
+        workers[i].end = chunks * (i + 1) / threads;
+        workers[i].acc = result;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.job = jb;
+    pool.running = threads - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    work(jb, &workers[0]);
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.running > 0) {
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pool.job = NULL;
+    pthread_mutex_unlock(&pool.lock);
+
+    for (size_t i = 0; i < threads; i++) {
+        const partial *acc = &workers[i].acc;
+        result.sum += acc->sum;
+        result.min = acc->min < result.min ? acc->min : result.min;
+        result.max = acc->max > result.max ? acc->max : result.max;
+    }
+    pthread_mutex_unlock(&pool.run_lock);
+    return result;
+}
+
+// ============ Configuration ============
+
+int math_parallel_set_threads(size_t threads) {
+    if (threads > MATH_PARALLEL_MAX_THREADS) {
+        return MATH_ERR_DOMAIN;
+    }
+    __atomic_store_n(&thread_setting, threads, __ATOMIC_RELAXED);
+    return MATH_OK;
+}
+
+size_t math_parallel_threads(void) {
+    size_t threads = __atomic_load_n(&thread_setting, __ATOMIC_RELAXED);
+    if (threads == 0) {
+        threads = online_cpus();
+    }
+    return threads < MATH_PARALLEL_MAX_THREADS ? threads : MATH_PARALLEL_MAX_THREADS;
+}
+
+void math_parallel_set_chunk(size_t elements) {
+    if (elements > SIZE_MAX - CHUNK_ALIGN) {
+        elements = SIZE_MAX - CHUNK_ALIGN;
+    }
+    elements = (elements + CHUNK_ALIGN - 1) / CHUNK_ALIGN * CHUNK_ALIGN;
+    __atomic_store_n(&chunk_setting, elements, __ATOMIC_RELAXED);
+}
+
+size_t math_parallel_chunk(void) {
+    return chunk_elements();
+}
+
+int *math_parallel_alloc(size_t n) {
+    if (n > (SIZE_MAX - 63) / sizeof(int)) {
+        return NULL;
+    }
+    // aligned_alloc wants a multiple of the alignment
+    size_t bytes = (n * sizeof(int) + 63) / 64 * 64;
+    int *x = aligned_alloc(64, bytes > 0 ? bytes : 64);
+    if (x != NULL && n > 0) {
+        // No stealing: each page must be touched by the worker whose
+        // starting range holds it
+        job jb = {run_touch, NULL, NULL, x, NULL, NULL, n, chunk_elements(), 0, 0};
+        run_job(&jb);
+    }
+    return x;
+}
+
+// ============ Public parallel API ============
+
+#define DEFINE_PARALLEL_BINARY(name) \
+    void parallel_##name##_n(const int *a, const int *b, int *out, size_t n) { \
+        job jb = {run_binary, a, b, out, name##_n, NULL, n, chunk_elements(), 0, 1}; \
+        run_job(&jb); \
+    }
+
+#define DEFINE_PARALLEL_UNARY(name) \
+    void parallel_##name##_n(const int *x, int *out, size_t n) { \
+        job jb = {run_unary, x, NULL, out, NULL, name##_n, n, chunk_elements(), 0, 1}; \
+        run_job(&jb); \
+    }
+
+DEFINE_PARALLEL_BINARY(add)
+DEFINE_PARALLEL_BINARY(subtract)
+DEFINE_PARALLEL_BINARY(multiply)
+DEFINE_PARALLEL_BINARY(max_value)
+DEFINE_PARALLEL_BINARY(min_value)
+DEFINE_PARALLEL_UNARY(abs_value)
+DEFINE_PARALLEL_UNARY(is_even)
+DEFINE_PARALLEL_UNARY(is_positive)
+DEFINE_PARALLEL_BINARY(saturating_add)
+DEFINE_PARALLEL_BINARY(saturating_subtract)
+DEFINE_PARALLEL_BINARY(saturating_multiply)
+DEFINE_PARALLEL_UNARY(saturating_abs_value)
+DEFINE_PARALLEL_UNARY(factorial)
+DEFINE_PARALLEL_UNARY(fibonacci)
+
+int parallel_max_reduce(const int *x, size_t n) {
+    job jb = {run_max, x, NULL, NULL, NULL, NULL, n, chunk_elements(), 0, 1};
+    return run_job(&jb).max;
+}
+
+int parallel_min_reduce(const int *x, size_t n) {
+    job jb = {run_min, x, NULL, NULL, NULL, NULL, n, chunk_elements(), 0, 1};
+    return run_job(&jb).min;
+}
+
+int64_t parallel_sum_reduce(const int *x, size_t n) {
+    job jb = {run_sum, x, NULL, NULL, NULL, NULL, n, chunk_elements(), 0, 1};
+    return (int64_t)run_job(&jb).sum;
+}
@@ -1,12 +1,16 @@
 #!/bin/bash
 
-# test_symbolic.sh - Symbolic Execution Testing with KLEE
-# Uses KLEE Docker container for symbolic execution analysis
+# test_symbolic.sh - Symbolic Execution Testing
+# Runs the harnesses in tests/symbolic/test_symbolic.c on one backend:
+#   bounded  the in-repo bounded checker (make symbolic-run); no KLEE needed
+#   klee     a locally built KLEE (klee, clang and llvm-link on PATH)
+#   docker   KLEE from the klee/klee image
+# SYMBOLIC_BACKEND picks one; the default (auto) is a local KLEE when there
+# is one, else the bounded checker. Docker is only used when asked for.
 
 set -e
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
-SRC_DIR="${SCRIPT_DIR}/src"
 BUILD_DIR="${SCRIPT_DIR}/build/symbolic"
 
 # Colors for output
@@ -18,309 +22,191 @@ NC='\033[0m' # No Color
 
 # KLEE Configuration
 KLEE_IMAGE="klee/klee:latest"
-KLEE_TIMEOUT="30"  # seconds per test
-KLEE_MEMORY="2048" # MB
+KLEE_MEMORY="2048" # MB per harness; time budgets are in the harness table
+JOBS="${SYMBOLIC_JOBS:-$(nproc 2>/dev/null || echo 1)}"
+BACKEND="${SYMBOLIC_BACKEND:-auto}"
 
-echo "=== Symbolic Execution Testing with KLEE ==="
+echo "=== Symbolic Execution Testing ==="
 
-# Create necessary directories
-mkdir -p "${BUILD_DIR}"
 mkdir -p "${BUILD_DIR}/results"
 
-# Step 1: Check Docker and KLEE image
-echo -e "${YELLOW}[1] Checking Docker and KLEE image...${NC}"
+# Step 1: Pick the backend
+echo -e "${YELLOW}[1] Selecting backend...${NC}"
 
-if ! command -v docker &> /dev/null; then
-    echo -e "${RED}Error: Docker is not installed${NC}"
-    exit 1
-fi
-
-if ! docker image inspect "${KLEE_IMAGE}" >/dev/null 2>&1; then
-    echo -e "${RED}Error: KLEE image not found. Pull it with:${NC}"
-    echo "  docker pull ${KLEE_IMAGE}"
-    exit 1
-fi
-
-echo -e "${GREEN}✓ Docker and KLEE image ready${NC}"
-
-# Step 2: Create KLEE test harness template
-echo -e "${YELLOW}[2] Setting up KLEE test harness...${NC}"
-
-HARNESS_FILE="${BUILD_DIR}/harness.c"
-
-if [ ! -f "${HARNESS_FILE}" ]; then
-    cat > "${HARNESS_FILE}" << 'EOF'
-#include <klee/klee.h>
-#include <stdio.h>
-#include <assert.h>
-
-// Include your header files here
-// #include "myprogram.h"
-
-// Example symbolic execution harness
-// Modify this based on your actual code
-
-/*
-// Example 1: Testing a simple function
-int my_function(int a, int b) {
-    if (a > b) {
-        return a - b;
-    } else {
-        return b - a;
-    }
-}
-
-void test_my_function() {
-    int x, y;
-
-    // Mark these as symbolic (KLEE will explore all paths)
-    klee_make_symbolic(&x, sizeof(x), "x");
-    klee_make_symbolic(&y, sizeof(y), "y");
-
-    // Constrain inputs if needed
-    klee_assume(x >= 0 && x <= 100);
-    klee_assume(y >= 0 && y <= 100);
-
-    int result = my_function(x, y);
-
-    // Check properties that should always hold
-    klee_assert(result >= 0);
-    klee_assert(result <= 100);
-}
-
-int main() {
-    test_my_function();
-    klee_silent_exit(0);
-    return 0;
-}
-*/
-
-// Example 2: Testing array access
-/*
-#define ARRAY_SIZE 10
-
-int find_element(int arr[], int size, int target) {
-    for (int i = 0; i < size; i++) {
-        if (arr[i] == target) {
-            return i;
-        }
-    }
-    return -1;
-}
-
-void test_array_access() {
-    int arr[ARRAY_SIZE];
-    int target;
-
-    klee_make_symbolic(arr, sizeof(arr), "arr");
-    klee_make_symbolic(&target, sizeof(target), "target");
-
-    int idx = find_element(arr, ARRAY_SIZE, target);
-
-    // Verify: if found, the element must match
-    if (idx >= 0 && idx < ARRAY_SIZE) {
-        klee_assert(arr[idx] == target);
-    }
-}
-
-int main() {
-    test_array_access();
-    klee_silent_exit(0);
-    return 0;
-}
-*/
-
-// Example 3: Buffer overflow detection
-/*
-void process_string(char *str) {
-    char buffer[10];
-    int i = 0;
-
-    // This could overflow if str is long
-    while (str[i] != '\0') {
-        buffer[i] = str[i];
-        i++;
-    }
-    buffer[i] = '\0';
-}
-
-void test_string_processing() {
-    char str[20];
-    klee_make_symbolic(str, sizeof(str), "input_string");
-
-    // KLEE will find if process_string can overflow
-    process_string(str);
-}
-
-int main() {
-    test_string_processing();
-    klee_silent_exit(0);
-    return 0;
-}
-*/
-
-int main() {
-    printf("KLEE Symbolic Execution Harness\n");
-    printf("Add your test cases to this file\n");
-
-    klee_silent_exit(0);
-    return 0;
-}
-EOF
-    echo -e "${GREEN}✓ Created harness template at ${HARNESS_FILE}${NC}"
+if [ "${BACKEND}" = "auto" ]; then
+    if command -v klee &> /dev/null && command -v clang &> /dev/null && command -v llvm-link &> /dev/null; then
+        BACKEND="klee"
+    else
+        BACKEND="bounded"
+    fi
 fi
 
-# Step 3: Prepare source files for KLEE
-echo -e "${YELLOW}[3] Preparing source files for KLEE...${NC}"
-
-# Copy source files to build directory
-if ls "${SRC_DIR}"/*.c >/dev/null 2>&1; then
-    cp "${SRC_DIR}"/*.c "${BUILD_DIR}/" 2>/dev/null || true
-    cp "${SRC_DIR}"/*.h "${BUILD_DIR}/" 2>/dev/null || true
-    echo -e "${GREEN}✓ Source files copied${NC}"
-else
-    echo -e "${YELLOW}⚠ No source files found in ${SRC_DIR}${NC}"
+case "${BACKEND}" in
+    bounded)
+        echo -e "${GREEN}✓ Bounded checker (no KLEE found; set SYMBOLIC_BACKEND=docker for the KLEE image)${NC}"
+        ;;
+    klee)
+        for tool in klee clang llvm-link; do
+            if ! command -v "${tool}" &> /dev/null; then
+                echo -e "${RED}Error: ${tool} is not on PATH${NC}"
+                exit 1
+            fi
+        done
+        echo -e "${GREEN}✓ Local KLEE: $(command -v klee)${NC}"
+        ;;
+    docker)
+        if ! command -v docker &> /dev/null; then
+            echo -e "${RED}Error: Docker is not installed${NC}"
+            exit 1
+        fi
+        if ! docker image inspect "${KLEE_IMAGE}" >/dev/null 2>&1; then
+            echo -e "${RED}Error: KLEE image not found. Pull it with:${NC}"
+            echo "  docker pull ${KLEE_IMAGE}"
+            exit 1
+        fi
+        echo -e "${GREEN}✓ Docker and KLEE image ready${NC}"
+        ;;
+    *)
+        echo -e "${RED}Error: unknown SYMBOLIC_BACKEND '${BACKEND}' (auto, bounded, klee or docker)${NC}"
+        exit 1
+        ;;
+esac
+
+# Bounded checker: the harnesses run natively, no bitcode involved
+if [ "${BACKEND}" = "bounded" ]; then
+    echo -e "${YELLOW}[2] Running the bounded checker...${NC}"
+    make -C "${SCRIPT_DIR}" --no-print-directory symbolic-run SYMBOLIC_ARGS="--jobs ${JOBS} $*"
+    exit $?
 fi
 
-# Step 4: Compile to LLVM bitcode using KLEE Docker
-echo -e "${YELLOW}[4] Compiling to LLVM bitcode (KLEE format)...${NC}"
 
-BITCODE_FILE="${BUILD_DIR}/test.bc"
+# Step 2: Compile the harnesses and math_utils.c to one bitcode file, and
+# list the harnesses whose code changed since their last clean run. The
+# scripts run on the host or in the container, from the repository root.
+echo -e "${YELLOW}[2] Compiling to LLVM bitcode (KLEE format)...${NC}"
 
-# Create Dockerfile for compilation
 COMPILE_SCRIPT="${BUILD_DIR}/compile.sh"
 cat > "${COMPILE_SCRIPT}" << 'EOF'
 #!/bin/bash
-cd /work
-
-# Compile with KLEE compiler (clang with LLVM instrumentation)
-clang -I/work -emit-llvm -c -g -o test.bc harness.c *.c 2>&1
-
-if [ -f test.bc ]; then
-    echo "Bitcode compilation successful"
-    ls -lh test.bc
-else
-    echo "Warning: Bitcode compilation may have failed"
-fi
+set -e
+OUT=build/symbolic
+for src in tests/symbolic/test_symbolic.c tests/symbolic/klee_run.c src/math_utils.c; do
+    clang -Isrc -emit-llvm -c -g -O0 -Xclang -disable-O0-optnone \
+        -o "${OUT}/$(basename "${src}" .c).bc" "${src}"
+done
+llvm-link -o "${OUT}/test.bc" "${OUT}/test_symbolic.bc" "${OUT}/klee_run.bc" "${OUT}/math_utils.bc"
 EOF
 
-chmod +x "${COMPILE_SCRIPT}"
-
-echo "Running KLEE container for compilation..."
-docker run --rm \
-    -v "${BUILD_DIR}:/work" \
-    "${KLEE_IMAGE}" \
-    bash /work/compile.sh
-
-if [ -f "${BITCODE_FILE}" ]; then
-    echo -e "${GREEN}✓ LLVM bitcode created${NC}"
-else
-    echo -e "${YELLOW}⚠ Bitcode file not created (check harness.c syntax)${NC}"
-fi
-
-# Step 5: Run KLEE symbolic execution
-echo -e "${YELLOW}[5] Running KLEE symbolic execution...${NC}"
-
-RESULTS_DIR="${BUILD_DIR}/results/klee_results"
-
-# Create KLEE execution script
+# One KLEE per harness, started at its own function: NAME ENTRY SECONDS
 KLEE_SCRIPT="${BUILD_DIR}/run_klee.sh"
 cat > "${KLEE_SCRIPT}" << EOF
 #!/bin/bash
-cd /work
+OUT=build/symbolic/results/klee_\$1
+rm -rf "\${OUT}"
+klee \\
+    --output-dir="\${OUT}" \\
+    --entry-point="\$2" \\
+    --max-time=\$3s \\
+    --max-memory=${KLEE_MEMORY} \\
+    --simplify-sym-indices \\
+    --search=dfs \\
+    build/symbolic/test.bc > "\${OUT}.log" 2>&1 || true
+echo "  finished \$1"
+EOF
 
-echo "Starting KLEE symbolic execution..."
+# Harness names and time budgets, from the SYMBOLIC_HARNESS table
+HARNESSES=$(sed -n 's/^ *SYMBOLIC_HARNESS(\([a-z_0-9]*\), *\([0-9]*\)).*/\1 \2/p' \
+    "${SCRIPT_DIR}/tests/symbolic/test_symbolic.c")
+
+# Cache key per harness: its code hash (mutagen --hashes: the harness and
+# the math_utils.c functions it reaches) with its budgets
+make -C "${SCRIPT_DIR}" --no-print-directory build/symbolic/hashes.tsv > /dev/null
+harness_key() {
+    local hash
+    hash=$(awk -F'\t' -v entry="test_$1_symbolic" '$1 == entry { print $2 }' "${BUILD_DIR}/hashes.tsv")
+    printf '%s %s %s %s\n' "${hash}" "$2" "${KLEE_MEMORY}" "${BACKEND}" | cksum | cut -d' ' -f1
+}
 
-# Run KLEE with various options
-klee \
-    --output-dir=results/klee_results \
-    --max-time=${KLEE_TIMEOUT} \
-    --max-memory=${KLEE_MEMORY} \
-    --simplify-sym-indices \
-    --search=dfs \
-    test.bc 2>&1 || true
+JOB_LIST="${BUILD_DIR}/klee_jobs.txt"
+: > "${JOB_LIST}"
+while read -r name seconds; do
+    key_file="${BUILD_DIR}/results/klee_${name}/cache_key"
+    if [ -f "${key_file}" ] && [ "$(cat "${key_file}")" = "$(harness_key "${name}" "${seconds}")" ]; then
+        echo "  ${name}: unchanged since its last clean run (cached)"
+    else
+        echo "${name} test_${name}_symbolic ${seconds}" >> "${JOB_LIST}"
+    fi
+done <<< "${HARNESSES}"
 
-echo ""
-echo "KLEE execution completed"
-echo ""
+# Step 3: Run KLEE, one process per harness, JOBS at a time
+echo -e "${YELLOW}[3] Running KLEE on $(wc -l < "${JOB_LIST}") harness(es), ${JOBS} at a time...${NC}"
 
-# Display results if available
-if [ -d results/klee_results ]; then
-    echo "=== KLEE Results Summary ==="
-    echo "Test Cases Generated:"
-    find results/klee_results -name "*.ktest" | wc -l
-    echo ""
-    echo "Covered Instructions:"
-    find results/klee_results -name "info" -exec cat {} \; 2>/dev/null | grep -i "covered" || echo "N/A"
+RUN_ALL="bash build/symbolic/compile.sh && xargs -P ${JOBS} -n 3 bash build/symbolic/run_klee.sh < build/symbolic/klee_jobs.txt"
+if [ ! -s "${JOB_LIST}" ]; then
+    echo "  nothing to run"
+elif [ "${BACKEND}" = "klee" ]; then
+    (cd "${SCRIPT_DIR}" && bash -c "${RUN_ALL}")
+else
+    # One container for every harness
+    docker run --rm \
+        --memory="$((KLEE_MEMORY * JOBS))m" \
+        -v "${SCRIPT_DIR}:/work" \
+        -w /work \
+        "${KLEE_IMAGE}" \
+        bash -c "${RUN_ALL}"
 fi
-EOF
-
-chmod +x "${KLEE_SCRIPT}"
-
-# Run KLEE with mounted volume
-docker run --rm \
-    --memory="${KLEE_MEMORY}m" \
-    -v "${BUILD_DIR}:/work" \
-    "${KLEE_IMAGE}" \
-    bash /work/run_klee.sh
 
 echo -e "${GREEN}✓ Symbolic execution completed${NC}"
 
-# Step 6: Analyze results
-echo -e "${YELLOW}[6] Analyzing KLEE results...${NC}"
-
-if [ -d "${RESULTS_DIR}" ]; then
-    KTEST_COUNT=$(find "${RESULTS_DIR}" -name "*.ktest" 2>/dev/null | wc -l)
-    echo "Test Cases Generated: ${KTEST_COUNT}"
+# Step 4: Analyze results
+echo -e "${YELLOW}[4] Analyzing KLEE results...${NC}"
 
-    if [ -f "${RESULTS_DIR}/info" ]; then
-        echo ""
-        echo "--- KLEE Execution Info ---"
-        cat "${RESULTS_DIR}/info"
+ERRORS=0
+while read -r name seconds; do
+    dir="${BUILD_DIR}/results/klee_${name}"
+    if [ ! -d "${dir}" ]; then
+        echo -e "${YELLOW}⚠ ${name}: no results directory (see ${dir}.log)${NC}"
+        ERRORS=$((ERRORS + 1))
+        continue
     fi
-
-    # Look for errors found by KLEE
-    if [ -f "${RESULTS_DIR}/test000001.assert.err" ]; then
-        echo -e "${RED}✗ Assertion failures detected!${NC}"
+    tests=$(find "${dir}" -name "*.ktest" 2>/dev/null | wc -l)
+    # Every failing path leaves a testNNNNNN.<kind>.err file
+    errors=$(find "${dir}" -name "*.err" 2>/dev/null | wc -l)
+    if [ "${errors}" -gt 0 ]; then
+        echo -e "${RED}✗ ${name}: ${errors} error(s) in ${tests} test cases${NC}"
+        find "${dir}" -name "*.err" -exec head -n 2 {} \; | sed 's/^/    /'
+        rm -f "${dir}/cache_key"
+        ERRORS=$((ERRORS + errors))
+    else
+        echo -e "${GREEN}✓ ${name}: ${tests} test cases, no errors${NC}"
+        harness_key "${name}" "${seconds}" > "${dir}/cache_key"
     fi
+done <<< "${HARNESSES}"
 
-    if [ -f "${RESULTS_DIR}/test000001.ptr.err" ]; then
-        echo -e "${RED}✗ Pointer errors detected!${NC}"
-    fi
-
-    if [ -f "${RESULTS_DIR}/test000001.free.err" ]; then
-        echo -e "${RED}✗ Memory errors detected!${NC}"
-    fi
-else
-    echo -e "${YELLOW}⚠ No results directory found${NC}"
-fi
-
-# Step 7: Display report
+# Step 5: Display report
 echo ""
 echo "=== Symbolic Execution Report ==="
-echo "Testing Framework:   KLEE (Symbolic Execution Engine)"
-echo "KLEE Image:          ${KLEE_IMAGE}"
-echo "Build Directory:     ${BUILD_DIR}"
-echo "Harness File:        ${HARNESS_FILE}"
-echo "Bitcode File:        ${BITCODE_FILE}"
-echo "Results Directory:   ${RESULTS_DIR}"
+echo "Backend:             ${BACKEND}"
+if [ "${BACKEND}" = "docker" ]; then
+    echo "KLEE Image:          ${KLEE_IMAGE}"
+fi
+echo "Harness File:        tests/symbolic/test_symbolic.c"
+echo "Results Directory:   ${BUILD_DIR}/results/klee_<harness>"
 echo ""
 echo -e "${BLUE}Configuration:${NC}"
-echo "  Timeout:           ${KLEE_TIMEOUT}s per test"
-echo "  Memory Limit:      ${KLEE_MEMORY}MB"
-echo ""
-echo -e "${BLUE}Next steps:${NC}"
-echo "1. Edit ${HARNESS_FILE} to add your test cases"
-echo "2. Use klee_make_symbolic() to mark symbolic variables"
-echo "3. Use klee_assert() to check properties"
-echo "4. Run: $0"
+echo "  Timeout:           per harness (SYMBOLIC_HARNESS table)"
+echo "  Memory Limit:      ${KLEE_MEMORY}MB per harness"
+echo "  Parallel Jobs:     ${JOBS}"
 echo ""
 echo -e "${BLUE}KLEE Documentation:${NC}"
 echo "  Website:  https://klee.github.io/"
 echo "  Tutorial: https://klee.github.io/tutorials/"
 echo ""
 
-# Cleanup temporary scripts
-rm -f "${COMPILE_SCRIPT}" "${KLEE_SCRIPT}"
+rm -f "${COMPILE_SCRIPT}" "${KLEE_SCRIPT}" "${JOB_LIST}"
 
+if [ "${ERRORS}" -gt 0 ]; then
+    echo -e "${RED}Symbolic execution found errors.${NC}"
+    exit 1
+fi
 echo "Symbolic execution testing complete."
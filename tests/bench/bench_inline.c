@@ -0,0 +1,16 @@
+// Benchmark loops compiled against the header-only inline build of
+// math_utils, so the compiler can inline (and vectorize) every call.
+#define MATH_UTILS_INLINE
+#include "math_utils.h"
+#include "bench_kernels.h"
+
+#define DEFINE_INLINE_BINARY(fn) BENCH_DEFINE_BINARY_LOOP(inline, fn)
+#define DEFINE_INLINE_UNARY(fn) BENCH_DEFINE_UNARY_LOOP(inline, fn)
+#define DEFINE_INLINE_CHECKED_BINARY(fn) BENCH_DEFINE_CHECKED_BINARY_LOOP(inline, fn)
+#define DEFINE_INLINE_CHECKED_UNARY(fn) BENCH_DEFINE_CHECKED_UNARY_LOOP(inline, fn)
+
+BENCH_BINARY_FUNCTIONS(DEFINE_INLINE_BINARY)
+BENCH_UNARY_FUNCTIONS(DEFINE_INLINE_UNARY)
+BENCH_CHECKED_BINARY_FUNCTIONS(DEFINE_INLINE_CHECKED_BINARY)
+BENCH_CHECKED_UNARY_FUNCTIONS(DEFINE_INLINE_CHECKED_UNARY)
+BENCH_DEFINE_REDUCE_LOOPS(inline)
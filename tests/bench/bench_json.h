@@ -0,0 +1,25 @@
+#ifndef BENCH_JSON_H
+#define BENCH_JSON_H
+
+#include <stdio.h>
+
+// JSON output helpers shared by the benchmark drivers
+
+// Writes s as a JSON string literal, escaping quotes, backslashes and
+// control characters
+static inline void json_string(FILE *json, const char *s) {
+    fputc('"', json);
+    for (; *s != '\0'; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fprintf(json, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(json, "\\u%04x", c);
+        } else {
+            fputc(c, json);
+        }
+    }
+    fputc('"', json);
+}
+
+#endif // BENCH_JSON_H
@@ -0,0 +1,121 @@
+#ifndef BENCH_KERNELS_H
+#define BENCH_KERNELS_H
+
+#include <limits.h>
+#include <stddef.h>
+
+// Element-wise loops over math_utils functions, shared by the benchmark
+// driver (out-of-line calls) and bench_inline.c (MATH_UTILS_INLINE).
+// Every loop has the same signature; unary loops ignore b.
+
+typedef void (*bench_loop)(const int *a, const int *b, int *out, size_t n);
+
+// Functions with an int result, grouped by argument shape
+#define BENCH_BINARY_FUNCTIONS(X) \
+    X(add) X(subtract) X(multiply) X(max_value) X(min_value) \
+    X(saturating_add) X(saturating_subtract) X(saturating_multiply)
+
+#define BENCH_UNARY_FUNCTIONS(X) \
+    X(abs_value) X(is_even) X(is_positive) X(factorial) X(fibonacci) \
+    X(saturating_abs_value)
+
+// Functions returning a status and writing the result through a pointer
+#define BENCH_CHECKED_BINARY_FUNCTIONS(X) \
+    X(checked_add) X(checked_subtract) X(checked_multiply)
+
+#define BENCH_CHECKED_UNARY_FUNCTIONS(X) \
+    X(checked_abs_value)
+
+// Reductions over a, result in out[0] (and out[1] for minmax_reduce)
+#define BENCH_REDUCE_FUNCTIONS(X) \
+    X(max_reduce) X(min_reduce) X(minmax_reduce) X(count_even) X(count_positive)
+
+#define BENCH_DEFINE_BINARY_LOOP(prefix, fn) \
+    void prefix##_##fn##_loop(const int *a, const int *b, int *out, size_t n) { \
+        for (size_t i = 0; i < n; i++) { \
+            out[i] = fn(a[i], b[i]); \
+        } \
+    }
+
+#define BENCH_DEFINE_UNARY_LOOP(prefix, fn) \
+    void prefix##_##fn##_loop(const int *a, const int *b, int *out, size_t n) { \
+        (void)b; \
+        for (size_t i = 0; i < n; i++) { \
+            out[i] = fn(a[i]); \
+        } \
+    }
+
+#define BENCH_DEFINE_CHECKED_BINARY_LOOP(prefix, fn) \
+    void prefix##_##fn##_loop(const int *a, const int *b, int *out, size_t n) { \
+        for (size_t i = 0; i < n; i++) { \
+            int result = 0; \
+            out[i] = fn(a[i], b[i], &result) + result; \
+        } \
+    }
+
+#define BENCH_DEFINE_CHECKED_UNARY_LOOP(prefix, fn) \
+    void prefix##_##fn##_loop(const int *a, const int *b, int *out, size_t n) { \
+        (void)b; \
+        for (size_t i = 0; i < n; i++) { \
+            int result = 0; \
+            out[i] = fn(a[i], &result) + result; \
+        } \
+    }
+
+// The reductions written as loops over their scalar functions
+#define BENCH_DEFINE_REDUCE_LOOPS(prefix) \
+    void prefix##_max_reduce_loop(const int *a, const int *b, int *out, size_t n) { \
+        int result = INT_MIN; \
+        (void)b; \
+        for (size_t i = 0; i < n; i++) { \
+            result = max_value(result, a[i]); \
+        } \
+        out[0] = result; \
+    } \
+    void prefix##_min_reduce_loop(const int *a, const int *b, int *out, size_t n) { \
+        int result = INT_MAX; \
+        (void)b; \
+        for (size_t i = 0; i < n; i++) { \
+            result = min_value(result, a[i]); \
+        } \
+        out[0] = result; \
+    } \
+    void prefix##_minmax_reduce_loop(const int *a, const int *b, int *out, size_t n) { \
+        int low = INT_MAX, high = INT_MIN; \
+        (void)b; \
+        for (size_t i = 0; i < n; i++) { \
+            low = min_value(low, a[i]); \
+            high = max_value(high, a[i]); \
+        } \
+        out[0] = low; \
+        out[1] = high; \
+    } \
+    void prefix##_count_even_loop(const int *a, const int *b, int *out, size_t n) { \
+        int count = 0; \
+        (void)b; \
+        for (size_t i = 0; i < n; i++) { \
+            count += is_even(a[i]); \
+        } \
+        out[0] = count; \
+    } \
+    void prefix##_count_positive_loop(const int *a, const int *b, int *out, size_t n) { \
+        int count = 0; \
+        (void)b; \
+        for (size_t i = 0; i < n; i++) { \
+            count += is_positive(a[i]); \
+        } \
+        out[0] = count; \
+    }
+
+#define BENCH_DECLARE_LOOP(prefix, fn) \
+    void prefix##_##fn##_loop(const int *a, const int *b, int *out, size_t n);
+
+// Inlined loops (defined in bench_inline.c)
+#define BENCH_DECLARE_INLINE(fn) BENCH_DECLARE_LOOP(inline, fn)
+BENCH_BINARY_FUNCTIONS(BENCH_DECLARE_INLINE)
+BENCH_UNARY_FUNCTIONS(BENCH_DECLARE_INLINE)
+BENCH_CHECKED_BINARY_FUNCTIONS(BENCH_DECLARE_INLINE)
+BENCH_CHECKED_UNARY_FUNCTIONS(BENCH_DECLARE_INLINE)
+BENCH_REDUCE_FUNCTIONS(BENCH_DECLARE_INLINE)
+
+#endif // BENCH_KERNELS_H
@@ -0,0 +1,538 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include "math_utils.h"
+#include "bench_json.h"
+#include "bench_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+// Microbenchmark Suite
+// Times every math_utils.h function in scalar (out-of-line call), batch
+// (*_n) and inlined (MATH_UTILS_INLINE) form over several input
+// distributions, and writes the results as JSON for regression tracking.
+//
+// The random and adversarial inputs overflow add, subtract and multiply,
+// which is undefined for plain signed ints; the Makefile builds the
+// benchmark with -fwrapv so every form times the wrapping arithmetic the
+// batch kernels do.
+
+#define DEFAULT_ELEMENTS 16384            // Per array: 64 KiB, stays in L2
+#define DEFAULT_WORK (1u << 20)           // Elements processed per trial
+#define TRIALS 5                          // Best-of-N trials per case
+
+// ============ Loops under test ============
+
+#define DEFINE_SCALAR_BINARY(fn) BENCH_DEFINE_BINARY_LOOP(scalar, fn)
+#define DEFINE_SCALAR_UNARY(fn) BENCH_DEFINE_UNARY_LOOP(scalar, fn)
+#define DEFINE_SCALAR_CHECKED_BINARY(fn) BENCH_DEFINE_CHECKED_BINARY_LOOP(scalar, fn)
+#define DEFINE_SCALAR_CHECKED_UNARY(fn) BENCH_DEFINE_CHECKED_UNARY_LOOP(scalar, fn)
+
+BENCH_BINARY_FUNCTIONS(DEFINE_SCALAR_BINARY)
+BENCH_UNARY_FUNCTIONS(DEFINE_SCALAR_UNARY)
+BENCH_CHECKED_BINARY_FUNCTIONS(DEFINE_SCALAR_CHECKED_BINARY)
+BENCH_CHECKED_UNARY_FUNCTIONS(DEFINE_SCALAR_CHECKED_UNARY)
+BENCH_DEFINE_REDUCE_LOOPS(scalar)
+
+#define DEFINE_BATCH_BINARY(fn) \
+    static void batch_##fn##_loop(const int *a, const int *b, int *out, size_t n) { \
+        fn##_n(a, b, out, n); \
+    }
+
+#define DEFINE_BATCH_UNARY(fn) \
+    static void batch_##fn##_loop(const int *a, const int *b, int *out, size_t n) { \
+        (void)b; \
+        fn##_n(a, out, n); \
+    }
+
+BENCH_BINARY_FUNCTIONS(DEFINE_BATCH_BINARY)
+BENCH_UNARY_FUNCTIONS(DEFINE_BATCH_UNARY)
+
+static void batch_max_reduce_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    out[0] = max_reduce(a, n);
+}
+
+static void batch_min_reduce_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    out[0] = min_reduce(a, n);
+}
+
+static void batch_minmax_reduce_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    minmax_reduce(a, n, &out[0], &out[1]);
+}
+
+static void batch_count_even_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    out[0] = (int)count_even(a, n);
+}
+
+static void batch_count_positive_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    out[0] = (int)count_positive(a, n);
+}
+
+// ============ Branchy references ============
+// The data-dependent branches the scalar functions used to have. GCC
+// would turn most of them into cmov or vector code, so if-conversion and
+// vectorization are off here: on random data these rows show what one
+// unpredictable branch per element costs next to the branchless forms.
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define BRANCHY __attribute__((noinline, optimize("no-if-conversion", "no-if-conversion2", \
+                                                  "no-ssa-phiopt", "no-tree-vectorize")))
+#else
+#define BRANCHY __attribute__((noinline))
+#endif
+
+BRANCHY static void branchy_max_value_loop(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] > b[i]) {
+            out[i] = a[i];
+        } else {
+            out[i] = b[i];
+        }
+    }
+}
+
+BRANCHY static void branchy_min_value_loop(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] < b[i]) {
+            out[i] = a[i];
+        } else {
+            out[i] = b[i];
+        }
+    }
+}
+
+BRANCHY static void branchy_abs_value_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] < 0) {
+            out[i] = (int)(0u - (unsigned int)a[i]);
+        } else {
+            out[i] = a[i];
+        }
+    }
+}
+
+BRANCHY static void branchy_is_even_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] % 2 == 0) {
+            out[i] = 1;
+        } else {
+            out[i] = 0;
+        }
+    }
+}
+
+BRANCHY static void branchy_max_reduce_loop(const int *a, const int *b, int *out, size_t n) {
+    int result = INT_MIN;
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] > result) {
+            result = a[i];
+        }
+    }
+    out[0] = result;
+}
+
+BRANCHY static void branchy_min_reduce_loop(const int *a, const int *b, int *out, size_t n) {
+    int result = INT_MAX;
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] < result) {
+            result = a[i];
+        }
+    }
+    out[0] = result;
+}
+
+BRANCHY static void branchy_minmax_reduce_loop(const int *a, const int *b, int *out, size_t n) {
+    int low = INT_MAX, high = INT_MIN;
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] < low) {
+            low = a[i];
+        }
+        if (a[i] > high) {
+            high = a[i];
+        }
+    }
+    out[0] = low;
+    out[1] = high;
+}
+
+BRANCHY static void branchy_count_even_loop(const int *a, const int *b, int *out, size_t n) {
+    int count = 0;
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] % 2 == 0) {
+            count++;
+        }
+    }
+    out[0] = count;
+}
+
+BRANCHY static void branchy_count_positive_loop(const int *a, const int *b, int *out, size_t n) {
+    int count = 0;
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] > 0) {
+            count++;
+        }
+    }
+    out[0] = count;
+}
+
+// Wide fibonacci variants only exist out of line
+static void scalar_fibonacci_i64_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        int64_t result = 0;
+        out[i] = fibonacci_i64(a[i], &result) + (int)result;
+    }
+}
+
+static void scalar_fibonacci_u64_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t result = 0;
+        out[i] = fibonacci_u64((uint64_t)(unsigned int)a[i], &result) + (int)result;
+    }
+}
+
+#ifdef __SIZEOF_INT128__
+static void scalar_fibonacci_u128_loop(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+        unsigned __int128 result = 0;
+        out[i] = fibonacci_u128((uint64_t)(unsigned int)a[i], &result) + (int)result;
+    }
+}
+#endif
+
+struct bench_case {
+    const char *function;
+    bench_loop scalar;
+    bench_loop batch;    // NULL when there is no *_n form
+    bench_loop inlined;  // NULL when the function is not inline-capable
+};
+
+#define CASE_WITH_BATCH(fn) { #fn, scalar_##fn##_loop, batch_##fn##_loop, inline_##fn##_loop },
+#define CASE_NO_BATCH(fn) { #fn, scalar_##fn##_loop, NULL, inline_##fn##_loop },
+
+static const struct bench_case cases[] = {
+    BENCH_BINARY_FUNCTIONS(CASE_WITH_BATCH)
+    BENCH_UNARY_FUNCTIONS(CASE_WITH_BATCH)
+    BENCH_CHECKED_BINARY_FUNCTIONS(CASE_NO_BATCH)
+    BENCH_CHECKED_UNARY_FUNCTIONS(CASE_NO_BATCH)
+    BENCH_REDUCE_FUNCTIONS(CASE_WITH_BATCH)
+    { "fibonacci_i64", scalar_fibonacci_i64_loop, NULL, NULL },
+    { "fibonacci_u64", scalar_fibonacci_u64_loop, NULL, NULL },
+#ifdef __SIZEOF_INT128__
+    { "fibonacci_u128", scalar_fibonacci_u128_loop, NULL, NULL },
+#endif
+};
+
+#define CASE_COUNT (sizeof(cases) / sizeof(cases[0]))
+
+// Extra "branchy" form of the functions that had a branchy implementation
+#define BRANCHY_CASE(fn) { #fn, branchy_##fn##_loop },
+
+static const struct {
+    const char *function;
+    bench_loop loop;
+} branchy_cases[] = {
+    BRANCHY_CASE(max_value) BRANCHY_CASE(min_value) BRANCHY_CASE(abs_value)
+    BRANCHY_CASE(is_even) BENCH_REDUCE_FUNCTIONS(BRANCHY_CASE)
+};
+
+static bench_loop find_branchy(const char *function) {
+    for (size_t i = 0; i < sizeof(branchy_cases) / sizeof(branchy_cases[0]); i++) {
+        if (strcmp(branchy_cases[i].function, function) == 0) {
+            return branchy_cases[i].loop;
+        }
+    }
+    return NULL;
+}
+
+// ============ Input distributions ============
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t next_random(void) {
+    // xorshift64*: fixed seed so every run sees the same inputs
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+// Small: [-64, 64]
+static int gen_small(void) {
+    return (int)(next_random() % 129) - 64;
+}
+
+// Random: uniform over all 2^32 values
+static int gen_random(void) {
+    return (int)next_random();
+}
+
+// Adversarial: within 1024 of INT_MAX or INT_MIN, where overflow happens
+static int gen_adversarial(void) {
+    uint32_t r = next_random();
+    int offset = (int)(r >> 1) % 1024;
+    return (r & 1) ? INT_MAX - offset : INT_MIN + offset;
+}
+
+struct distribution {
+    const char *name;
+    int (*generate)(void);
+};
+
+static const struct distribution distributions[] = {
+    { "small", gen_small },
+    { "random", gen_random },
+    { "adversarial", gen_adversarial },
+};
+
+#define DISTRIBUTION_COUNT (sizeof(distributions) / sizeof(distributions[0]))
+
+// ============ Timing ============
+
+struct measurement {
+    double ns_per_op;
+    double ops_per_sec;
+    double cycles_per_element;  // < 0 when no cycle counter is available
+};
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static volatile int sink;
+
+// Best of TRIALS runs of `reps` passes over n elements
+static struct measurement time_loop(bench_loop loop, const int *a, const int *b,
+                                    int *out, size_t n, size_t reps) {
+    double best_ns = 0;
+    uint64_t best_cycles = 0;
+
+    loop(a, b, out, n);  // Warm-up
+    for (int t = 0; t < TRIALS; t++) {
+        double start = now_ns();
+        uint64_t start_cycles = now_cycles();
+        for (size_t r = 0; r < reps; r++) {
+            loop(a, b, out, n);
+        }
+        uint64_t cycles = now_cycles() - start_cycles;
+        double elapsed = now_ns() - start;
+        if (t == 0 || elapsed < best_ns) {
+            best_ns = elapsed;
+            best_cycles = cycles;
+        }
+        sink = out[n - 1];
+    }
+
+    double ops = (double)n * (double)reps;
+    struct measurement m;
+    m.ns_per_op = best_ns / ops;
+    m.ops_per_sec = ops / (best_ns / 1e9);
+#ifdef BENCH_HAVE_TSC
+    m.cycles_per_element = (double)best_cycles / ops;
+#else
+    (void)best_cycles;
+    m.cycles_per_element = -1;
+#endif
+    return m;
+}
+
+// ============ Reporting ============
+
+static const char *simd_level_name(math_simd_level level) {
+    switch (level) {
+    case MATH_SIMD_SSE2:
+        return "sse2";
+    case MATH_SIMD_AVX2:
+        return "avx2";
+    case MATH_SIMD_AVX512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+static void print_row(const char *function, const char *form, const char *dist,
+                      struct measurement m) {
+    printf("%-22s %-8s %-12s %10.3f %14.0f %10.2f\n",
+           function, form, dist, m.ns_per_op, m.ops_per_sec, m.cycles_per_element);
+}
+
+static void json_row(FILE *json, int *first, const char *function, const char *form,
+                     const char *dist, struct measurement m) {
+    if (json == NULL) {
+        return;
+    }
+    fprintf(json, "%s\n    {\"function\": \"%s\", \"form\": \"%s\", \"distribution\": \"%s\", "
+            "\"ns_per_op\": %.4f, \"ops_per_sec\": %.0f, \"cycles_per_element\": ",
+            *first ? "" : ",", function, form, dist, m.ns_per_op, m.ops_per_sec);
+    if (m.cycles_per_element >= 0) {
+        fprintf(json, "%.3f}", m.cycles_per_element);
+    } else {
+        fprintf(json, "null}");
+    }
+    *first = 0;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [--json FILE] [--label TEXT] [--quick] [--filter NAME]\n", prog);
+    printf("  --json FILE    Write results as JSON to FILE\n");
+    printf("  --label TEXT   Label stored in the JSON (e.g. commit or build variant)\n");
+    printf("  --quick        Process 16x fewer elements per trial\n");
+    printf("  --filter NAME  Only run functions whose name contains NAME\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *json_path = NULL;
+    const char *label = "";
+    const char *filter = NULL;
+    size_t work = DEFAULT_WORK;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            work /= 16;
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    size_t n = DEFAULT_ELEMENTS;
+    size_t reps = work / n;
+    int *a = malloc(n * sizeof(int));
+    int *b = malloc(n * sizeof(int));
+    int *out = malloc(n * sizeof(int));
+    if (a == NULL || b == NULL || out == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    FILE *json = NULL;
+    if (json_path != NULL) {
+        json = fopen(json_path, "w");
+        if (json == NULL) {
+            perror(json_path);
+            return 1;
+        }
+    }
+
+    printf("========================================\n");
+    printf("  math_utils Microbenchmark Suite\n");
+    printf("========================================\n");
+    printf("SIMD level: %s, elements: %zu, passes/trial: %zu, trials: %d\n\n",
+           simd_level_name(math_simd_active()), n, reps, TRIALS);
+    printf("%-22s %-8s %-12s %10s %14s %10s\n",
+           "function", "form", "distribution", "ns/op", "ops/sec", "cycles/el");
+
+    if (json != NULL) {
+        fprintf(json, "{\n  \"label\": ");
+        json_string(json, label);
+        fprintf(json, ",\n  \"compiler\": ");
+        json_string(json, __VERSION__);
+        fprintf(json, ",\n"
+                "  \"simd_level\": \"%s\",\n  \"elements\": %zu,\n  \"passes_per_trial\": %zu,\n"
+                "  \"trials\": %d,\n  \"results\": [",
+                simd_level_name(math_simd_active()), n, reps, TRIALS);
+    }
+    int first = 1;
+
+    for (size_t d = 0; d < DISTRIBUTION_COUNT; d++) {
+        for (size_t i = 0; i < n; i++) {
+            a[i] = distributions[d].generate();
+            b[i] = distributions[d].generate();
+        }
+        for (size_t c = 0; c < CASE_COUNT; c++) {
+            const struct bench_case *bc = &cases[c];
+            if (filter != NULL && strstr(bc->function, filter) == NULL) {
+                continue;
+            }
+            const char *forms[4] = {"scalar", "batch", "inline", "branchy"};
+            bench_loop loops[4] = {bc->scalar, bc->batch, bc->inlined,
+                                   find_branchy(bc->function)};
+            for (int f = 0; f < 4; f++) {
+                if (loops[f] == NULL) {
+                    continue;
+                }
+                struct measurement m = time_loop(loops[f], a, b, out, n, reps);
+                print_row(bc->function, forms[f], distributions[d].name, m);
+                json_row(json, &first, bc->function, forms[f], distributions[d].name, m);
+            }
+        }
+    }
+
+    // Arbitrary precision: one F(10^6) per operation
+    if (filter == NULL || strstr("fibonacci_big", filter) != NULL) {
+        double best_ns = 0;
+        uint64_t best_cycles = 0;
+        for (int t = 0; t < TRIALS; t++) {
+            math_bigint big = MATH_BIGINT_INIT;
+            double start = now_ns();
+            uint64_t start_cycles = now_cycles();
+            int status = fibonacci_big(1000000, &big);
+            uint64_t cycles = now_cycles() - start_cycles;
+            double elapsed = now_ns() - start;
+            if (status != MATH_OK) {
+                fprintf(stderr, "fibonacci_big failed: %d\n", status);
+                return 1;
+            }
+            sink = (int)big.len;
+            math_bigint_free(&big);
+            if (t == 0 || elapsed < best_ns) {
+                best_ns = elapsed;
+                best_cycles = cycles;
+            }
+        }
+        struct measurement m = { best_ns, 1e9 / best_ns, (double)best_cycles };
+#ifndef BENCH_HAVE_TSC
+        m.cycles_per_element = -1;
+#endif
+        print_row("fibonacci_big", "scalar", "n=1000000", m);
+        json_row(json, &first, "fibonacci_big", "scalar", "n=1000000", m);
+    }
+
+    if (json != NULL) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+        printf("\nResults written to %s\n", json_path);
+    }
+
+    free(a);
+    free(b);
+    free(out);
+    return 0;
+}
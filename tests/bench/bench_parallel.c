@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "math_utils.h"
+#include "bench_json.h"
+
+// Parallel Scaling Benchmark
+// Times the parallel batch API (parallel_*) over arrays far larger than
+// the caches at 1, 2, ..., N threads and reports memory throughput, speedup
+// over one thread and parallel efficiency (speedup / threads). Arrays are
+// allocated per thread count with math_parallel_alloc, so their pages are
+// first-touched by the workers that use them.
+
+#define DEFAULT_ELEMENTS ((size_t)1 << 24)  // Per array: 64 MiB
+#define TRIALS 5                            // Best-of-N trials per case
+
+// ============ Cases ============
+
+static volatile int64_t sink;
+
+static void run_add(const int *a, const int *b, int *out, size_t n) {
+    parallel_add_n(a, b, out, n);
+}
+
+static void run_multiply(const int *a, const int *b, int *out, size_t n) {
+    parallel_multiply_n(a, b, out, n);
+}
+
+static void run_max_value(const int *a, const int *b, int *out, size_t n) {
+    parallel_max_value_n(a, b, out, n);
+}
+
+static void run_max_reduce(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    (void)out;
+    sink = parallel_max_reduce(a, n);
+}
+
+static void run_min_reduce(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    (void)out;
+    sink = parallel_min_reduce(a, n);
+}
+
+static void run_sum_reduce(const int *a, const int *b, int *out, size_t n) {
+    (void)b;
+    (void)out;
+    sink = parallel_sum_reduce(a, n);
+}
+
+typedef void (*parallel_loop)(const int *a, const int *b, int *out, size_t n);
+
+static const struct {
+    const char *function;
+    parallel_loop loop;
+    size_t bytes_per_element;  // Read and written
+} cases[] = {
+    { "add", run_add, 3 * sizeof(int) },
+    { "multiply", run_multiply, 3 * sizeof(int) },
+    { "max_value", run_max_value, 3 * sizeof(int) },
+    { "max_reduce", run_max_reduce, sizeof(int) },
+    { "min_reduce", run_min_reduce, sizeof(int) },
+    { "sum_reduce", run_sum_reduce, sizeof(int) },
+};
+
+#define CASE_COUNT (sizeof(cases) / sizeof(cases[0]))
+
+// ============ Timing ============
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Best of TRIALS passes, in ns
+static double time_loop(parallel_loop loop, const int *a, const int *b, int *out, size_t n) {
+    double best_ns = 0;
+
+    loop(a, b, out, n);  // Warm-up (also starts the pool threads)
+    for (int t = 0; t < TRIALS; t++) {
+        double start = now_ns();
+        loop(a, b, out, n);
+        double elapsed = now_ns() - start;
+        if (t == 0 || elapsed < best_ns) {
+            best_ns = elapsed;
+        }
+    }
+    return best_ns;
+}
+
+// ============ Reporting ============
+
+struct scaling {
+    double ms;
+    double gb_per_sec;
+    double speedup;     // Over the same function at one thread
+    double efficiency;  // speedup / threads
+};
+
+static void print_row(const char *function, size_t threads, struct scaling s) {
+    printf("%-12s %7zu %10.3f %10.2f %9.2f %10.2f\n",
+           function, threads, s.ms, s.gb_per_sec, s.speedup, s.efficiency);
+}
+
+static void json_row(FILE *json, int *first, const char *function, size_t threads,
+                     struct scaling s) {
+    if (json == NULL) {
+        return;
+    }
+    fprintf(json, "%s\n    {\"function\": \"%s\", \"threads\": %zu, \"ms\": %.4f, "
+            "\"gb_per_sec\": %.3f, \"speedup\": %.3f, \"efficiency\": %.3f}",
+            *first ? "" : ",", function, threads, s.ms, s.gb_per_sec, s.speedup, s.efficiency);
+    *first = 0;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [--json FILE] [--label TEXT] [--quick] [--filter NAME]\n"
+           "          [--elements N] [--threads N]\n", prog);
+    printf("  --json FILE    Write results as JSON to FILE\n");
+    printf("  --label TEXT   Label stored in the JSON (e.g. commit or build variant)\n");
+    printf("  --quick        Use 16x fewer elements\n");
+    printf("  --filter NAME  Only run functions whose name contains NAME\n");
+    printf("  --elements N   Elements per array (default %zu)\n", DEFAULT_ELEMENTS);
+    printf("  --threads N    Scale up to N threads (default: online CPUs)\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *json_path = NULL;
+    const char *label = "";
+    const char *filter = NULL;
+    size_t n = DEFAULT_ELEMENTS;
+    size_t max_threads = math_parallel_threads();
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            n /= 16;
+        } else if (strcmp(argv[i], "--elements") == 0 && i + 1 < argc) {
+            n = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = strtoull(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (n == 0 || max_threads == 0 || math_parallel_set_threads(max_threads) != MATH_OK) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *json = NULL;
+    if (json_path != NULL) {
+        json = fopen(json_path, "w");
+        if (json == NULL) {
+            perror(json_path);
+            return 1;
+        }
+    }
+
+    printf("========================================\n");
+    printf("  math_utils Parallel Scaling Benchmark\n");
+    printf("========================================\n");
+    printf("Elements: %zu, chunk: %zu, threads: 1..%zu, trials: %d\n\n",
+           n, math_parallel_chunk(), max_threads, TRIALS);
+    printf("%-12s %7s %10s %10s %9s %10s\n",
+           "function", "threads", "ms", "GB/s", "speedup", "efficiency");
+
+    if (json != NULL) {
+        fprintf(json, "{\n  \"label\": ");
+        json_string(json, label);
+        fprintf(json, ",\n  \"compiler\": ");
+        json_string(json, __VERSION__);
+        fprintf(json, ",\n  \"elements\": %zu,\n  \"chunk\": %zu,\n  \"trials\": %d,\n"
+                "  \"results\": [", n, math_parallel_chunk(), TRIALS);
+    }
+    int first = 1;
+
+    double single_ns[CASE_COUNT] = {0};
+    for (size_t threads = 1; threads <= max_threads; threads++) {
+        math_parallel_set_threads(threads);
+        int *a = math_parallel_alloc(n);
+        int *b = math_parallel_alloc(n);
+        int *out = math_parallel_alloc(n);
+        if (a == NULL || b == NULL || out == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        for (size_t i = 0; i < n; i++) {
+            a[i] = (int)(i * 2654435761u);
+            b[i] = (int)(i % 1000) - 500;
+        }
+
+        for (size_t c = 0; c < CASE_COUNT; c++) {
+            if (filter != NULL && strstr(cases[c].function, filter) == NULL) {
+                continue;
+            }
+            double ns = time_loop(cases[c].loop, a, b, out, n);
+            if (threads == 1) {
+                single_ns[c] = ns;
+            }
+            struct scaling s;
+            s.ms = ns / 1e6;
+            s.gb_per_sec = (double)n * (double)cases[c].bytes_per_element / ns;
+            s.speedup = single_ns[c] / ns;
+            s.efficiency = s.speedup / (double)threads;
+            print_row(cases[c].function, threads, s);
+            json_row(json, &first, cases[c].function, threads, s);
+        }
+
+        free(a);
+        free(b);
+        free(out);
+    }
+
+    if (json != NULL) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+        printf("\nResults written to %s\n", json_path);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#ifndef CHECKED_FUNCTIONS_H
+#define CHECKED_FUNCTIONS_H
+
+#include "math_utils.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// The int functions of math_utils.c by signature, for the tools that call
+// a mutant and the original side by side on the same inputs: the
+// small-domain equivalence check (equivalence.c) and the symbolic mutant
+// killer (tests/symbolic/kill_mutants.c). Exactly one pointer is set.
+
+typedef struct {
+    const char *name;
+    int (*unary)(int);
+    int (*binary)(int, int);
+    int (*checked_unary)(int, int *);
+    int (*checked_binary)(int, int, int *);
+} checked_function;
+
+static const checked_function checked_functions[] = {
+    {"add", .binary = add},
+    {"subtract", .binary = subtract},
+    {"multiply", .binary = multiply},
+    {"abs_value", .unary = abs_value},
+    {"max_value", .binary = max_value},
+    {"min_value", .binary = min_value},
+    {"is_even", .unary = is_even},
+    {"is_positive", .unary = is_positive},
+    {"checked_add", .checked_binary = checked_add},
+    {"checked_subtract", .checked_binary = checked_subtract},
+    {"checked_multiply", .checked_binary = checked_multiply},
+    {"checked_abs_value", .checked_unary = checked_abs_value},
+    {"saturating_add", .binary = saturating_add},
+    {"saturating_subtract", .binary = saturating_subtract},
+    {"saturating_multiply", .binary = saturating_multiply},
+    {"saturating_abs_value", .unary = saturating_abs_value},
+    {"factorial", .unary = factorial},
+    {"fibonacci", .unary = fibonacci},
+};
+
+#define CHECKED_FUNCTION_COUNT (sizeof(checked_functions) / sizeof(checked_functions[0]))
+
+static inline const checked_function *find_checked_function(const char *name) {
+    for (size_t i = 0; i < CHECKED_FUNCTION_COUNT; i++) {
+        if (strcmp(checked_functions[i].name, name) == 0) {
+            return &checked_functions[i];
+        }
+    }
+    return NULL;
+}
+
+static inline int checked_arity(const checked_function *f) {
+    return f->unary != NULL || f->checked_unary != NULL ? 1 : 2;
+}
+
+// Calls f on (a, b); b is ignored by one-argument functions. *out is only
+// written by the checked_* functions, on success.
+static inline int call_checked(const checked_function *f, int a, int b, int *out) {
+    if (f->unary != NULL) {
+        return f->unary(a);
+    } else if (f->binary != NULL) {
+        return f->binary(a, b);
+    } else if (f->checked_unary != NULL) {
+        return f->checked_unary(a, out);
+    }
+    return f->checked_binary(a, b, out);
+}
+
+#endif // CHECKED_FUNCTIONS_H
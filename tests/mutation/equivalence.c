@@ -0,0 +1,195 @@
+// equivalence - small-domain equivalence check of schemata mutants
+//
+// Linked against the mutant schemata object (mutagen). For every mutant of
+// a function in checked_functions.h, compares the mutant with the original
+// code (mutation_active_id 0) on every input of a small domain: each int in
+// [-UNARY_SPAN, UNARY_SPAN] for one-argument functions, every pair from
+// [-BINARY_SPAN, BINARY_SPAN] for two-argument ones, plus values around
+// INT_MIN, INT_MAX, each power of two and the multiply overflow bound. A
+// mutant that agrees everywhere is reported as equivalent, so the runner
+// does not spend a test run on it. The domain covers every boundary the
+// code compares against, but it is not a proof; pruned mutants are listed
+// with the method that pruned them.
+//
+// Each mutant is evaluated in a forked child, so a mutant that traps
+// (division by zero) or hangs counts as different.
+//
+// Reads the object-code equivalences from tce.sh in EQUIVALENT_TSV, skips
+// those mutants and appends its own findings:
+//   id<TAB>small_domain<TAB>0
+//
+// Usage: equivalence MUTANTS_TSV EQUIVALENT_TSV
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "checked_functions.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define UNARY_SPAN (1 << 16)
+#define BINARY_SPAN 64
+#define MAX_EDGES 256
+#define CHILD_TIMEOUT_S 10
+
+// Defined by the mutant schemata; selects the mutant every dispatcher runs
+extern int mutation_active_id;
+
+static int edges[MAX_EDGES];
+static size_t edge_count;
+
+static void add_edge(long long v) {
+    if (v >= INT_MIN && v <= INT_MAX && edge_count < MAX_EDGES) {
+        edges[edge_count++] = (int)v;
+    }
+}
+
+// Values near the ends of the int range and of each power of two, where
+// overflow checks and sign tests change their answer
+static void build_edges(void) {
+    for (int d = 0; d <= 2; d++) {
+        add_edge((long long)INT_MIN + d);
+        add_edge((long long)INT_MAX - d);
+    }
+    for (int k = 7; k <= 30; k++) {
+        for (int d = -1; d <= 1; d++) {
+            add_edge((1LL << k) + d);
+            add_edge(-(1LL << k) + d);
+        }
+    }
+    for (int d = -1; d <= 1; d++) {
+        add_edge(46341 + d);    // ceil(sqrt(INT_MAX)): squares overflow from here
+        add_edge(-46341 + d);
+    }
+}
+
+// Calls f on one input as the original and as the mutant
+static int same_result(const checked_function *f, int mutant_id, int a, int b) {
+    int out[2] = {0x5a5a5a5a, 0x5a5a5a5a};
+    int result[2];
+
+    for (int k = 0; k < 2; k++) {
+        mutation_active_id = k == 0 ? 0 : mutant_id;
+        result[k] = call_checked(f, a, b, &out[k]);
+    }
+    return result[0] == result[1] && out[0] == out[1];
+}
+
+// Domain value i: the span [-span, span] first, then the edges
+static int domain_value(size_t i, int span) {
+    size_t inner = 2 * (size_t)span + 1;
+    return i < inner ? (int)i - span : edges[i - inner];
+}
+
+static int agrees_on_domain(const checked_function *f, int mutant_id) {
+    int binary = checked_arity(f) == 2;
+    int span = binary ? BINARY_SPAN : UNARY_SPAN;
+    size_t size = 2 * (size_t)span + 1 + edge_count;
+
+    for (size_t i = 0; i < size; i++) {
+        int a = domain_value(i, span);
+        for (size_t j = 0; j < (binary ? size : 1); j++) {
+            if (!same_result(f, mutant_id, a, binary ? domain_value(j, span) : 0)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// 1 when the mutant agrees with the original on the whole domain, 0 when
+// it differs, traps or runs out of time
+static int check_mutant(const checked_function *f, int mutant_id) {
+    int status;
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        alarm(CHILD_TIMEOUT_S);
+        _exit(agrees_on_domain(f, mutant_id) ? 0 : 1);
+    }
+    if (pid < 0 || waitpid(pid, &status, 0) < 0) {
+        return 0;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Whether the equivalence file already lists the mutant
+static int already_listed(const int *listed, size_t count, int id) {
+    for (size_t i = 0; i < count; i++) {
+        if (listed[i] == id) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    FILE *mutants, *equivalent;
+    int *listed = NULL;
+    size_t listed_count = 0, cap = 0;
+    size_t checked = 0, pruned = 0;
+    char line[1024];
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s MUTANTS_TSV EQUIVALENT_TSV\n", argv[0]);
+        return 2;
+    }
+    equivalent = fopen(argv[2], "r");
+    while (equivalent != NULL && fgets(line, sizeof(line), equivalent) != NULL) {
+        int id;
+        if (line[0] == '#' || sscanf(line, "%d", &id) != 1) {
+            continue;
+        }
+        if (listed_count == cap) {
+            cap = cap ? cap * 2 : 64;
+            int *grown = realloc(listed, cap * sizeof(*grown));
+            if (grown == NULL) {
+                free(listed);
+                fclose(equivalent);
+                return 1;
+            }
+            listed = grown;
+        }
+        listed[listed_count++] = id;
+    }
+    if (equivalent != NULL) {
+        fclose(equivalent);
+    }
+
+    mutants = fopen(argv[1], "r");
+    equivalent = fopen(argv[2], "a");
+    if (mutants == NULL || equivalent == NULL) {
+        perror(mutants == NULL ? argv[1] : argv[2]);
+        free(listed);
+        return 1;
+    }
+    build_edges();
+    while (fgets(line, sizeof(line), mutants) != NULL) {
+        int id;
+        char name[64];
+        const checked_function *f;
+
+        if (line[0] == '#' || sscanf(line, "%d\t%63[^\t]", &id, name) != 2 ||
+            (f = find_checked_function(name)) == NULL || already_listed(listed, listed_count, id)) {
+            continue;
+        }
+        checked++;
+        if (check_mutant(f, id)) {
+            fprintf(equivalent, "%d\tsmall_domain\t0\n", id);
+            pruned++;
+        }
+    }
+    fclose(mutants);
+    free(listed);
+    if (fclose(equivalent) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+    printf("%zu of %zu mutants equivalent on the small domain\n", pruned, checked);
+    return 0;
+}
@@ -0,0 +1,44 @@
+#ifndef FORK_SERVER_H
+#define FORK_SERVER_H
+
+#include <stdint.h>
+
+// Fork-server protocol between mutation_runner and a mutant-schemata test
+// binary started with --fork-server (AFL style).
+//
+// The server initializes once (dynamic linking, libc, constructors, test
+// registration), then forks a pre-warmed child per request instead of
+// paying process startup per mutant. The runner hands it two pipes:
+//
+//   1. Once ready, the server writes FORK_SERVER_HELLO on the status fd.
+//   2. Per mutant, the runner writes a fork_server_request on the control
+//      fd, followed by names_size bytes of NUL-terminated test group names
+//      (none: every group).
+//   3. The server forks a child that selects the mutant, arms a timer of
+//      timeout_us and runs the groups with --fail-fast; a child still
+//      running when the timer fires dies of SIGALRM. The server reaps it
+//      and writes a fork_server_reply.
+//
+// The server exits when the control fd is closed.
+
+#define FORK_SERVER_CONTROL_FD 198
+#define FORK_SERVER_STATUS_FD 199
+
+#define FORK_SERVER_HELLO 0x76736b66u     // "fksv"
+
+// Upper bound on names_size
+#define FORK_SERVER_MAX_NAMES 4096
+
+typedef struct {
+    int32_t mutant_id;
+    uint32_t timeout_us;
+    uint32_t names_size;
+} fork_server_request;
+
+typedef struct {
+    int32_t pid;
+    int32_t status;         // waitpid status of the child
+    uint32_t micros;        // child run time, fork to reap
+} fork_server_reply;
+
+#endif // FORK_SERVER_H
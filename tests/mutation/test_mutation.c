@@ -1,31 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
 #include "math_utils.h"
+#include "test_runner.h"
 
 // Mutation Testing Test Suite
-// These tests are designed to catch common mutations
-
-int test_count = 0;
-int pass_count = 0;
-int fail_count = 0;
-
-#define TEST(name, condition) \
-    do { \
-        test_count++; \
-        if (condition) { \
-            pass_count++; \
-            printf("✓ %s\n", name); \
-        } else { \
-            fail_count++; \
-            printf("✗ %s\n", name); \
-        } \
-    } while (0)
+// These tests are designed to catch common mutations. Each TEST_GROUP is
+// registered with the runner (test_runner.c) and selectable by name.
 
 // ============ ADD Tests ============
-void test_add() {
-    printf("\n--- Testing add() ---\n");
-
+TEST_GROUP(add) {
     // Basic addition
     TEST("add(2, 3) == 5", add(2, 3) == 5);
     TEST("add(0, 5) == 5", add(0, 5) == 5);
@@ -47,9 +34,7 @@ void test_add() {
 }
 
 // ============ SUBTRACT Tests ============
-void test_subtract() {
-    printf("\n--- Testing subtract() ---\n");
-
+TEST_GROUP(subtract) {
     // Basic subtraction
     TEST("subtract(5, 3) == 2", subtract(5, 3) == 2);
     TEST("subtract(10, 0) == 10", subtract(10, 0) == 10);
@@ -70,9 +55,7 @@ void test_subtract() {
 }
 
 // ============ MULTIPLY Tests ============
-void test_multiply() {
-    printf("\n--- Testing multiply() ---\n");
-
+TEST_GROUP(multiply) {
     // Basic multiplication
     TEST("multiply(3, 4) == 12", multiply(3, 4) == 12);
     TEST("multiply(5, 2) == 10", multiply(5, 2) == 10);
@@ -94,9 +77,7 @@ void test_multiply() {
 }
 
 // ============ ABS_VALUE Tests ============
-void test_abs_value() {
-    printf("\n--- Testing abs_value() ---\n");
-
+TEST_GROUP(abs_value) {
     // Positive numbers
     TEST("abs_value(5) == 5", abs_value(5) == 5);
     TEST("abs_value(100) == 100", abs_value(100) == 100);
@@ -108,15 +89,17 @@ void test_abs_value() {
     // Zero
     TEST("abs_value(0) == 0", abs_value(0) == 0);
 
+    // INT_MIN has no positive counterpart and wraps to itself
+    TEST("abs_value(INT_MIN) == INT_MIN", abs_value(INT_MIN) == INT_MIN);
+    TEST("abs_value(INT_MIN + 1) == INT_MAX", abs_value(INT_MIN + 1) == INT_MAX);
+
     // Result is always non-negative
     TEST("abs_value(42) >= 0", abs_value(42) >= 0);
     TEST("abs_value(-42) >= 0", abs_value(-42) >= 0);
 }
 
 // ============ MAX_VALUE Tests ============
-void test_max_value() {
-    printf("\n--- Testing max_value() ---\n");
-
+TEST_GROUP(max_value) {
     TEST("max_value(5, 3) == 5", max_value(5, 3) == 5);
     TEST("max_value(3, 5) == 5", max_value(3, 5) == 5);
     TEST("max_value(5, 5) == 5", max_value(5, 5) == 5);
@@ -131,9 +114,7 @@ void test_max_value() {
 }
 
 // ============ MIN_VALUE Tests ============
-void test_min_value() {
-    printf("\n--- Testing min_value() ---\n");
-
+TEST_GROUP(min_value) {
     TEST("min_value(5, 3) == 3", min_value(5, 3) == 3);
     TEST("min_value(3, 5) == 3", min_value(3, 5) == 3);
     TEST("min_value(5, 5) == 5", min_value(5, 5) == 5);
@@ -148,9 +129,7 @@ void test_min_value() {
 }
 
 // ============ IS_EVEN Tests ============
-void test_is_even() {
-    printf("\n--- Testing is_even() ---\n");
-
+TEST_GROUP(is_even) {
     // Even numbers
     TEST("is_even(0) == 1", is_even(0) == 1);
     TEST("is_even(2) == 1", is_even(2) == 1);
@@ -167,9 +146,7 @@ void test_is_even() {
 }
 
 // ============ IS_POSITIVE Tests ============
-void test_is_positive() {
-    printf("\n--- Testing is_positive() ---\n");
-
+TEST_GROUP(is_positive) {
     // Positive numbers
     TEST("is_positive(1) == 1", is_positive(1) == 1);
     TEST("is_positive(100) == 1", is_positive(100) == 1);
@@ -181,9 +158,7 @@ void test_is_positive() {
 }
 
 // ============ FACTORIAL Tests ============
-void test_factorial() {
-    printf("\n--- Testing factorial() ---\n");
-
+TEST_GROUP(factorial) {
     TEST("factorial(0) == 1", factorial(0) == 1);
     TEST("factorial(1) == 1", factorial(1) == 1);
     TEST("factorial(2) == 2", factorial(2) == 2);
@@ -192,14 +167,15 @@ void test_factorial() {
     TEST("factorial(5) == 120", factorial(5) == 120);
     TEST("factorial(10) == 3628800", factorial(10) == 3628800);
 
-    // Error case
+    TEST("factorial(12) == 479001600", factorial(12) == 479001600);
+
+    // Error cases: negative input and int overflow
     TEST("factorial(-1) == -1", factorial(-1) == -1);
+    TEST("factorial(13) == -1 (overflow)", factorial(13) == -1);
 }
 
 // ============ FIBONACCI Tests ============
-void test_fibonacci() {
-    printf("\n--- Testing fibonacci() ---\n");
-
+TEST_GROUP(fibonacci) {
     TEST("fibonacci(0) == 0", fibonacci(0) == 0);
     TEST("fibonacci(1) == 1", fibonacci(1) == 1);
     TEST("fibonacci(2) == 1", fibonacci(2) == 1);
@@ -212,39 +188,549 @@ void test_fibonacci() {
     TEST("fibonacci(9) == 34", fibonacci(9) == 34);
     TEST("fibonacci(10) == 55", fibonacci(10) == 55);
 
-    // Error case
+    // Error cases: negative input and int overflow
     TEST("fibonacci(-1) == -1", fibonacci(-1) == -1);
+    TEST("fibonacci(46) == 1836311903", fibonacci(46) == 1836311903);
+    TEST("fibonacci(47) == -1 (overflow)", fibonacci(47) == -1);
 
     // Fibonacci property: fib(n) = fib(n-1) + fib(n-2)
     TEST("fibonacci(5) == fibonacci(4) + fibonacci(3)",
          fibonacci(5) == fibonacci(4) + fibonacci(3));
 }
 
-int main() {
-    printf("========================================\n");
-    printf("  Mutation Testing Test Suite\n");
-    printf("========================================\n");
-
-    test_add();
-    test_subtract();
-    test_multiply();
-    test_abs_value();
-    test_max_value();
-    test_min_value();
-    test_is_even();
-    test_is_positive();
-    test_factorial();
-    test_fibonacci();
-
-    // Summary
-    printf("\n========================================\n");
-    printf("Test Results Summary\n");
-    printf("========================================\n");
-    printf("Total Tests:  %d\n", test_count);
-    printf("Passed:       %d\n", pass_count);
-    printf("Failed:       %d\n", fail_count);
-    printf("Pass Rate:    %.1f%%\n", (test_count > 0) ? (100.0 * pass_count / test_count) : 0.0);
-    printf("========================================\n");
-
-    return (fail_count == 0) ? 0 : 1;
+// ============ SEQUENCE Tests ============
+TEST_GROUP(sequences) {
+    int out[FIBONACCI_MAX_N + 2];
+    int all = 1;
+
+    TEST("factorial_range(0, 13) fills every factorial",
+         factorial_range(0, FACTORIAL_MAX_N + 1, out) == MATH_OK);
+    for (int n = 0; n <= FACTORIAL_MAX_N; n++) all &= out[n] == factorial(n);
+    TEST("factorial_range(0, 13)[n] == factorial(n)", all);
+    out[2] = 7;
+    TEST("factorial_range(3, 2) == {6, 24}",
+         factorial_range(3, 2, out) == MATH_OK && out[0] == 6 && out[1] == 24);
+    TEST("factorial_range(3, 2) writes two values", out[2] == 7);
+    TEST("factorial_range(12, 1) == {479001600}",
+         factorial_range(12, 1, out) == MATH_OK && out[0] == 479001600);
+
+    out[0] = 7;
+    TEST("factorial_range(0, 14) overflows", factorial_range(0, FACTORIAL_MAX_N + 2, out) == MATH_ERR_OVERFLOW);
+    TEST("factorial_range(12, 2) overflows", factorial_range(12, 2, out) == MATH_ERR_OVERFLOW);
+    TEST("factorial_range(13, 1) overflows", factorial_range(13, 1, out) == MATH_ERR_OVERFLOW);
+    TEST("factorial_range writes nothing on overflow", out[0] == 7);
+    TEST("factorial_range(13, 0) is empty", factorial_range(13, 0, out) == MATH_OK);
+    TEST("factorial_range(-1, 1) is a domain error", factorial_range(-1, 1, out) == MATH_ERR_DOMAIN);
+
+    all = fibonacci_range(0, FIBONACCI_MAX_N + 1, out) == MATH_OK;
+    for (int n = 0; n <= FIBONACCI_MAX_N; n++) all &= out[n] == fibonacci(n);
+    TEST("fibonacci_range(0, 47)[n] == fibonacci(n)", all);
+    out[3] = 7;
+    TEST("fibonacci_range(10, 3) == {55, 89, 144}",
+         fibonacci_range(10, 3, out) == MATH_OK && out[0] == 55 && out[1] == 89 && out[2] == 144);
+    TEST("fibonacci_range(10, 3) writes three values", out[3] == 7);
+    TEST("fibonacci_range(46, 1) == {1836311903}",
+         fibonacci_range(46, 1, out) == MATH_OK && out[0] == 1836311903);
+    TEST("fibonacci_range(0, 48) overflows", fibonacci_range(0, FIBONACCI_MAX_N + 2, out) == MATH_ERR_OVERFLOW);
+    TEST("fibonacci_range(46, 2) overflows", fibonacci_range(46, 2, out) == MATH_ERR_OVERFLOW);
+    TEST("fibonacci_range(47, 1) overflows", fibonacci_range(47, 1, out) == MATH_ERR_OVERFLOW);
+    TEST("fibonacci_range(47, 0) is empty", fibonacci_range(47, 0, out) == MATH_OK);
+    TEST("fibonacci_range(-1, 1) is a domain error", fibonacci_range(-1, 1, out) == MATH_ERR_DOMAIN);
+}
+
+// ============ CHECKED / SATURATING Tests ============
+TEST_GROUP(checked) {
+    int out = 0;
+    TEST("checked_add(2, 3) == 5", checked_add(2, 3, &out) == MATH_OK && out == 5);
+    TEST("checked_add(INT_MAX, 1) overflows", checked_add(INT_MAX, 1, &out) == MATH_ERR_OVERFLOW);
+    TEST("checked_subtract(3, 5) == -2", checked_subtract(3, 5, &out) == MATH_OK && out == -2);
+    TEST("checked_subtract(INT_MIN, 1) overflows", checked_subtract(INT_MIN, 1, &out) == MATH_ERR_OVERFLOW);
+    TEST("checked_multiply(-3, 4) == -12", checked_multiply(-3, 4, &out) == MATH_OK && out == -12);
+    TEST("checked_multiply(65536, 65536) overflows",
+         checked_multiply(65536, 65536, &out) == MATH_ERR_OVERFLOW);
+    TEST("checked_abs_value(-5) == 5", checked_abs_value(-5, &out) == MATH_OK && out == 5);
+    TEST("checked_abs_value(1) == 1", checked_abs_value(1, &out) == MATH_OK && out == 1);
+    TEST("checked_abs_value(INT_MIN) overflows", checked_abs_value(INT_MIN, &out) == MATH_ERR_OVERFLOW);
+}
+
+TEST_GROUP(saturating) {
+    TEST("saturating_add(2, 3) == 5", saturating_add(2, 3) == 5);
+    TEST("saturating_add(INT_MAX, 1) == INT_MAX", saturating_add(INT_MAX, 1) == INT_MAX);
+    TEST("saturating_add(INT_MIN, -1) == INT_MIN", saturating_add(INT_MIN, -1) == INT_MIN);
+    TEST("saturating_subtract(INT_MIN, 1) == INT_MIN", saturating_subtract(INT_MIN, 1) == INT_MIN);
+    TEST("saturating_subtract(0, INT_MIN) == INT_MAX", saturating_subtract(0, INT_MIN) == INT_MAX);
+    TEST("saturating_subtract(1, INT_MIN) == INT_MAX", saturating_subtract(1, INT_MIN) == INT_MAX);
+    TEST("saturating_multiply(-3, 4) == -12", saturating_multiply(-3, 4) == -12);
+    TEST("saturating_multiply(65536, -65536) == INT_MIN", saturating_multiply(65536, -65536) == INT_MIN);
+    TEST("saturating_multiply(INT_MIN, -1) == INT_MAX", saturating_multiply(INT_MIN, -1) == INT_MAX);
+    TEST("saturating_multiply(-2, INT_MAX - 1) == INT_MIN",
+         saturating_multiply(-2, INT_MAX - 1) == INT_MIN);
+    TEST("saturating_abs_value(-5) == 5", saturating_abs_value(-5) == 5);
+    TEST("saturating_abs_value(1) == 1", saturating_abs_value(1) == 1);
+    TEST("saturating_abs_value(INT_MIN) == INT_MAX", saturating_abs_value(INT_MIN) == INT_MAX);
+}
+
+// ============ WIDE FIBONACCI Tests ============
+#define MEMO_THREADS 4
+
+// Every F(n) <= F(93), largest first on odd threads, against a linear loop
+static void *fibonacci_u64_from_thread(void *arg) {
+    int descending = (int)(size_t)arg & 1;
+    uint64_t expected[94];
+    uintptr_t ok = 1;
+
+    expected[0] = 0;
+    expected[1] = 1;
+    for (int n = 2; n <= 93; n++) expected[n] = expected[n - 1] + expected[n - 2];
+    for (int k = 0; k <= 93; k++) {
+        int n = descending ? 93 - k : k;
+        uint64_t value = 0;
+        ok &= fibonacci_u64((uint64_t)n, &value) == MATH_OK && value == expected[n];
+    }
+    return (void *)ok;
+}
+
+TEST_GROUP(fibonacci_wide) {
+    int64_t i64 = 0;
+    uint64_t u64 = 0;
+    TEST("fibonacci_i64(10) == 55", fibonacci_i64(10, &i64) == MATH_OK && i64 == 55);
+    TEST("fibonacci_i64(92) == 7540113804746346429",
+         fibonacci_i64(92, &i64) == MATH_OK && i64 == 7540113804746346429LL);
+    TEST("fibonacci_i64(93) overflows", fibonacci_i64(93, &i64) == MATH_ERR_OVERFLOW);
+    TEST("fibonacci_i64(-1) is a domain error", fibonacci_i64(-1, &i64) == MATH_ERR_DOMAIN);
+    TEST("fibonacci_u64(0) == 0", fibonacci_u64(0, &u64) == MATH_OK && u64 == 0);
+    TEST("fibonacci_u64(93) == 12200160415121876738",
+         fibonacci_u64(93, &u64) == MATH_OK && u64 == 12200160415121876738ULL);
+    TEST("fibonacci_u64(94) overflows", fibonacci_u64(94, &u64) == MATH_ERR_OVERFLOW);
+
+    // Fast doubling must agree with the linear loop wherever both are defined
+    int agree = 1;
+    for (int n = 0; n <= FIBONACCI_MAX_N; n++) {
+        agree &= fibonacci_i64(n, &i64) == MATH_OK && i64 == fibonacci(n);
+    }
+    TEST("fibonacci_i64(n) == fibonacci(n) for n <= FIBONACCI_MAX_N", agree);
+
+    uint64_t range[94];
+    TEST("fibonacci_range_u64(90, 4) ends at F(93)",
+         fibonacci_range_u64(90, 4, range) == MATH_OK && range[0] == 2880067194370816120ULL
+         && range[3] == 12200160415121876738ULL);
+    agree = fibonacci_range_u64(0, 94, range) == MATH_OK;
+    for (int n = 0; n <= FIBONACCI_MAX_N; n++) agree &= range[n] == (uint64_t)fibonacci(n);
+    TEST("fibonacci_range_u64(0, 94)[n] == fibonacci(n)", agree);
+    TEST("fibonacci_range_u64(93, 2) overflows", fibonacci_range_u64(93, 2, range) == MATH_ERR_OVERFLOW);
+    TEST("fibonacci_range_u64(94, 0) is empty", fibonacci_range_u64(94, 0, range) == MATH_OK);
+
+    // The memo cache is shared: concurrent readers and extenders agree
+    pthread_t threads[MEMO_THREADS];
+    int started = 0;
+    agree = 1;
+    while (started < MEMO_THREADS &&
+           pthread_create(&threads[started], NULL, fibonacci_u64_from_thread,
+                          (void *)(size_t)started) == 0) {
+        started++;
+    }
+    for (int t = 0; t < started; t++) {
+        void *ok = NULL;
+        pthread_join(threads[t], &ok);
+        agree &= ok != NULL;
+    }
+    TEST("fibonacci_u64 agrees across threads", started == MEMO_THREADS && agree);
+
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 u128 = 0;
+    // F(186) = 332825110087067562321196029789634457848
+    unsigned __int128 f186 = ((unsigned __int128)0xfa63c8d9fa216a8fULL << 64) | 0xc8a7213b333270f8ULL;
+    TEST("fibonacci_u128(186) == F(186)", fibonacci_u128(186, &u128) == MATH_OK && u128 == f186);
+    TEST("fibonacci_u128(187) overflows", fibonacci_u128(187, &u128) == MATH_ERR_OVERFLOW);
+#endif
+
+    math_bigint big = MATH_BIGINT_INIT;
+    char *text = NULL;
+    TEST("fibonacci_big(0) == 0", fibonacci_big(0, &big) == MATH_OK
+         && (text = math_bigint_to_decimal(&big)) != NULL && strcmp(text, "0") == 0);
+    free(text);
+    math_bigint_free(&big);
+
+    text = NULL;
+    TEST("fibonacci_big(100) == 354224848179261915075",
+         fibonacci_big(100, &big) == MATH_OK && (text = math_bigint_to_decimal(&big)) != NULL
+         && strcmp(text, "354224848179261915075") == 0);
+    free(text);
+    math_bigint_free(&big);
+
+    text = NULL;
+    TEST("fibonacci_big(1000) has 209 digits",
+         fibonacci_big(1000, &big) == MATH_OK && (text = math_bigint_to_decimal(&big)) != NULL
+         && strlen(text) == 209 && strncmp(text, "43466557686937456435", 20) == 0
+         && strcmp(text + 189, "76137795166849228875") == 0);
+    free(text);
+    math_bigint_free(&big);
+
+    // F(10^6): 694241 bits; the low limb must match F(n) mod 2^64
+    uint64_t lo_a = 0, lo_b = 1;
+    for (int i = 0; i < 1000000; i++) {
+        uint64_t next = lo_a + lo_b;
+        lo_a = lo_b;
+        lo_b = next;
+    }
+    TEST("fibonacci_big(1000000) has 10848 limbs and the right low limb",
+         fibonacci_big(1000000, &big) == MATH_OK && big.len == 10848 && big.limbs[0] == lo_a);
+    math_bigint_free(&big);
+}
+
+// ============ MODULAR Tests ============
+#define MODULAR_N 2000
+#define PRIME_1E9_7 1000000007ULL
+#define PRIME_BELOW_2_63 9223372036854775783ULL   // Largest prime < 2^63
+#define PRIME_BELOW_2_64 18446744073709551557ULL  // Largest prime < 2^64
+
+// n! mod m and F(n) mod m for n = 0..MODULAR_N-1 by the definitions;
+// m < 2^32 so that products fit
+static int modular_matches_naive(uint64_t m) {
+    uint64_t factorial_naive = 1 % m, fib_a = 0, fib_b = 1 % m, out = 0;
+    int agree = 1;
+    for (uint64_t n = 0; n < MODULAR_N; n++) {
+        if (n > 0) {
+            factorial_naive = factorial_naive * n % m;
+        }
+        agree &= factorial_mod(n, m, &out) == MATH_OK && out == factorial_naive;
+        agree &= fibonacci_mod(n, m, &out) == MATH_OK && out == fib_a;
+        uint64_t next = (fib_a + fib_b) % m;
+        fib_a = fib_b;
+        fib_b = next;
+    }
+    return agree;
+}
+
+// The batch forms on queries in no order, with duplicates, against the scalar forms
+static int modular_batch_matches_scalar(uint64_t m) {
+    const uint64_t x[] = {100000, 5, m - 2, 25, 100000, m, 21, m - 100, 0, 30, m - 2, m + 1, 20,
+                          1000, 25};
+    enum { COUNT = sizeof(x) / sizeof(x[0]) };
+    uint64_t factorials[COUNT], fibs[COUNT], expected = 0;
+    int agree = factorial_mod_n(x, m, factorials, COUNT) == MATH_OK
+                && fibonacci_mod_n(x, m, fibs, COUNT) == MATH_OK;
+    for (size_t i = 0; i < COUNT; i++) {
+        agree &= factorial_mod(x[i], m, &expected) == MATH_OK && factorials[i] == expected;
+        agree &= fibonacci_mod(x[i], m, &expected) == MATH_OK && fibs[i] == expected;
+    }
+    return agree;
+}
+
+TEST_GROUP(modular) {
+    uint64_t out = 0;
+
+    TEST("factorial_mod and fibonacci_mod match the definitions mod 1e9+7",
+         modular_matches_naive(PRIME_1E9_7));
+    TEST("... mod 997 (prime, Wilson past 498)", modular_matches_naive(997));
+    TEST("... mod 999999999 (odd composite)", modular_matches_naive(999999999));
+    TEST("... mod 1000000 (even)", modular_matches_naive(1000000));
+    TEST("... mod 2", modular_matches_naive(2));
+    TEST("... mod 1", modular_matches_naive(1));
+
+    TEST("factorial_mod(100000, 1e9+7) == 457992974",
+         factorial_mod(100000, PRIME_1E9_7, &out) == MATH_OK && out == 457992974);
+    TEST("factorial_mod(10^6, 1e9+7) == 641102369",
+         factorial_mod(1000000, PRIME_1E9_7, &out) == MATH_OK && out == 641102369);
+    // Across checkpoints (multiples of 1024), after another modulus reset them
+    uint64_t before = 0, at = 0, after = 0;
+    int checkpoints_agree = factorial_mod(5000, 999999999, &out) == MATH_OK
+                            && factorial_mod(2047, PRIME_1E9_7, &before) == MATH_OK
+                            && factorial_mod(2048, PRIME_1E9_7, &at) == MATH_OK
+                            && factorial_mod(2049, PRIME_1E9_7, &after) == MATH_OK;
+    TEST("factorial_mod agrees across a checkpoint after a modulus switch",
+         checkpoints_agree && at == before * 2048 % PRIME_1E9_7
+         && after == at * 2049 % PRIME_1E9_7);
+    TEST("factorial_mod(1e9+7, 1e9+7) == 0",
+         factorial_mod(PRIME_1E9_7, PRIME_1E9_7, &out) == MATH_OK && out == 0);
+    TEST("factorial_mod(20, 1e9+7) == 20! mod 1e9+7",
+         factorial_mod(20, PRIME_1E9_7, &out) == MATH_OK && out == 2432902008176640000ULL % PRIME_1E9_7);
+    // Wilson: (p-1)! = -1, (p-2)! = 1, (p-3)! = (p-1)/2 mod p
+    TEST("factorial_mod(p-1, p) == p-1 for p = 2^63-25",
+         factorial_mod(PRIME_BELOW_2_63 - 1, PRIME_BELOW_2_63, &out) == MATH_OK
+         && out == PRIME_BELOW_2_63 - 1);
+    TEST("factorial_mod(p-2, p) == 1 for p = 2^63-25",
+         factorial_mod(PRIME_BELOW_2_63 - 2, PRIME_BELOW_2_63, &out) == MATH_OK && out == 1);
+    TEST("factorial_mod(p-3, p) == (p-1)/2 for p = 2^64-59",
+         factorial_mod(PRIME_BELOW_2_64 - 3, PRIME_BELOW_2_64, &out) == MATH_OK
+         && out == (PRIME_BELOW_2_64 - 1) / 2);
+    TEST("factorial_mod(n, 0) is a domain error", factorial_mod(5, 0, &out) == MATH_ERR_DOMAIN);
+
+    TEST("fibonacci_mod(10^18, 1e9+7) == 209783453",
+         fibonacci_mod(1000000000000000000ULL, PRIME_1E9_7, &out) == MATH_OK && out == 209783453);
+    TEST("fibonacci_mod(10^18, 10^18) == 183788299560546875",
+         fibonacci_mod(1000000000000000000ULL, 1000000000000000000ULL, &out) == MATH_OK
+         && out == 183788299560546875ULL);
+    TEST("fibonacci_mod(2^64-1, 2^64-59) == 18446743708274255395",
+         fibonacci_mod(UINT64_MAX, PRIME_BELOW_2_64, &out) == MATH_OK
+         && out == 18446743708274255395ULL);
+    TEST("fibonacci_mod(2^64-1, 2^63) == 800812746651928290",
+         fibonacci_mod(UINT64_MAX, 1ULL << 63, &out) == MATH_OK && out == 800812746651928290ULL);
+    int agree = 1;
+    for (int n = 0; n <= 93; n++) {
+        uint64_t exact = 0;
+        agree &= fibonacci_u64(n, &exact) == MATH_OK
+                 && fibonacci_mod(n, PRIME_BELOW_2_64, &out) == MATH_OK && out == exact;
+    }
+    TEST("fibonacci_mod(n, 2^64-59) == fibonacci_u64(n) for n <= 93", agree);
+    TEST("fibonacci_mod(n, 0) is a domain error", fibonacci_mod(5, 0, &out) == MATH_ERR_DOMAIN);
+
+    TEST("factorial_mod_n and fibonacci_mod_n match the scalar forms mod 1e9+7",
+         modular_batch_matches_scalar(PRIME_1E9_7));
+    TEST("... mod 2^63-25", modular_batch_matches_scalar(PRIME_BELOW_2_63));
+    TEST("... mod 999999999", modular_batch_matches_scalar(999999999));
+    TEST("... mod 10^18", modular_batch_matches_scalar(1000000000000000000ULL));
+    uint64_t x = 3;
+    out = 7;
+    TEST("factorial_mod_n with n == 0 is empty",
+         factorial_mod_n(&x, PRIME_1E9_7, &out, 0) == MATH_OK && out == 7);
+    TEST("factorial_mod_n(m == 0) is a domain error",
+         factorial_mod_n(&x, 0, &out, 1) == MATH_ERR_DOMAIN);
+    TEST("fibonacci_mod_n(m == 0) is a domain error",
+         fibonacci_mod_n(&x, 0, &out, 1) == MATH_ERR_DOMAIN);
+}
+
+// ============ BATCH API Tests ============
+#define BATCH_LEN 37  // Not a multiple of any vector width: exercises tails
+
+// Check every batch function against its scalar counterpart at one SIMD level
+static int batch_matches_scalar(const int *a, const int *b, size_t n) {
+    int out[BATCH_LEN];
+    int ok = 1;
+
+    add_n(a, b, out, n);
+    for (size_t i = 0; i < n; i++) ok &= out[i] == add(a[i], b[i]);
+    subtract_n(a, b, out, n);
+    for (size_t i = 0; i < n; i++) ok &= out[i] == subtract(a[i], b[i]);
+    multiply_n(a, b, out, n);
+    for (size_t i = 0; i < n; i++) ok &= out[i] == multiply(a[i], b[i]);
+    max_value_n(a, b, out, n);
+    for (size_t i = 0; i < n; i++) ok &= out[i] == max_value(a[i], b[i]);
+    min_value_n(a, b, out, n);
+    for (size_t i = 0; i < n; i++) ok &= out[i] == min_value(a[i], b[i]);
+    abs_value_n(a, out, n);
+    for (size_t i = 0; i < n; i++) ok &= out[i] == abs_value(a[i]);
+    is_even_n(a, out, n);
+    for (size_t i = 0; i < n; i++) ok &= out[i] == is_even(a[i]);
+    is_positive_n(a, out, n);
+    for (size_t i = 0; i < n; i++) ok &= out[i] == is_positive(a[i]);
+
+    // Reductions over every prefix, so every tail length is covered
+    for (size_t len = 0; len <= n; len++) {
+        int lo = INT_MAX, hi = INT_MIN, min = 0, max = 0;
+        size_t even = 0, positive = 0;
+        int64_t sum = 0;
+        for (size_t i = 0; i < len; i++) {
+            sum += a[i];
+            lo = min_value(lo, a[i]);
+            hi = max_value(hi, a[i]);
+            even += (size_t)is_even(a[i]);
+            positive += (size_t)is_positive(a[i]);
+        }
+        minmax_reduce(a, len, &min, &max);
+        ok &= max_reduce(a, len) == hi && min_reduce(a, len) == lo && min == lo && max == hi;
+        ok &= count_even(a, len) == even && count_positive(a, len) == positive;
+        ok &= sum_reduce(a, len) == sum;
+    }
+
+    return ok;
+}
+
+// Wrapping results of the batch functions on extreme values at one level
+static void batch_extremes(int results[6]) {
+    int a[2] = {INT_MAX, INT_MIN};
+    int b[2] = {1, 2};
+    int out[2];
+
+    add_n(a, b, out, 2);
+    results[0] = out[0];
+    subtract_n(a, b, out, 2);
+    results[1] = out[1];
+    multiply_n(a, b, out, 2);
+    results[2] = out[0];
+    results[3] = out[1];
+    abs_value_n(a, out, 2);
+    results[4] = out[0];
+    results[5] = out[1];
+}
+
+TEST_GROUP(batch) {
+    int a[BATCH_LEN], b[BATCH_LEN];
+    for (int i = 0; i < BATCH_LEN; i++) {
+        a[i] = (i - 18) * 7;
+        b[i] = (i % 5) - 2;
+    }
+
+    math_simd_level best = math_simd_detect();
+    int reference[6];
+    math_simd_force(MATH_SIMD_SCALAR);
+    batch_extremes(reference);
+
+    int all_match = 1, all_extremes = 1;
+    for (int level = MATH_SIMD_SCALAR; level <= (int)best; level++) {
+        math_simd_force((math_simd_level)level);
+        all_match &= batch_matches_scalar(a, b, BATCH_LEN);
+
+        int results[6];
+        batch_extremes(results);
+        all_extremes &= memcmp(results, reference, sizeof(results)) == 0;
+    }
+    math_simd_force(best);
+
+    TEST("batch functions match scalar at every SIMD level", all_match);
+    TEST("batch overflow results are identical at every SIMD level", all_extremes);
+    TEST("add_n wraps INT_MAX + 1 to INT_MIN", reference[0] == INT_MIN);
+    TEST("abs_value_n(INT_MIN) == INT_MIN", reference[5] == INT_MIN);
+    TEST("math_simd_force rejects unsupported levels",
+         best == MATH_SIMD_AVX512 || math_simd_force(MATH_SIMD_AVX512) == -1);
+    TEST("math_simd_active reports forced level", math_simd_active() == best);
+
+    // Extremes in the middle of a vector, so only the horizontal fold finds them
+    int extremes[BATCH_LEN] = {0};
+    extremes[5] = INT_MAX;
+    extremes[22] = INT_MIN;
+    int lo = 0, hi = 0;
+    minmax_reduce(extremes, BATCH_LEN, &lo, &hi);
+    TEST("max_reduce finds INT_MAX", max_reduce(extremes, BATCH_LEN) == INT_MAX);
+    TEST("min_reduce finds INT_MIN", min_reduce(extremes, BATCH_LEN) == INT_MIN);
+    TEST("minmax_reduce finds both", lo == INT_MIN && hi == INT_MAX);
+    TEST("max_reduce of nothing is INT_MIN", max_reduce(extremes, 0) == INT_MIN);
+    TEST("min_reduce of nothing is INT_MAX", min_reduce(extremes, 0) == INT_MAX);
+    TEST("count_even counts INT_MIN and zeros", count_even(extremes, BATCH_LEN) == BATCH_LEN - 1);
+    TEST("count_positive counts INT_MAX only", count_positive(extremes, BATCH_LEN) == 1);
+    TEST("sum_reduce folds INT_MAX + INT_MIN", sum_reduce(extremes, BATCH_LEN) == -1);
+    TEST("sum_reduce of nothing is 0", sum_reduce(extremes, 0) == 0);
+
+    // Every lane at INT_MIN: a 32-bit accumulator would wrap at once
+    int minimums[BATCH_LEN];
+    for (int i = 0; i < BATCH_LEN; i++) {
+        minimums[i] = INT_MIN;
+    }
+    TEST("sum_reduce widens before adding",
+         sum_reduce(minimums, BATCH_LEN) == (int64_t)BATCH_LEN * INT_MIN);
+
+    // In-place operation: output aliases the first input
+    int inplace[BATCH_LEN];
+    memcpy(inplace, a, sizeof(inplace));
+    add_n(inplace, b, inplace, BATCH_LEN);
+    TEST("add_n works in place", inplace[BATCH_LEN - 1] == add(a[BATCH_LEN - 1], b[BATCH_LEN - 1]));
+
+    int ns[4] = {0, 5, 10, -1};
+    int facts[4], fibs[4];
+    factorial_n(ns, facts, 4);
+    fibonacci_n(ns, fibs, 4);
+    TEST("factorial_n matches factorial", facts[0] == 1 && facts[1] == 120 && facts[2] == 3628800 && facts[3] == -1);
+    TEST("fibonacci_n matches fibonacci", fibs[0] == 0 && fibs[1] == 5 && fibs[2] == 55 && fibs[3] == -1);
+}
+
+// ============ PARALLEL API Tests ============
+#define PARALLEL_CHUNK 64
+#define PARALLEL_LEN (PARALLEL_CHUNK * 37 + 11)  // Many chunks and a short last one
+
+// Check every parallel function against its sequential counterpart over
+// the first n elements at the current thread count
+static int parallel_matches_sequential(const int *a, const int *b, size_t n) {
+    static int expected[PARALLEL_LEN], out[PARALLEL_LEN];
+    int ok = 1;
+
+#define CHECK_BINARY(name) \
+    name##_n(a, b, expected, n); \
+    parallel_##name##_n(a, b, out, n); \
+    ok &= memcmp(expected, out, n * sizeof(int)) == 0;
+#define CHECK_UNARY(name) \
+    name##_n(a, expected, n); \
+    parallel_##name##_n(a, out, n); \
+    ok &= memcmp(expected, out, n * sizeof(int)) == 0;
+
+    CHECK_BINARY(add)
+    CHECK_BINARY(subtract)
+    CHECK_BINARY(multiply)
+    CHECK_BINARY(max_value)
+    CHECK_BINARY(min_value)
+    CHECK_UNARY(abs_value)
+    CHECK_UNARY(is_even)
+    CHECK_UNARY(is_positive)
+    CHECK_BINARY(saturating_add)
+    CHECK_BINARY(saturating_subtract)
+    CHECK_BINARY(saturating_multiply)
+    CHECK_UNARY(saturating_abs_value)
+    CHECK_UNARY(factorial)
+    CHECK_UNARY(fibonacci)
+#undef CHECK_BINARY
+#undef CHECK_UNARY
+
+    ok &= parallel_max_reduce(a, n) == max_reduce(a, n);
+    ok &= parallel_min_reduce(a, n) == min_reduce(a, n);
+    ok &= parallel_sum_reduce(a, n) == sum_reduce(a, n);
+    return ok;
+}
+
+TEST_GROUP(parallel) {
+    static int a[PARALLEL_LEN], b[PARALLEL_LEN];
+    uint64_t state = 12345;
+    for (int i = 0; i < PARALLEL_LEN; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        a[i] = (int)(uint32_t)(state >> 32);
+        b[i] = i % 3 == 0 ? a[i] % 50 : (int)(uint32_t)state;
+    }
+    math_parallel_set_chunk(PARALLEL_CHUNK);
+
+    // 64 threads is more than the 38 chunks
+    static const size_t thread_counts[] = {1, 3, 4, 64};
+    int all_match = 1, small_match = 1;
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        math_parallel_set_threads(thread_counts[t]);
+        all_match &= parallel_matches_sequential(a, b, PARALLEL_LEN);
+        small_match &= parallel_matches_sequential(a, b, 0);
+        small_match &= parallel_matches_sequential(a, b, 1);
+        small_match &= parallel_matches_sequential(a, b, PARALLEL_CHUNK + 1);
+    }
+    TEST("parallel functions match sequential at 1, 3, 4 and 64 threads", all_match);
+    TEST("... and for 0, 1 and chunk + 1 elements", small_match);
+    TEST("math_parallel_threads reports the setting", math_parallel_threads() == 64);
+    TEST("parallel_max_reduce of nothing is INT_MIN", parallel_max_reduce(a, 0) == INT_MIN);
+    TEST("parallel_min_reduce of nothing is INT_MAX", parallel_min_reduce(a, 0) == INT_MAX);
+    TEST("parallel_sum_reduce of nothing is 0", parallel_sum_reduce(a, 0) == 0);
+
+    // Extremes in different chunks; every chunk sum far past 32 bits
+    math_parallel_set_threads(4);
+    int *x = math_parallel_alloc(PARALLEL_LEN);
+    int zeroed = x != NULL;
+    for (size_t i = 0; zeroed && i < PARALLEL_LEN; i++) {
+        zeroed &= x[i] == 0;
+    }
+    TEST("math_parallel_alloc returns zeroed memory", zeroed);
+    TEST("math_parallel_alloc aligns to 64 bytes", x != NULL && (uintptr_t)x % 64 == 0);
+    if (x != NULL) {
+        for (size_t i = 0; i < PARALLEL_LEN; i++) {
+            x[i] = INT_MAX;
+        }
+        TEST("parallel_sum_reduce widens every chunk",
+             parallel_sum_reduce(x, PARALLEL_LEN) == (int64_t)PARALLEL_LEN * INT_MAX);
+        x[PARALLEL_LEN - 1] = INT_MIN;
+        TEST("parallel_min_reduce finds INT_MIN in the last chunk",
+             parallel_min_reduce(x, PARALLEL_LEN) == INT_MIN);
+        x[PARALLEL_CHUNK] = INT_MIN + 1;
+        TEST("parallel_max_reduce merges the workers",
+             parallel_max_reduce(x, PARALLEL_LEN) == INT_MAX);
+        free(x);
+    }
+    int *empty = math_parallel_alloc(0);
+    TEST("math_parallel_alloc(0) is freeable", empty != NULL);
+    free(empty);
+
+    TEST("math_parallel_set_threads rejects too many",
+         math_parallel_set_threads(MATH_PARALLEL_MAX_THREADS + 1) == MATH_ERR_DOMAIN &&
+         math_parallel_threads() == 4);
+    math_parallel_set_chunk(10);
+    TEST("math_parallel_set_chunk rounds up to 16", math_parallel_chunk() == 16);
+    math_parallel_set_chunk(0);
+    TEST("default chunks are whole pages",
+         math_parallel_chunk() > 0 && math_parallel_chunk() % (4096 / sizeof(int)) == 0);
+    math_parallel_set_threads(0);
+    TEST("default threads is at least one", math_parallel_threads() >= 1);
+}
+
+int main(int argc, char **argv) {
+    return test_main(argc, argv, "Mutation Testing Test Suite");
 }
@@ -0,0 +1,510 @@
+#include "test_runner.h"
+#include "fork_server.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_GROUPS 64
+
+typedef struct {
+    const char *name;
+    test_group_fn run;
+    const char *file;
+    int line;
+} test_group;
+
+typedef struct {
+    const char *name;
+    int passed;
+    double seconds;
+} test_result;
+
+struct test_group_run {
+    const test_group *group;
+    test_result *results;
+    size_t count;
+    size_t capacity;
+    size_t failed;
+    int started;
+    int out_of_memory;
+    double last;
+    double seconds;
+};
+
+// Groups handed to the pool; workers take the next one under the lock
+typedef struct {
+    test_group_run *runs;
+    size_t count;
+    size_t next;
+    int fail_fast;
+    int stop;
+    pthread_mutex_t lock;
+} test_queue;
+
+static test_group groups[MAX_GROUPS];
+static size_t group_count;
+
+// Defined by the mutant schemata (mutagen); absent from ordinary builds
+extern int mutation_active_id __attribute__((weak));
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void test_register(const char *name, test_group_fn run, const char *file, int line) {
+    if (group_count == MAX_GROUPS) {
+        fprintf(stderr, "test_runner: more than %d groups, %s dropped\n", MAX_GROUPS, name);
+        return;
+    }
+    groups[group_count++] = (test_group){name, run, file, line};
+}
+
+void test_record(test_group_run *run, const char *name, int passed) {
+    double now = now_seconds();
+
+    if (run->count == run->capacity) {
+        size_t capacity = run->capacity ? 2 * run->capacity : 32;
+        test_result *results = realloc(run->results, capacity * sizeof(*results));
+        if (results == NULL) {
+            run->out_of_memory = 1;
+            run->failed += !passed;
+            run->last = now;
+            return;
+        }
+        run->results = results;
+        run->capacity = capacity;
+    }
+    run->results[run->count++] = (test_result){name, passed, now - run->last};
+    run->failed += !passed;
+    run->last = now;
+}
+
+static int compare_groups(const void *a, const void *b) {
+    const test_group *ga = a, *gb = b;
+    int by_file = strcmp(ga->file, gb->file);
+    return by_file != 0 ? by_file : (ga->line > gb->line) - (ga->line < gb->line);
+}
+
+static void run_group(test_group_run *run) {
+    double started = now_seconds();
+
+    run->started = 1;
+    run->last = started;
+    run->group->run(run);
+    run->seconds = now_seconds() - started;
+}
+
+static void *work(void *arg) {
+    test_queue *queue = arg;
+
+    for (;;) {
+        test_group_run *run = NULL;
+
+        pthread_mutex_lock(&queue->lock);
+        if (!queue->stop && queue->next < queue->count) {
+            run = &queue->runs[queue->next++];
+        }
+        pthread_mutex_unlock(&queue->lock);
+        if (run == NULL) {
+            return NULL;
+        }
+
+        run_group(run);
+        if (queue->fail_fast && run->failed > 0) {
+            pthread_mutex_lock(&queue->lock);
+            queue->stop = 1;
+            pthread_mutex_unlock(&queue->lock);
+        }
+    }
+}
+
+// Runs the queued groups on `jobs` threads; the calling thread is one of them
+static void run_pool(test_queue *queue, size_t jobs) {
+    pthread_t threads[MAX_GROUPS];
+    size_t started = 0;
+
+    while (started + 1 < jobs && pthread_create(&threads[started], NULL, work, queue) == 0) {
+        started++;
+    }
+    work(queue);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+static size_t find_group(const char *name) {
+    size_t g = 0;
+    while (g < group_count && strcmp(name, groups[g].name) != 0) {
+        g++;
+    }
+    return g;
+}
+
+static int read_full(int fd, void *buf, size_t size) {
+    char *p = buf;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+static int write_full(int fd, const void *buf, size_t size) {
+    const char *p = buf;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+// Fork-server child: selects the mutant, arms the timeout and runs the
+// named groups (all of them when there are none) with --fail-fast
+static void run_request(const fork_server_request *request, const char *names) {
+    test_group_run runs[MAX_GROUPS];
+    size_t run_count = 0;
+    size_t failed = 0;
+
+    memset(runs, 0, sizeof(runs));
+    for (const char *name = names; name < names + request->names_size; name += strlen(name) + 1) {
+        size_t g = find_group(name);
+        if (g == group_count) {
+            _exit(2);
+        }
+        if (run_count < MAX_GROUPS) {
+            runs[run_count++].group = &groups[g];
+        }
+    }
+    if (run_count == 0) {
+        for (size_t g = 0; g < group_count; g++) {
+            runs[run_count++].group = &groups[g];
+        }
+    }
+
+    mutation_active_id = request->mutant_id;
+    struct itimerval timer = {{0, 0}, {request->timeout_us / 1000000, request->timeout_us % 1000000}};
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    test_queue queue = {runs, run_count, 0, 1, 0, PTHREAD_MUTEX_INITIALIZER};
+    run_pool(&queue, 1);
+    for (size_t g = 0; g < run_count; g++) {
+        failed += runs[g].failed;
+    }
+    _exit(failed == 0 ? 0 : 1);
+}
+
+// Serves fork_server_requests until the runner closes the control fd
+static int serve_forks(void) {
+    uint32_t hello = FORK_SERVER_HELLO;
+
+    if (&mutation_active_id == NULL) {
+        fprintf(stderr, "test_runner: --fork-server needs a mutant schemata build\n");
+        return 2;
+    }
+    if (write_full(FORK_SERVER_STATUS_FD, &hello, sizeof(hello)) != 0) {
+        return 2;
+    }
+    for (;;) {
+        fork_server_request request;
+        char names[FORK_SERVER_MAX_NAMES];
+
+        if (read_full(FORK_SERVER_CONTROL_FD, &request, sizeof(request)) != 0) {
+            return 0;
+        }
+        if (request.names_size > sizeof(names) ||
+            read_full(FORK_SERVER_CONTROL_FD, names, request.names_size) != 0 ||
+            (request.names_size > 0 && names[request.names_size - 1] != '\0')) {
+            return 2;
+        }
+
+        double started = now_seconds();
+        pid_t pid = fork();
+        if (pid < 0) {
+            return 2;
+        }
+        if (pid == 0) {
+            close(FORK_SERVER_CONTROL_FD);
+            close(FORK_SERVER_STATUS_FD);
+            run_request(&request, names);
+        }
+
+        int status;
+        while (waitpid(pid, &status, 0) < 0) {
+            if (errno != EINTR) {
+                return 2;
+            }
+        }
+        fork_server_reply reply = {pid, status, (uint32_t)((now_seconds() - started) * 1e6)};
+        if (write_full(FORK_SERVER_STATUS_FD, &reply, sizeof(reply)) != 0) {
+            return 2;
+        }
+    }
+}
+
+static void xml_escaped(FILE *out, const char *s) {
+    for (; *s; s++) {
+        switch (*s) {
+        case '<': fputs("&lt;", out); break;
+        case '>': fputs("&gt;", out); break;
+        case '&': fputs("&amp;", out); break;
+        case '"': fputs("&quot;", out); break;
+        default: fputc(*s, out); break;
+        }
+    }
+}
+
+static void json_escaped(FILE *out, const char *s) {
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', out);
+            fputc(*s, out);
+        } else if ((unsigned char)*s < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned char)*s);
+        } else {
+            fputc(*s, out);
+        }
+    }
+}
+
+static int write_junit(const char *path, const char *title, const test_group_run *runs,
+                       size_t count, size_t tests, size_t failed, double seconds) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    fprintf(out, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites name=\"");
+    xml_escaped(out, title);
+    fprintf(out, "\" tests=\"%zu\" failures=\"%zu\" time=\"%.6f\">\n", tests, failed, seconds);
+    for (size_t g = 0; g < count; g++) {
+        const test_group_run *run = &runs[g];
+        if (!run->started) {
+            continue;
+        }
+        fprintf(out, "  <testsuite name=\"%s\" tests=\"%zu\" failures=\"%zu\" time=\"%.6f\">\n",
+                run->group->name, run->count, run->failed, run->seconds);
+        for (size_t t = 0; t < run->count; t++) {
+            const test_result *r = &run->results[t];
+            fprintf(out, "    <testcase classname=\"%s\" name=\"", run->group->name);
+            xml_escaped(out, r->name);
+            fprintf(out, "\" time=\"%.6f\"%s\n", r->seconds, r->passed ? "/>" : ">");
+            if (!r->passed) {
+                fprintf(out, "      <failure message=\"condition is false\"/>\n    </testcase>\n");
+            }
+        }
+        fprintf(out, "  </testsuite>\n");
+    }
+    fprintf(out, "</testsuites>\n");
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+static int write_json(const char *path, const char *title, const test_group_run *runs,
+                      size_t count, size_t tests, size_t failed, double seconds,
+                      size_t shard_index, size_t shard_count) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    fprintf(out, "{\n  \"suite\": \"");
+    json_escaped(out, title);
+    fprintf(out, "\",\n  \"shard\": {\"index\": %zu, \"count\": %zu},\n", shard_index, shard_count);
+    fprintf(out, "  \"tests\": %zu,\n  \"passed\": %zu,\n  \"failed\": %zu,\n  \"seconds\": %.6f,\n",
+            tests, tests - failed, failed, seconds);
+    fprintf(out, "  \"groups\": [");
+    int first_group = 1;
+    for (size_t g = 0; g < count; g++) {
+        const test_group_run *run = &runs[g];
+        if (!run->started) {
+            continue;
+        }
+        fprintf(out, "%s\n    {\"name\": \"%s\", \"tests\": %zu, \"failed\": %zu, \"seconds\": %.6f, "
+                "\"cases\": [", first_group ? "" : ",", run->group->name, run->count, run->failed,
+                run->seconds);
+        first_group = 0;
+        for (size_t t = 0; t < run->count; t++) {
+            const test_result *r = &run->results[t];
+            fprintf(out, "%s\n      {\"name\": \"", t ? "," : "");
+            json_escaped(out, r->name);
+            fprintf(out, "\", \"passed\": %s, \"seconds\": %.9f}", r->passed ? "true" : "false",
+                    r->seconds);
+        }
+        fprintf(out, "%s]}", run->count ? "\n    " : "");
+    }
+    fprintf(out, "\n  ]\n}\n");
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+static int usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--list] [--fail-fast] [--verbose] [--jobs N] [--shard I/N]\n"
+            "          [--junit FILE] [--json FILE] [--fork-server] [GROUP...]\n", prog);
+    return 2;
+}
+
+int test_main(int argc, char **argv, const char *title) {
+    size_t selected[MAX_GROUPS];
+    size_t selected_count = 0;
+    int list = 0, fail_fast = 0, verbose = 0, fork_server = 0;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t jobs = cores > 0 ? (size_t)cores : 1;
+    size_t shard_index = 0, shard_count = 1;
+    const char *junit_path = NULL, *json_path = NULL;
+
+    qsort(groups, group_count, sizeof(*groups), compare_groups);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--list") == 0) {
+            list = 1;
+        } else if (strcmp(argv[i], "--fail-fast") == 0) {
+            fail_fast = 1;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = 1;
+        } else if (strcmp(argv[i], "--fork-server") == 0) {
+            fork_server = 1;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            long n = atol(argv[++i]);
+            if (n < 1) {
+                return usage(argv[0]);
+            }
+            jobs = (size_t)n;
+        } else if (strcmp(argv[i], "--shard") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%zu/%zu", &shard_index, &shard_count) != 2 ||
+                shard_count == 0 || shard_index >= shard_count) {
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--junit") == 0 && i + 1 < argc) {
+            junit_path = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (argv[i][0] == '-') {
+            return usage(argv[0]);
+        } else {
+            size_t g = find_group(argv[i]);
+            if (g == group_count) {
+                fprintf(stderr, "Unknown test group: %s\n", argv[i]);
+                return 2;
+            }
+            if (selected_count < MAX_GROUPS) {
+                selected[selected_count++] = g;
+            }
+        }
+    }
+    if (list) {
+        for (size_t g = 0; g < group_count; g++) {
+            if (verbose) {
+                printf("%s\t%s:%d\n", groups[g].name, groups[g].file, groups[g].line);
+            } else {
+                printf("%s\n", groups[g].name);
+            }
+        }
+        return 0;
+    }
+    if (fork_server) {
+        return serve_forks();
+    }
+    if (selected_count == 0) {
+        for (size_t g = 0; g < group_count; g++) {
+            selected[selected_count++] = g;
+        }
+    }
+
+    // Shard by position in the selected list, so every process of a
+    // sharded run sees the same list and takes every shard_count-th group
+    test_group_run runs[MAX_GROUPS];
+    size_t run_count = 0;
+    memset(runs, 0, sizeof(runs));
+    for (size_t i = shard_index; i < selected_count; i += shard_count) {
+        runs[run_count++].group = &groups[selected[i]];
+    }
+
+    if (jobs > run_count) {
+        jobs = run_count > 0 ? run_count : 1;
+    }
+    double started = now_seconds();
+    test_queue queue = {runs, run_count, 0, fail_fast, 0, PTHREAD_MUTEX_INITIALIZER};
+    run_pool(&queue, jobs);
+    double seconds = now_seconds() - started;
+
+    size_t tests = 0, failed = 0;
+    int status = 0;
+    for (size_t g = 0; g < run_count; g++) {
+        const test_group_run *run = &runs[g];
+        if (!run->started) {
+            continue;
+        }
+        tests += run->count;
+        failed += run->failed;
+        if (run->out_of_memory) {
+            fprintf(stderr, "test_runner: out of memory recording group %s\n", run->group->name);
+            status = 2;
+        }
+        if (verbose) {
+            printf("\n--- %s (%.3f ms) ---\n", run->group->name, run->seconds * 1e3);
+        }
+        for (size_t t = 0; t < run->count; t++) {
+            const test_result *r = &run->results[t];
+            if (verbose || !r->passed) {
+                printf("%s %s%s%s\n", r->passed ? "✓" : "✗", verbose ? "" : run->group->name,
+                       verbose ? "" : ": ", r->name);
+            }
+        }
+    }
+
+    if (junit_path != NULL &&
+        write_junit(junit_path, title, runs, run_count, tests, failed, seconds) != 0) {
+        status = 2;
+    }
+    if (json_path != NULL &&
+        write_json(json_path, title, runs, run_count, tests, failed, seconds, shard_index,
+                   shard_count) != 0) {
+        status = 2;
+    }
+    for (size_t g = 0; g < run_count; g++) {
+        free(runs[g].results);
+    }
+
+    printf("\n========================================\n");
+    printf("%s\n", title);
+    printf("========================================\n");
+    printf("Total Tests:  %zu\n", tests);
+    printf("Passed:       %zu\n", tests - failed);
+    printf("Failed:       %zu\n", failed);
+    printf("Pass Rate:    %.1f%%\n", tests > 0 ? 100.0 * (double)(tests - failed) / (double)tests : 0.0);
+    printf("Groups:       %zu", run_count);
+    if (shard_count > 1) {
+        printf(" (shard %zu/%zu)", shard_index, shard_count);
+    }
+    printf(", %zu job%s, %.3f ms\n", jobs, jobs == 1 ? "" : "s", seconds * 1e3);
+    printf("========================================\n");
+
+    if (status != 0) {
+        return status;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#ifndef TEST_RUNNER_H
+#define TEST_RUNNER_H
+
+// Registration-based test runner.
+//
+// TEST_GROUP(name) { ... } defines a test group and registers it before
+// main runs; each TEST(name, condition) inside it records one result with
+// its timing. Groups run on a thread pool and can be sharded across
+// processes; results go to JUnit XML or JSON files, and stdout only gets
+// failures and a summary. test_main parses the command line:
+//
+//   [--list] [--fail-fast] [--verbose] [--jobs N] [--shard I/N]
+//   [--junit FILE] [--json FILE] [--fork-server] [GROUP...]
+//
+// --list prints the group names; with --verbose, each followed by a tab and
+// the file:line of its TEST_GROUP.
+//
+// --fork-server turns a mutant schemata build into a fork server for
+// mutation_runner (see fork_server.h): it starts once and then forks a
+// child per mutant.
+//
+// Groups run concurrently, so a group must not change state another group
+// reads. The exceptions: the batch group's math_simd_force, which the
+// parallel group reads through the batch API but every SIMD level gives
+// identical results; and the parallel group's thread and chunk settings,
+// which nothing else reads.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct test_group_run test_group_run;
+
+typedef void (*test_group_fn)(test_group_run *test_run);
+
+// Adds a group; groups are listed and run in (file, line) order
+void test_register(const char *name, test_group_fn run, const char *file, int line);
+
+// Records one test. name must outlive the run (normally a string literal).
+// The test is charged the time since the previous test of its group, so
+// setup code counts toward the test that checks it.
+void test_record(test_group_run *run, const char *name, int passed);
+
+#define TEST_GROUP(group)                                                     \
+    static void test_group_##group(test_group_run *test_run);                 \
+    __attribute__((constructor)) static void test_register_##group(void) {    \
+        test_register(#group, test_group_##group, __FILE__, __LINE__);        \
+    }                                                                         \
+    static void test_group_##group(test_group_run *test_run)
+
+#define TEST(name, condition) test_record(test_run, (name), (condition) ? 1 : 0)
+
+// Runs the groups selected on the command line and prints the summary;
+// returns the process exit status (0 all passed, 1 failures, 2 usage or
+// I/O errors)
+int test_main(int argc, char **argv, const char *title);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // TEST_RUNNER_H
@@ -0,0 +1,268 @@
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "math_utils.hpp"
+#include "test_runner.h"
+
+// Tests of the C++ template layer (math_utils.hpp): the int instances
+// against the C functions, the other widths against exact arithmetic in a
+// wider type, and the std::span forms against the scalar templates.
+
+using math_utils::check;
+using math_utils::checked;
+using math_utils::saturate;
+
+// ============ Compile-time checks ============
+// Every scalar template is constexpr, and so is the portable path of the
+// span forms
+
+static_assert(math_utils::add(int8_t(100), int8_t(100)) == int8_t(-56));
+static_assert(math_utils::add<saturate>(int8_t(100), int8_t(100)) == INT8_MAX);
+static_assert(math_utils::add<saturate>(int8_t(-100), int8_t(-100)) == INT8_MIN);
+static_assert(math_utils::add<check>(int8_t(100), int8_t(27)) == checked<int8_t>{MATH_OK, 127});
+static_assert(!math_utils::add<check>(int8_t(100), int8_t(28)).ok());
+static_assert(math_utils::subtract<saturate>(uint8_t(3), uint8_t(5)) == 0);
+static_assert(math_utils::subtract(uint8_t(3), uint8_t(5)) == 254);
+static_assert(math_utils::multiply<saturate>(int16_t(-300), int16_t(300)) == INT16_MIN);
+static_assert(math_utils::multiply(uint16_t(65535), uint16_t(65535)) == 1);
+static_assert(math_utils::abs_value(INT64_MIN) == INT64_MIN);
+static_assert(math_utils::abs_value<saturate>(INT64_MIN) == INT64_MAX);
+static_assert(!math_utils::abs_value<check>(INT64_MIN).ok());
+static_assert(math_utils::abs_value<check>(uint32_t(UINT32_MAX)).value == UINT32_MAX);
+static_assert(math_utils::max_value(uint64_t(0), UINT64_MAX) == UINT64_MAX);
+static_assert(math_utils::min_value(int8_t(-1), int8_t(1)) == -1);
+static_assert(math_utils::is_even(int8_t(-128)) && !math_utils::is_positive(uint8_t(0)));
+static_assert(math_utils::factorial(12) == 479001600);
+
+#ifdef __SIZEOF_INT128__
+constexpr __int128 int128_max = __int128((~(unsigned __int128)0) >> 1);
+static_assert(math_utils::add<saturate>(int128_max, __int128(1)) == int128_max);
+static_assert(math_utils::multiply<check>(int128_max, __int128(2)).status == MATH_ERR_OVERFLOW);
+static_assert(math_utils::abs_value<saturate>(-int128_max - 1) == int128_max);
+#endif
+
+constexpr int constexpr_batch() {
+    std::array<int, 4> a = {1, INT_MAX, -3, INT_MIN};
+    std::array<int, 4> b = {2, 1, 4, -1};
+    std::array<int, 4> out{};
+    math_utils::add<saturate>(a, b, std::span<int>(out));
+    return out[0] + (out[1] == INT_MAX) + out[2] + (out[3] == INT_MIN)
+           + math_utils::max_reduce(std::span<const int>(a)) / INT_MAX;
+}
+static_assert(constexpr_batch() == 7);
+
+// ============ int against the C functions ============
+
+static const int int_values[] = {INT_MIN, INT_MIN + 1, -65536, -46341, -46340, -100, -2, -1,
+                                 0,       1,           2,      99,     46340,  46341, 65536,
+                                 INT_MAX - 1, INT_MAX};
+
+TEST_GROUP(templates_int) {
+    int agree[7] = {1, 1, 1, 1, 1, 1, 1};
+
+    for (int a : int_values) {
+        int out = 0;
+        agree[3] &= math_utils::abs_value(a) == abs_value(a);
+        agree[3] &= math_utils::abs_value<saturate>(a) == saturating_abs_value(a);
+        checked<int> r = math_utils::abs_value<check>(a);
+        agree[3] &= r.status == checked_abs_value(a, &out) && (!r.ok() || r.value == out);
+        agree[6] &= math_utils::is_even(a) == is_even(a) && math_utils::is_positive(a) == is_positive(a);
+
+        for (int b : int_values) {
+            agree[0] &= math_utils::add(a, b) == add(a, b);
+            agree[0] &= math_utils::add<saturate>(a, b) == saturating_add(a, b);
+            r = math_utils::add<check>(a, b);
+            agree[0] &= r.status == checked_add(a, b, &out) && (!r.ok() || r.value == out);
+
+            agree[1] &= math_utils::subtract(a, b) == subtract(a, b);
+            agree[1] &= math_utils::subtract<saturate>(a, b) == saturating_subtract(a, b);
+            r = math_utils::subtract<check>(a, b);
+            agree[1] &= r.status == checked_subtract(a, b, &out) && (!r.ok() || r.value == out);
+
+            agree[2] &= math_utils::multiply(a, b) == multiply(a, b);
+            agree[2] &= math_utils::multiply<saturate>(a, b) == saturating_multiply(a, b);
+            r = math_utils::multiply<check>(a, b);
+            agree[2] &= r.status == checked_multiply(a, b, &out) && (!r.ok() || r.value == out);
+
+            agree[4] &= math_utils::max_value(a, b) == max_value(a, b);
+            agree[5] &= math_utils::min_value(a, b) == min_value(a, b);
+        }
+    }
+    TEST("add<wrap/check/saturate> == add/checked_add/saturating_add", agree[0]);
+    TEST("subtract<...> == subtract/checked_subtract/saturating_subtract", agree[1]);
+    TEST("multiply<...> == multiply/checked_multiply/saturating_multiply", agree[2]);
+    TEST("abs_value<...> == abs_value/checked_abs_value/saturating_abs_value", agree[3]);
+    TEST("max_value == max_value", agree[4]);
+    TEST("min_value == min_value", agree[5]);
+    TEST("is_even/is_positive == is_even/is_positive", agree[6]);
+}
+
+// ============ Other widths against exact arithmetic ============
+
+// The three policies' results for an exact result held in a wider type
+template <class T>
+static bool matches_exact(T wrapped, checked<T> checked_result, T saturated, long long exact) {
+    long long lo = (long long)math_utils::detail::min_of<T>;
+    long long hi = (long long)math_utils::detail::max_of<T>;
+    bool fits = exact >= lo && exact <= hi;
+    return wrapped == (T)exact && checked_result.value == wrapped
+           && checked_result.ok() == fits
+           && saturated == (T)(exact < lo ? lo : exact > hi ? hi : exact);
+}
+
+// Every pair of values of an 8-bit type
+template <class T>
+static bool exhaustive_8bit() {
+    bool agree = true;
+    for (int a = math_utils::detail::min_of<T>; a <= math_utils::detail::max_of<T>; a++) {
+        T x = (T)a;
+        agree &= matches_exact(math_utils::abs_value(x), math_utils::abs_value<check>(x),
+                               math_utils::abs_value<saturate>(x), a < 0 ? -a : a);
+        agree &= math_utils::is_even(x) == (a % 2 == 0) && math_utils::is_positive(x) == (a > 0);
+        for (int b = math_utils::detail::min_of<T>; b <= math_utils::detail::max_of<T>; b++) {
+            T y = (T)b;
+            agree &= matches_exact(math_utils::add(x, y), math_utils::add<check>(x, y),
+                                   math_utils::add<saturate>(x, y), a + b);
+            agree &= matches_exact(math_utils::subtract(x, y), math_utils::subtract<check>(x, y),
+                                   math_utils::subtract<saturate>(x, y), a - b);
+            agree &= matches_exact(math_utils::multiply(x, y), math_utils::multiply<check>(x, y),
+                                   math_utils::multiply<saturate>(x, y), a * b);
+            agree &= math_utils::max_value(x, y) == (a > b ? x : y);
+            agree &= math_utils::min_value(x, y) == (a < b ? x : y);
+        }
+    }
+    return agree;
+}
+
+TEST_GROUP(templates_widths) {
+    TEST("int8_t: every pair matches exact arithmetic", exhaustive_8bit<int8_t>());
+    TEST("uint8_t: every pair matches exact arithmetic", exhaustive_8bit<uint8_t>());
+
+    bool agree = true;
+    for (int a = INT16_MIN; a <= INT16_MAX; a += 97) {
+        for (int b = INT16_MIN; b <= INT16_MAX; b += 89) {
+            int16_t x = (int16_t)a, y = (int16_t)b;
+            agree &= matches_exact(math_utils::multiply(x, y), math_utils::multiply<check>(x, y),
+                                   math_utils::multiply<saturate>(x, y), (long long)a * b);
+            agree &= matches_exact(math_utils::add(x, y), math_utils::add<check>(x, y),
+                                   math_utils::add<saturate>(x, y), a + b);
+        }
+    }
+    TEST("int16_t: sampled pairs match exact arithmetic", agree);
+
+    TEST("add<saturate>(INT64_MAX, 1) == INT64_MAX",
+         math_utils::add<saturate>(INT64_MAX, int64_t(1)) == INT64_MAX);
+    TEST("subtract<saturate>(INT64_MIN, 1) == INT64_MIN",
+         math_utils::subtract<saturate>(INT64_MIN, int64_t(1)) == INT64_MIN);
+    TEST("multiply<check>(2^32, 2^32) overflows in int64_t",
+         math_utils::multiply<check>(int64_t(1) << 32, int64_t(1) << 32).status == MATH_ERR_OVERFLOW);
+    TEST("multiply<check>(2^31, 2^31) fits in int64_t",
+         math_utils::multiply<check>(int64_t(1) << 31, int64_t(1) << 31)
+         == (checked<int64_t>{MATH_OK, int64_t(1) << 62}));
+    TEST("multiply<saturate>(UINT64_MAX, 2) == UINT64_MAX",
+         math_utils::multiply<saturate>(UINT64_MAX, uint64_t(2)) == UINT64_MAX);
+    TEST("add(UINT64_MAX, 1) wraps to 0", math_utils::add(UINT64_MAX, uint64_t(1)) == 0);
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 u128_max = ~(unsigned __int128)0;
+    TEST("multiply<saturate>(2^64, 2^64) saturates unsigned __int128",
+         math_utils::multiply<saturate>((unsigned __int128)1 << 64, (unsigned __int128)1 << 64)
+         == u128_max);
+    TEST("add<check>(2^127 - 1, 2^127) == 2^128 - 1",
+         math_utils::add<check>(u128_max >> 1, (u128_max >> 1) + 1)
+         == (checked<unsigned __int128>{MATH_OK, u128_max}));
+#endif
+}
+
+// ============ std::span forms ============
+#define BATCH_LEN 37  // Not a multiple of any vector width: exercises tails
+
+// Every span form against its scalar template over BATCH_LEN values
+template <class T>
+static bool batch_matches_scalar() {
+    std::vector<T> a(BATCH_LEN), b(BATCH_LEN), out(BATCH_LEN);
+    std::vector<int> flags(BATCH_LEN);
+    bool agree = true, overflow = false;
+
+    for (size_t i = 0; i < BATCH_LEN; i++) {
+        // Edges of the type first, then a spread of values
+        a[i] = i == 0 ? math_utils::detail::min_of<T> : i == 1 ? math_utils::detail::max_of<T>
+                                                      : T(i * 0x9E3779B97F4A7C15ULL >> 40);
+        b[i] = i % 3 == 0 ? T(-1) : T(i * 0xC2B2AE3D27D4EB4FULL >> 50);
+    }
+    std::span<T> o(out);
+
+    math_utils::add(a, b, o);
+    for (size_t i = 0; i < BATCH_LEN; i++) agree &= out[i] == math_utils::add(a[i], b[i]);
+    math_utils::add<saturate>(a, b, o);
+    for (size_t i = 0; i < BATCH_LEN; i++) agree &= out[i] == math_utils::add<saturate>(a[i], b[i]);
+    math_utils::subtract<saturate>(a, b, o);
+    for (size_t i = 0; i < BATCH_LEN; i++) {
+        agree &= out[i] == math_utils::subtract<saturate>(a[i], b[i]);
+    }
+    math_status status = math_utils::multiply<check>(a, b, o);
+    for (size_t i = 0; i < BATCH_LEN; i++) {
+        checked<T> r = math_utils::multiply<check>(a[i], b[i]);
+        agree &= out[i] == r.value;
+        overflow |= !r.ok();
+    }
+    agree &= status == (overflow ? MATH_ERR_OVERFLOW : MATH_OK);
+    math_utils::abs_value<saturate>(a, o);
+    for (size_t i = 0; i < BATCH_LEN; i++) agree &= out[i] == math_utils::abs_value<saturate>(a[i]);
+    math_utils::max_value(a, b, o);
+    for (size_t i = 0; i < BATCH_LEN; i++) agree &= out[i] == math_utils::max_value(a[i], b[i]);
+    math_utils::min_value(a, b, o);
+    for (size_t i = 0; i < BATCH_LEN; i++) agree &= out[i] == math_utils::min_value(a[i], b[i]);
+
+    std::span<const T> x(a);
+    math_utils::is_even(x, std::span<int>(flags));
+    for (size_t i = 0; i < BATCH_LEN; i++) agree &= flags[i] == math_utils::is_even(a[i]);
+    math_utils::is_positive(x, std::span<int>(flags));
+    for (size_t i = 0; i < BATCH_LEN; i++) agree &= flags[i] == math_utils::is_positive(a[i]);
+
+    T max = math_utils::detail::min_of<T>, min = math_utils::detail::max_of<T>;
+    size_t even = 0, positive = 0;
+    for (size_t i = 0; i < BATCH_LEN; i++) {
+        max = math_utils::max_value(max, a[i]);
+        min = math_utils::min_value(min, a[i]);
+        even += math_utils::is_even(a[i]);
+        positive += math_utils::is_positive(a[i]);
+    }
+    agree &= math_utils::max_reduce(x) == max && math_utils::min_reduce(x) == min;
+    agree &= math_utils::count_even(x) == even && math_utils::count_positive(x) == positive;
+
+    // Output aliasing an input
+    std::vector<T> expected(BATCH_LEN);
+    for (size_t i = 0; i < BATCH_LEN; i++) expected[i] = math_utils::subtract(a[i], b[i]);
+    math_utils::subtract(a, b, std::span<T>(a));
+    agree &= a == expected;
+    return agree;
+}
+
+TEST_GROUP(templates_batch) {
+    TEST("span forms match the scalar templates for int (C kernels)", batch_matches_scalar<int>());
+    TEST("... for int8_t", batch_matches_scalar<int8_t>());
+    TEST("... for uint16_t", batch_matches_scalar<uint16_t>());
+    TEST("... for int64_t", batch_matches_scalar<int64_t>());
+    TEST("... for uint64_t", batch_matches_scalar<uint64_t>());
+#ifdef __SIZEOF_INT128__
+    TEST("... for __int128", batch_matches_scalar<__int128>());
+#endif
+
+    int a[3] = {INT_MAX, 1, 2}, b[3] = {1, 1, 1}, out[3] = {0, 0, 0};
+    TEST("add<check> over int reports an overflow",
+         math_utils::add<check>(a, b, std::span<int>(out)) == MATH_ERR_OVERFLOW
+         && out[0] == INT_MIN && out[2] == 3);
+    TEST("add<check> without overflow is MATH_OK",
+         math_utils::add<check>(std::span<const int>(a + 1, 2), b, std::span<int>(out, 2)) == MATH_OK);
+    TEST("max_reduce of an empty span is INT64_MIN",
+         math_utils::max_reduce(std::span<const int64_t>()) == INT64_MIN);
+    TEST("min_reduce of an empty span is UINT8_MAX",
+         math_utils::min_reduce(std::span<const uint8_t>()) == UINT8_MAX);
+    TEST("max_reduce of an empty int span is INT_MIN", math_utils::max_reduce(std::span<const int>()) == INT_MIN);
+}
+
+int main(int argc, char **argv) {
+    return test_main(argc, argv, "C++ Template Layer Test Suite");
+}
@@ -0,0 +1,345 @@
+#include "exhaustive.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Blocks a worker takes from its own range per lock
+#define GRAB_BLOCKS 16
+
+#define DEFAULT_COUNTEREXAMPLES 16
+
+typedef enum {
+    SPACE_RANGE,        // x = lo + i
+    SPACE_PAIRS,        // (x, y) = (lo + i / width, lo + i % width)
+    SPACE_SAMPLED       // (x, y) = halves of splitmix64(seed + i)
+} space_kind;
+
+typedef struct {
+    space_kind kind;
+    int64_t lo;
+    uint64_t width;
+    uint64_t seed;
+    uint64_t total;     // number of inputs
+} input_space;
+
+// Failing input with its index in the space, for ordering
+typedef struct {
+    uint64_t index;
+    exhaustive_counterexample value;
+} failure;
+
+struct job;
+
+// Each worker owns the block range [next, end); idle workers steal the
+// upper half of the largest remaining range
+typedef struct {
+    struct job *job;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    uint64_t next;
+    uint64_t end;
+    uint64_t checked;
+    uint64_t failures;
+    failure *kept;      // smallest-index failures, sorted
+    size_t kept_count;
+    int error;
+} worker;
+
+typedef struct job {
+    const input_space *space;
+    exhaustive_predicate pred;
+    worker *workers;
+    size_t worker_count;
+    size_t keep;
+} job;
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static inline void fill_block(const input_space *space, uint64_t first, size_t n, int *x, int *y) {
+    switch (space->kind) {
+    case SPACE_RANGE: {
+        // Every x stays inside [lo, hi], so base + i cannot overflow
+        int base = (int)(space->lo + (int64_t)first);
+        EXHAUSTIVE_SIMD
+        for (size_t i = 0; i < n; i++) {
+            x[i] = base + (int)i;
+        }
+        break;
+    }
+    case SPACE_PAIRS: {
+        uint64_t row = first / space->width;
+        uint64_t col = first % space->width;
+        for (size_t i = 0; i < n; i++) {
+            x[i] = (int)(space->lo + (int64_t)row);
+            y[i] = (int)(space->lo + (int64_t)col);
+            if (++col == space->width) {
+                col = 0;
+                row++;
+            }
+        }
+        break;
+    }
+    case SPACE_SAMPLED:
+        for (size_t i = 0; i < n; i++) {
+            uint64_t r = splitmix64(space->seed + first + i);
+            x[i] = (int)(uint32_t)(r >> 32);
+            y[i] = (int)(uint32_t)r;
+        }
+        break;
+    }
+}
+
+// Keeps the job->keep failures with the smallest input index
+static void keep_failure(worker *w, uint64_t index, int x, int y) {
+    size_t keep = w->job->keep;
+    size_t k = w->kept_count;
+
+    if (k == keep && index > w->kept[k - 1].index) {
+        return;
+    }
+    if (k == keep) {
+        k--;
+    } else {
+        w->kept_count++;
+    }
+    while (k > 0 && w->kept[k - 1].index > index) {
+        w->kept[k] = w->kept[k - 1];
+        k--;
+    }
+    w->kept[k] = (failure){index, {x, y}};
+}
+
+EXHAUSTIVE_TARGETS
+static void check_block(worker *w, uint64_t block, int *x, int *y, unsigned char *fail) {
+    const input_space *space = w->job->space;
+    uint64_t first = block * EXHAUSTIVE_BLOCK;
+    size_t n = space->total - first < EXHAUSTIVE_BLOCK ? (size_t)(space->total - first)
+                                                       : EXHAUSTIVE_BLOCK;
+    int unary = space->kind == SPACE_RANGE;
+
+    fill_block(space, first, n, x, y);
+    w->job->pred(x, unary ? NULL : y, n, fail);
+    w->checked += n;
+
+    // Most blocks are clean: OR the flags together eight at a time
+    // before looking closer
+    uint64_t any = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        memcpy(&word, fail + i, sizeof(word));
+        any |= word;
+    }
+    for (; i < n; i++) {
+        any |= fail[i];
+    }
+    if (any == 0) {
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        if (fail[i]) {
+            w->failures++;
+            keep_failure(w, first + i, x[i], unary ? 0 : y[i]);
+        }
+    }
+}
+
+static int take_own(worker *w, uint64_t *first, uint64_t *last) {
+    int found = 0;
+
+    pthread_mutex_lock(&w->lock);
+    if (w->next < w->end) {
+        *first = w->next;
+        w->next = w->end - w->next > GRAB_BLOCKS ? w->next + GRAB_BLOCKS : w->end;
+        *last = w->next;
+        found = 1;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return found;
+}
+
+// Moves the upper half of the fullest other range into w's own range
+static int steal(worker *w) {
+    job *jb = w->job;
+
+    for (;;) {
+        worker *victim = NULL;
+        uint64_t most = 0;
+
+        for (size_t i = 0; i < jb->worker_count; i++) {
+            worker *other = &jb->workers[i];
+            if (other == w) {
+                continue;
+            }
+            pthread_mutex_lock(&other->lock);
+            uint64_t remaining = other->end - other->next;
+            pthread_mutex_unlock(&other->lock);
+            if (remaining > most) {
+                most = remaining;
+                victim = other;
+            }
+        }
+        if (victim == NULL) {
+            return 0;
+        }
+
+        uint64_t first = 0, last = 0;
+        pthread_mutex_lock(&victim->lock);
+        if (victim->end > victim->next) {
+            first = victim->next + (victim->end - victim->next) / 2;
+            last = victim->end;
+            victim->end = first;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (first < last) {
+            pthread_mutex_lock(&w->lock);
+            w->next = first;
+            w->end = last;
+            pthread_mutex_unlock(&w->lock);
+            return 1;
+        }
+    }
+}
+
+static void *work(void *arg) {
+    worker *w = arg;
+    int *x = malloc(2 * EXHAUSTIVE_BLOCK * sizeof(*x));
+    unsigned char *fail = malloc(EXHAUSTIVE_BLOCK);
+    uint64_t first, last;
+
+    if (x == NULL || fail == NULL) {
+        w->error = 1;
+    } else {
+        do {
+            while (take_own(w, &first, &last)) {
+                for (uint64_t block = first; block < last; block++) {
+                    check_block(w, block, x, x + EXHAUSTIVE_BLOCK, fail);
+                }
+            }
+        } while (steal(w));
+    }
+    free(fail);
+    free(x);
+    return NULL;
+}
+
+static int compare_failures(const void *a, const void *b) {
+    uint64_t ia = ((const failure *)a)->index;
+    uint64_t ib = ((const failure *)b)->index;
+    return (ia > ib) - (ia < ib);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int run_space(exhaustive_run *run, exhaustive_predicate pred, const input_space *space) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = run->threads ? run->threads : (cores > 0 ? (size_t)cores : 1);
+    size_t keep = run->max_counterexamples ? run->max_counterexamples : DEFAULT_COUNTEREXAMPLES;
+    uint64_t blocks = (space->total + EXHAUSTIVE_BLOCK - 1) / EXHAUSTIVE_BLOCK;
+    double started = now_seconds();
+    int status = 0;
+
+    if (threads > blocks) {
+        threads = blocks > 0 ? (size_t)blocks : 1;
+    }
+    run->checked = 0;
+    run->failures = 0;
+    run->counterexamples = NULL;
+    run->counterexample_count = 0;
+
+    job jb = {space, pred, calloc(threads, sizeof(worker)), threads, keep};
+    failure *all = malloc(threads * keep * sizeof(*all));
+    if (jb.workers == NULL || all == NULL) {
+        free(jb.workers);
+        free(all);
+        return -1;
+    }
+
+    for (size_t i = 0; i < threads; i++) {
+        worker *w = &jb.workers[i];
+        w->job = &jb;
+        w->next = blocks * i / threads;
+        w->end = blocks * (i + 1) / threads;
+        w->kept = all + i * keep;
+        pthread_mutex_init(&w->lock, NULL);
+    }
+
+    // The calling thread is worker 0
+    size_t started_threads = 1;
+    while (started_threads < threads &&
+           pthread_create(&jb.workers[started_threads].thread, NULL, work,
+                          &jb.workers[started_threads]) == 0) {
+        started_threads++;
+    }
+    work(&jb.workers[0]);
+    for (size_t i = 1; i < started_threads; i++) {
+        pthread_join(jb.workers[i].thread, NULL);
+    }
+    // Blocks of workers that failed to start were stolen by the others
+
+    size_t found = 0;
+    for (size_t i = 0; i < threads; i++) {
+        worker *w = &jb.workers[i];
+        run->checked += w->checked;
+        run->failures += w->failures;
+        status |= w->error;
+        memmove(all + found, w->kept, w->kept_count * sizeof(*all));
+        found += w->kept_count;
+        pthread_mutex_destroy(&w->lock);
+    }
+    qsort(all, found, sizeof(*all), compare_failures);
+
+    run->counterexample_count = found < keep ? found : keep;
+    run->counterexamples = malloc((run->counterexample_count + 1) * sizeof(*run->counterexamples));
+    if (run->counterexamples == NULL) {
+        status = 1;
+    } else {
+        for (size_t i = 0; i < run->counterexample_count; i++) {
+            run->counterexamples[i] = all[i].value;
+        }
+    }
+    run->seconds = now_seconds() - started;
+
+    free(all);
+    free(jb.workers);
+    if (status != 0 || run->checked != space->total) {
+        return -1;
+    }
+    return run->failures == 0 ? 0 : 1;
+}
+
+int exhaustive_unary(exhaustive_run *run, exhaustive_predicate pred, int lo, int hi) {
+    input_space space = {SPACE_RANGE, lo, 0, 0, (uint64_t)((int64_t)hi - lo + 1)};
+    return hi < lo ? -1 : run_space(run, pred, &space);
+}
+
+int exhaustive_pairs(exhaustive_run *run, exhaustive_predicate pred, int lo, int hi) {
+    uint64_t width = (uint64_t)((int64_t)hi - lo + 1);
+    input_space space = {SPACE_PAIRS, lo, width, 0, width * width};
+    return hi < lo || width > UINT32_MAX ? -1 : run_space(run, pred, &space);
+}
+
+int exhaustive_sampled_pairs(exhaustive_run *run, exhaustive_predicate pred,
+                             uint64_t samples, uint64_t seed) {
+    input_space space = {SPACE_SAMPLED, 0, 0, seed, samples};
+    return run_space(run, pred, &space);
+}
+
+void exhaustive_run_free(exhaustive_run *run) {
+    free(run->counterexamples);
+    run->counterexamples = NULL;
+    run->counterexample_count = 0;
+}
@@ -0,0 +1,71 @@
+#ifndef EXHAUSTIVE_H
+#define EXHAUSTIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Exhaustive and large-sample property checking.
+//
+// The input space is cut into blocks of EXHAUSTIVE_BLOCK inputs, spread
+// over worker threads that steal work from each other once their own
+// share runs out. A predicate checks a whole block at a time and flags
+// the failing elements, so its loop can be vectorized (see
+// EXHAUSTIVE_SIMD). Failures are counted and collected, never aborted on.
+
+#define EXHAUSTIVE_BLOCK 4096
+
+// Marks a predicate loop for vectorization (needs -fopenmp-simd)
+#define EXHAUSTIVE_SIMD _Pragma("omp simd")
+
+// Compiles a predicate once per vector ISA; the widest one the CPU
+// supports is picked at load time
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define EXHAUSTIVE_TARGETS __attribute__((target_clones("arch=skylake-avx512", "avx2", "default")))
+#else
+#define EXHAUSTIVE_TARGETS
+#endif
+
+// Sets fail[i] nonzero for every i < n where the property does not hold
+// for x[i] (and y[i]; y is NULL for unary properties). n <= EXHAUSTIVE_BLOCK.
+typedef void (*exhaustive_predicate)(const int *x, const int *y, size_t n, unsigned char *fail);
+
+typedef struct {
+    int x;
+    int y;
+} exhaustive_counterexample;
+
+typedef struct {
+    // Configuration
+    size_t threads;                 // 0 = one per online core
+    size_t max_counterexamples;     // failing inputs to keep (0 = 16)
+
+    // Results
+    uint64_t checked;
+    uint64_t failures;
+    exhaustive_counterexample *counterexamples;  // the first failures, in input order
+    size_t counterexample_count;
+    double seconds;
+} exhaustive_run;
+
+// Checks pred(x) for every x in [lo, hi]; [INT_MIN, INT_MAX] is the whole
+// domain (2^32 inputs). Returns 0 when the property held everywhere, 1
+// when it failed, -1 on allocation or thread errors.
+int exhaustive_unary(exhaustive_run *run, exhaustive_predicate pred, int lo, int hi);
+
+// Checks pred(x, y) for every pair in [lo, hi] x [lo, hi]
+int exhaustive_pairs(exhaustive_run *run, exhaustive_predicate pred, int lo, int hi);
+
+// Checks pred(x, y) for samples pairs drawn from the full int x int space.
+// Pair i is a pure function of (seed, i), so the pairs checked (and the
+// counterexamples found) do not depend on the thread count.
+int exhaustive_sampled_pairs(exhaustive_run *run, exhaustive_predicate pred,
+                             uint64_t samples, uint64_t seed);
+
+// Releases the counterexamples of a finished run
+void exhaustive_run_free(exhaustive_run *run);
+
+// Full-domain and sampled properties of math_utils (exhaustive_properties.c);
+// returns the number of failed properties
+int run_exhaustive_properties(void);
+
+#endif // EXHAUSTIVE_H
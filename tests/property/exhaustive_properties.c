@@ -0,0 +1,182 @@
+// Full-domain and large-sample properties of math_utils, checked by the
+// exhaustive engine. Built against the header-only inline definitions so
+// each predicate loop inlines the function under test and vectorizes.
+#ifndef MATH_UTILS_INLINE
+#define MATH_UTILS_INLINE
+#endif
+#include "math_utils.h"
+#include "exhaustive.h"
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SAMPLED_PAIRS (1u << 24)
+#define SAMPLE_SEED 0x5eed0fa11ULL
+
+// The unary sweeps cover the 2^bits ints around 0 and the sampled runs at
+// most 2^bits pairs; EXHAUSTIVE_BITS in the environment lowers bits for a
+// bounded run (the PGO training workload)
+#define DOMAIN_BITS 32
+
+// Small enough that add/subtract/multiply cannot overflow
+#define PAIR_LO (-2048)
+#define PAIR_HI 2047
+
+static int clamp64(int64_t v) {
+    return v > INT_MAX ? INT_MAX : v < INT_MIN ? INT_MIN : (int)v;
+}
+
+// |x| with INT_MIN wrapping to itself, without signed overflow
+static int wrapped_abs(int x) {
+    unsigned u = (unsigned)x;
+    return (int)(x < 0 ? 0u - u : u);
+}
+
+// ============ Unary, every int ============
+// Each oracle is written differently from the implementation it checks, so
+// a sweep cannot pass merely by restating the code under test.
+
+EXHAUSTIVE_TARGETS
+static void abs_value_matches(const int *x, const int *y, size_t n, unsigned char *fail) {
+    (void)y;
+    EXHAUSTIVE_SIMD
+    for (size_t i = 0; i < n; i++) {
+        // Every input, INT_MIN included: it wraps to itself
+        fail[i] = abs_value(x[i]) != wrapped_abs(x[i]);
+    }
+}
+
+EXHAUSTIVE_TARGETS
+static void is_even_matches(const int *x, const int *y, size_t n, unsigned char *fail) {
+    (void)y;
+    EXHAUSTIVE_SIMD
+    for (size_t i = 0; i < n; i++) {
+        fail[i] = is_even(x[i]) != (x[i] % 2 == 0);
+    }
+}
+
+EXHAUSTIVE_TARGETS
+static void is_positive_matches(const int *x, const int *y, size_t n, unsigned char *fail) {
+    (void)y;
+    EXHAUSTIVE_SIMD
+    for (size_t i = 0; i < n; i++) {
+        fail[i] = is_positive(x[i]) != (x[i] >= 1);
+    }
+}
+
+EXHAUSTIVE_TARGETS
+static void saturating_abs_matches(const int *x, const int *y, size_t n, unsigned char *fail) {
+    (void)y;
+    EXHAUSTIVE_SIMD
+    for (size_t i = 0; i < n; i++) {
+        int expected = x[i] == INT_MIN ? INT_MAX : wrapped_abs(x[i]);
+        fail[i] = saturating_abs_value(x[i]) != expected;
+    }
+}
+
+// ============ Pairs, every pair in [PAIR_LO, PAIR_HI]^2 ============
+
+EXHAUSTIVE_TARGETS
+static void arithmetic_matches(const int *x, const int *y, size_t n, unsigned char *fail) {
+    EXHAUSTIVE_SIMD
+    for (size_t i = 0; i < n; i++) {
+        fail[i] = add(x[i], y[i]) != x[i] + y[i] ||
+                  subtract(x[i], y[i]) != x[i] - y[i] ||
+                  multiply(x[i], y[i]) != x[i] * y[i] ||
+                  add(x[i], y[i]) != add(y[i], x[i]) ||
+                  multiply(x[i], y[i]) != multiply(y[i], x[i]);
+    }
+}
+
+// ============ Pairs, sampled from the full int x int space ============
+
+EXHAUSTIVE_TARGETS
+static void min_max_bounds(const int *x, const int *y, size_t n, unsigned char *fail) {
+    EXHAUSTIVE_SIMD
+    for (size_t i = 0; i < n; i++) {
+        int hi = max_value(x[i], y[i]);
+        int lo = min_value(x[i], y[i]);
+        fail[i] = hi < x[i] || hi < y[i] || lo > x[i] || lo > y[i] ||
+                  (hi != x[i] && hi != y[i]) || (lo != x[i] && lo != y[i]);
+    }
+}
+
+EXHAUSTIVE_TARGETS
+static void saturating_matches(const int *x, const int *y, size_t n, unsigned char *fail) {
+    for (size_t i = 0; i < n; i++) {
+        int64_t a = x[i], b = y[i];
+        fail[i] = saturating_add(x[i], y[i]) != clamp64(a + b) ||
+                  saturating_subtract(x[i], y[i]) != clamp64(a - b) ||
+                  saturating_multiply(x[i], y[i]) != clamp64(a * b);
+    }
+}
+
+static int domain_bits(void) {
+    const char *env = getenv("EXHAUSTIVE_BITS");
+    char *end;
+
+    if (env != NULL && *env != '\0') {
+        long bits = strtol(env, &end, 10);
+        if (*end == '\0' && bits >= 1 && bits <= DOMAIN_BITS) {
+            return (int)bits;
+        }
+        fprintf(stderr, "exhaustive: ignoring EXHAUSTIVE_BITS '%s' (not 1..%d)\n", env,
+                DOMAIN_BITS);
+    }
+    return DOMAIN_BITS;
+}
+
+static int report(const char *name, exhaustive_run *run, int status) {
+    if (status < 0) {
+        printf("✗ %s: engine error\n", name);
+        return 1;
+    }
+    if (status == 0) {
+        printf("✓ %s holds for all %" PRIu64 " inputs (%.2f s)\n", name, run->checked,
+               run->seconds);
+    } else {
+        printf("✗ %s: %" PRIu64 " of %" PRIu64 " inputs fail, e.g.", name, run->failures,
+               run->checked);
+        for (size_t i = 0; i < run->counterexample_count && i < 4; i++) {
+            printf(" (%d, %d)", run->counterexamples[i].x, run->counterexamples[i].y);
+        }
+        printf("\n");
+    }
+    exhaustive_run_free(run);
+    return status != 0;
+}
+
+int run_exhaustive_properties(void) {
+    exhaustive_run run = {0};
+    int failed = 0;
+    int bits = domain_bits();
+    int lo = bits == DOMAIN_BITS ? INT_MIN : -(1 << (bits - 1));
+    int hi = bits == DOMAIN_BITS ? INT_MAX : (1 << (bits - 1)) - 1;
+    uint64_t samples = bits < 24 ? (uint64_t)1 << bits : SAMPLED_PAIRS;
+
+    printf("=== Exhaustive properties ===\n");
+
+    printf("Testing unary functions over all 2^%d ints in [%d, %d]\n", bits, lo, hi);
+    failed += report("abs_value(x) == |x|, INT_MIN wrapping to itself", &run,
+                     exhaustive_unary(&run, abs_value_matches, lo, hi));
+    failed += report("is_even(x) == (x % 2 == 0)", &run,
+                     exhaustive_unary(&run, is_even_matches, lo, hi));
+    failed += report("is_positive(x) == (x >= 1)", &run,
+                     exhaustive_unary(&run, is_positive_matches, lo, hi));
+    failed += report("saturating_abs_value(x) == clamp(|x|)", &run,
+                     exhaustive_unary(&run, saturating_abs_matches, lo, hi));
+
+    printf("Testing add/subtract/multiply over all pairs in [%d, %d]^2\n", PAIR_LO, PAIR_HI);
+    failed += report("exact, commutative arithmetic", &run,
+                     exhaustive_pairs(&run, arithmetic_matches, PAIR_LO, PAIR_HI));
+
+    printf("Testing %" PRIu64 " pairs sampled from the full int x int space\n", samples);
+    failed += report("min/max bounds", &run,
+                     exhaustive_sampled_pairs(&run, min_max_bounds, samples, SAMPLE_SEED));
+    failed += report("saturating arithmetic == clamp(exact)", &run,
+                     exhaustive_sampled_pairs(&run, saturating_matches, samples, SAMPLE_SEED));
+    printf("\n");
+    return failed;
+}
@@ -0,0 +1,402 @@
+#include "prop.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Trials generated and checked together in batched mode
+#define PROP_BATCH 1024
+
+// Accepted shrinks before giving up on a smaller counterexample
+#define PROP_MAX_SHRINKS 4096
+
+#define DEFAULT_SEED 0x5eedULL
+
+// prop_int draws a mode in [0, MODES): the low modes pick an offset from
+// the whole range, then a small offset, then an edge value. Shrinking
+// lowers the mode first, so every value ends up as an offset and shrinks
+// toward the origin the same way.
+#define MODES 16
+#define SMALL_MODE 8
+#define EDGE_MODE 12
+#define SMALL_SPAN 256
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+void prop_source_init(prop_source *src, uint64_t seed, uint64_t trial) {
+    // Mixing the trial index keeps neighbouring streams from overlapping
+    src->state = splitmix64(seed ^ splitmix64(trial));
+    src->count = 0;
+    src->pos = 0;
+    src->replay = 0;
+}
+
+uint64_t prop_draw(prop_source *src, uint64_t bound) {
+    uint64_t v;
+
+    if (src->replay) {
+        // Past the recorded choices everything is 0, the simplest choice
+        v = src->pos < src->count ? src->choices[src->pos] : 0;
+    } else {
+        src->state += 0x9e3779b97f4a7c15ULL;
+        v = splitmix64(src->state);
+    }
+    if (bound != 0) {
+        v %= bound;
+    }
+    if (src->pos < PROP_MAX_CHOICES) {
+        src->choices[src->pos] = v;
+    }
+    src->pos++;
+    return v;
+}
+
+// The d-th simplest value around origin: origin, origin + 1, origin - 1,
+// origin + 2, ... and past the nearer bound, straight on along the far side
+static int64_t nth_simplest(int64_t origin, uint64_t below, uint64_t above, uint64_t d) {
+    uint64_t near = below < above ? below : above;
+
+    if (d <= 2 * near) {
+        return (d & 1) ? origin + (int64_t)((d + 1) / 2) : origin - (int64_t)(d / 2);
+    }
+    d -= near;
+    return above > below ? origin + (int64_t)d : origin - (int64_t)d;
+}
+
+// Inverse of nth_simplest
+static uint64_t simplest_index(int64_t origin, uint64_t below, uint64_t above, int64_t x) {
+    uint64_t near = below < above ? below : above;
+    uint64_t dist = (uint64_t)(x >= origin ? x - origin : origin - x);
+
+    if (dist <= near) {
+        return x > origin ? 2 * dist - 1 : 2 * dist;
+    }
+    return dist + near;
+}
+
+static int64_t range_origin(prop_range range) {
+    return range.lo > 0 ? range.lo : range.hi < 0 ? range.hi : 0;
+}
+
+int prop_int(prop_source *src, prop_range range) {
+    int64_t lo = range.lo, hi = range.hi;
+    int64_t origin = range_origin(range);
+    uint64_t span = (uint64_t)(hi - lo);
+    uint64_t mode = prop_draw(src, MODES);
+    uint64_t d;
+
+    if (mode >= EDGE_MODE) {
+        int64_t candidates[] = {origin, lo, hi, -1, 1, 0, INT_MIN, INT_MAX, lo + 1, hi - 1};
+        int64_t edges[sizeof(candidates) / sizeof(candidates[0])];
+        size_t count = 0;
+
+        for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+            if (candidates[i] >= lo && candidates[i] <= hi) {
+                edges[count++] = candidates[i];
+            }
+        }
+        return (int)edges[prop_draw(src, count)];
+    }
+    if (mode >= SMALL_MODE && span >= SMALL_SPAN) {
+        d = prop_draw(src, SMALL_SPAN);
+    } else {
+        d = prop_draw(src, span + 1);
+    }
+    return (int)nth_simplest(origin, (uint64_t)(origin - lo), (uint64_t)(hi - origin), d);
+}
+
+static void generate(const prop_property *p, prop_source *src, int *args) {
+    for (size_t k = 0; k < p->arity; k++) {
+        src->arg_start[k] = src->pos;
+        args[k] = prop_int(src, p->args[k]);
+    }
+    if (!src->replay) {
+        src->count = src->pos < PROP_MAX_CHOICES ? src->pos : PROP_MAX_CHOICES;
+    }
+}
+
+static int holds_once(const prop_property *p, const int *args) {
+    if (p->holds != NULL) {
+        return p->holds(args) != 0;
+    }
+
+    const int *columns[PROP_MAX_ARGS];
+    unsigned char fail = 0;
+    for (size_t k = 0; k < p->arity; k++) {
+        columns[k] = &args[k];
+    }
+    p->holds_n(columns, 1, &fail);
+    return !fail;
+}
+
+// Replays choices through the generators. Returns 1 when the property
+// still fails; src then holds the choices the generators actually used.
+static int replay_fails(const prop_property *p, const uint64_t *choices, size_t count,
+                        prop_source *src, int *args) {
+    memcpy(src->choices, choices, count * sizeof(*choices));
+    src->count = count;
+    src->pos = 0;
+    src->replay = 1;
+    generate(p, src, args);
+    src->count = src->pos < PROP_MAX_CHOICES ? src->pos : PROP_MAX_CHOICES;
+    return !holds_once(p, args);
+}
+
+// Shortlex order on choice sequences; every accepted shrink moves down it,
+// so shrinking terminates
+static int simpler(const prop_source *a, const prop_source *b) {
+    if (a->count != b->count) {
+        return a->count < b->count;
+    }
+    for (size_t i = 0; i < a->count; i++) {
+        if (a->choices[i] != b->choices[i]) {
+            return a->choices[i] < b->choices[i];
+        }
+    }
+    return 0;
+}
+
+// Rewrites each argument drawn as an edge or small value into the same
+// value drawn as an offset (mode 0), which the choice search below can
+// then lower one step at a time. Returns the number of rewrites kept.
+static size_t flatten(const prop_property *p, prop_source *best, int *args) {
+    size_t steps = 0;
+
+    for (size_t k = 0; k < p->arity; k++) {
+        size_t at = best->arg_start[k];
+        prop_range range = p->args[k];
+        int64_t origin = range_origin(range);
+        uint64_t choices[PROP_MAX_CHOICES];
+        prop_source candidate;
+        int candidate_args[PROP_MAX_ARGS];
+
+        if (at + 1 >= best->count || best->choices[at] == 0) {
+            continue;
+        }
+        memcpy(choices, best->choices, best->count * sizeof(*choices));
+        choices[at] = 0;
+        choices[at + 1] = simplest_index(origin, (uint64_t)(origin - range.lo),
+                                         (uint64_t)(range.hi - origin), args[k]);
+        if (replay_fails(p, choices, best->count, &candidate, candidate_args) &&
+            simpler(&candidate, best)) {
+            *best = candidate;
+            memcpy(args, candidate_args, sizeof(candidate_args));
+            steps++;
+        }
+    }
+    return steps;
+}
+
+// Moves the size of a counterexample from an earlier argument to a later
+// one: argument i becomes its simplest value and argument j its farthest.
+// Lowering one argument at a time cannot get out of minima such as
+// (924, -76) for "a - b < 1000"; after this, j shrinks alone to (0, 1000).
+static size_t redistribute(const prop_property *p, prop_source *best, int *args) {
+    size_t steps = 0;
+
+    for (size_t i = 0; i < p->arity; i++) {
+        for (size_t j = i + 1; j < p->arity; j++) {
+            size_t ai = best->arg_start[i], aj = best->arg_start[j];
+            uint64_t choices[PROP_MAX_CHOICES];
+            prop_source candidate;
+            int candidate_args[PROP_MAX_ARGS];
+
+            if (aj + 1 >= best->count || (best->choices[ai] == 0 && best->choices[ai + 1] == 0)) {
+                continue;
+            }
+            memcpy(choices, best->choices, best->count * sizeof(*choices));
+            choices[ai] = 0;
+            choices[ai + 1] = 0;
+            choices[aj] = 0;
+            choices[aj + 1] = (uint64_t)((int64_t)p->args[j].hi - p->args[j].lo);
+            if (replay_fails(p, choices, best->count, &candidate, candidate_args) &&
+                simpler(&candidate, best)) {
+                *best = candidate;
+                memcpy(args, candidate_args, sizeof(candidate_args));
+                steps++;
+            }
+        }
+    }
+    return steps;
+}
+
+// Lowers each choice as far as it goes (binary search for the smallest
+// value that still fails) until a whole pass changes nothing
+static size_t shrink(const prop_property *p, prop_source *best, int *args) {
+    size_t steps = 0;
+    int improved = 1;
+
+    while (improved && steps < PROP_MAX_SHRINKS) {
+        improved = 0;
+        steps += flatten(p, best, args);
+        if (redistribute(p, best, args) > 0) {
+            steps++;
+            improved = 1;
+        }
+        for (size_t i = 0; i < best->count && steps < PROP_MAX_SHRINKS; i++) {
+            uint64_t lo = 0, hi = best->choices[i];
+
+            while (lo < hi) {
+                uint64_t mid = lo + (hi - lo) / 2;
+                uint64_t choices[PROP_MAX_CHOICES];
+                prop_source candidate;
+                int candidate_args[PROP_MAX_ARGS];
+
+                memcpy(choices, best->choices, best->count * sizeof(*choices));
+                choices[i] = mid;
+                if (replay_fails(p, choices, best->count, &candidate, candidate_args) &&
+                    simpler(&candidate, best)) {
+                    *best = candidate;
+                    memcpy(args, candidate_args, sizeof(candidate_args));
+                    steps++;
+                    improved = 1;
+                    if (i >= best->count) {
+                        break;
+                    }
+                    hi = best->choices[i] < mid ? best->choices[i] : mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+        }
+    }
+    return steps;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Index of the first failing trial, or cfg->trials
+static uint64_t run_scalar(const prop_property *p, const prop_config *cfg, prop_result *res) {
+    prop_source src;
+    int args[PROP_MAX_ARGS];
+
+    for (uint64_t t = 0; t < cfg->trials; t++) {
+        prop_source_init(&src, cfg->seed, t);
+        generate(p, &src, args);
+        res->trials_run++;
+        if (!p->holds(args)) {
+            return t;
+        }
+    }
+    return cfg->trials;
+}
+
+static uint64_t run_batched(const prop_property *p, const prop_config *cfg, prop_result *res) {
+    int columns[PROP_MAX_ARGS][PROP_BATCH];
+    const int *column_ptrs[PROP_MAX_ARGS];
+    unsigned char fail[PROP_BATCH];
+    prop_source src;
+    int args[PROP_MAX_ARGS];
+
+    for (size_t k = 0; k < PROP_MAX_ARGS; k++) {
+        column_ptrs[k] = columns[k];
+    }
+    for (uint64_t first = 0; first < cfg->trials; first += PROP_BATCH) {
+        size_t n = cfg->trials - first < PROP_BATCH ? (size_t)(cfg->trials - first) : PROP_BATCH;
+
+        for (size_t i = 0; i < n; i++) {
+            prop_source_init(&src, cfg->seed, first + i);
+            generate(p, &src, args);
+            for (size_t k = 0; k < p->arity; k++) {
+                columns[k][i] = args[k];
+            }
+        }
+        memset(fail, 0, n);
+        p->holds_n(column_ptrs, n, fail);
+        for (size_t i = 0; i < n; i++) {
+            if (fail[i]) {
+                res->trials_run += i + 1;
+                return first + i;
+            }
+        }
+        res->trials_run += n;
+    }
+    return cfg->trials;
+}
+
+int prop_check(const prop_property *p, const prop_config *cfg, prop_result *res) {
+    double started = now_seconds();
+    uint64_t failing;
+
+    memset(res, 0, sizeof(*res));
+    if (p->arity > PROP_MAX_ARGS || (p->holds == NULL && p->holds_n == NULL)) {
+        return -1;
+    }
+
+    if (p->holds_n != NULL && (cfg->batched || p->holds == NULL)) {
+        failing = run_batched(p, cfg, res);
+    } else {
+        failing = run_scalar(p, cfg, res);
+    }
+
+    if (failing < cfg->trials) {
+        // Regenerate the failing trial from its own stream to get its choices
+        prop_source src;
+        int args[PROP_MAX_ARGS] = {0};
+
+        prop_source_init(&src, cfg->seed, failing);
+        generate(p, &src, args);
+        res->failed = 1;
+        res->failing_trial = failing;
+        memcpy(res->original, args, sizeof(args));
+        res->shrink_steps = shrink(p, &src, args);
+        memcpy(res->shrunk, args, sizeof(args));
+    }
+    res->seconds = now_seconds() - started;
+    return res->failed;
+}
+
+static void print_args(const int *args, size_t arity) {
+    printf("(");
+    for (size_t k = 0; k < arity; k++) {
+        printf(k ? ", %d" : "%d", args[k]);
+    }
+    printf(")");
+}
+
+int prop_report(const prop_property *p, const prop_config *cfg, const prop_result *res) {
+    if (!res->failed) {
+        double ms = res->seconds * 1e3;
+        printf("✓ %s: %zu trials", p->name, res->trials_run);
+        if (ms > 0) {
+            printf(" (%.0f trials/ms%s)", (double)res->trials_run / ms,
+                   p->holds_n != NULL && (cfg->batched || p->holds == NULL) ? ", batched" : "");
+        }
+        printf("\n");
+        return 0;
+    }
+
+    printf("✗ %s: falsified by ", p->name);
+    print_args(res->shrunk, p->arity);
+    printf(", shrunk from ");
+    print_args(res->original, p->arity);
+    printf(" in %zu steps\n", res->shrink_steps);
+    printf("  trial %" PRIu64 " of seed 0x%" PRIx64 "; replay with PROP_SEED=0x%" PRIx64 "\n",
+           res->failing_trial, cfg->seed, cfg->seed);
+    return 1;
+}
+
+uint64_t prop_default_seed(void) {
+    const char *env = getenv("PROP_SEED");
+    char *end;
+
+    if (env != NULL && *env != '\0') {
+        uint64_t seed = strtoull(env, &end, 0);
+        if (*end == '\0') {
+            return seed;
+        }
+        fprintf(stderr, "prop: ignoring malformed PROP_SEED '%s'\n", env);
+    }
+    return DEFAULT_SEED;
+}
@@ -0,0 +1,96 @@
+#ifndef PROP_H
+#define PROP_H
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Random property testing with integrated shrinking.
+//
+// Every trial draws its arguments from its own PRNG stream, derived from
+// (seed, trial index), so any failing trial can be replayed on its own and
+// batches of trials can be generated in any order. Arguments are built
+// from a sequence of recorded choices; shrinking minimizes that sequence
+// and replays the generators, so shrunk values always stay inside the
+// argument ranges. Generators are biased: about a quarter of the values
+// are edge cases (0, ±1, the range bounds, INT_MIN, INT_MAX).
+
+#define PROP_MAX_ARGS 4
+#define PROP_MAX_CHOICES 32
+
+// Inclusive argument range
+typedef struct {
+    int lo;
+    int hi;
+} prop_range;
+
+#define PROP_ANY ((prop_range){INT_MIN, INT_MAX})
+
+// Source of generator choices: a PRNG stream, or a recorded sequence
+// being replayed while shrinking
+typedef struct {
+    uint64_t state;
+    uint64_t choices[PROP_MAX_CHOICES];
+    size_t count;
+    size_t pos;
+    size_t arg_start[PROP_MAX_ARGS];    // first choice of each argument
+    int replay;
+} prop_source;
+
+// Starts the stream of one trial
+void prop_source_init(prop_source *src, uint64_t seed, uint64_t trial);
+
+// Next choice in [0, bound); bound 0 means any 64-bit value
+uint64_t prop_draw(prop_source *src, uint64_t bound);
+
+// Biased int in [range.lo, range.hi]. Smaller choices give simpler values:
+// choice 0 is 0 (or the bound nearest to it), then values step outward
+// one at a time, alternating sides.
+int prop_int(prop_source *src, prop_range range);
+
+typedef struct {
+    const char *name;
+    size_t arity;                       // int arguments, at most PROP_MAX_ARGS
+    prop_range args[PROP_MAX_ARGS];
+
+    // One trial: nonzero when the property holds
+    int (*holds)(const int *args);
+
+    // Optional batched form: sets fail[i] nonzero where the property does
+    // not hold for (args[0][i], args[1][i], ...)
+    void (*holds_n)(const int *const *args, size_t n, unsigned char *fail);
+} prop_property;
+
+typedef struct {
+    uint64_t seed;
+    size_t trials;
+    int batched;                        // use holds_n when the property has one
+} prop_config;
+
+typedef struct {
+    size_t trials_run;
+    int failed;
+    uint64_t failing_trial;
+    int original[PROP_MAX_ARGS];        // arguments as generated
+    int shrunk[PROP_MAX_ARGS];          // after shrinking
+    size_t shrink_steps;                // accepted shrinks
+    double seconds;
+} prop_result;
+
+// Runs cfg->trials trials and shrinks the first failure. Returns 0 when
+// the property held, 1 when it failed, -1 when the property is malformed
+// (too many arguments, no holds function).
+int prop_check(const prop_property *p, const prop_config *cfg, prop_result *res);
+
+// Prints a one-line verdict (with the counterexample and the seed to
+// replay it); returns res->failed
+int prop_report(const prop_property *p, const prop_config *cfg, const prop_result *res);
+
+// Seed from PROP_SEED in the environment, or a fixed default
+uint64_t prop_default_seed(void);
+
+// Random properties of math_utils (random_properties.c); returns the
+// number of failed properties
+int run_random_properties(void);
+
+#endif // PROP_H
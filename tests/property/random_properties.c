@@ -0,0 +1,226 @@
+// Random properties of math_utils, checked by the prop engine. Built
+// against the header-only inline definitions so the batched predicates
+// inline the scalar functions; the _n kernels are checked through their
+// runtime-dispatched entry points.
+#ifndef MATH_UTILS_INLINE
+#define MATH_UTILS_INLINE
+#endif
+#include "math_utils.h"
+#include "prop.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TRIALS 100000
+
+// Ranges where the exact result of the property's arithmetic fits an int
+#define SUM3_RANGE ((prop_range){-(1 << 29), 1 << 29})
+#define DISTRIBUTE_RANGE ((prop_range){-(1 << 14), 1 << 14})
+
+static int clamp64(int64_t v) {
+    return v > INT_MAX ? INT_MAX : v < INT_MIN ? INT_MIN : (int)v;
+}
+
+// ============ add / multiply algebra ============
+
+static int add_algebra_holds(const int *v) {
+    return add(v[0], v[1]) == add(v[1], v[0]) &&
+           add(add(v[0], v[1]), v[2]) == add(v[0], add(v[1], v[2])) &&
+           add(v[0], 0) == v[0] && add(v[0], -v[0]) == 0;
+}
+
+static void add_algebra_holds_n(const int *const *v, size_t n, unsigned char *fail) {
+    const int *a = v[0], *b = v[1], *c = v[2];
+    for (size_t i = 0; i < n; i++) {
+        fail[i] = add(a[i], b[i]) != add(b[i], a[i]) ||
+                  add(add(a[i], b[i]), c[i]) != add(a[i], add(b[i], c[i])) ||
+                  add(a[i], 0) != a[i] || add(a[i], -a[i]) != 0;
+    }
+}
+
+static int distributive_holds(const int *v) {
+    return multiply(v[0], add(v[1], v[2])) == add(multiply(v[0], v[1]), multiply(v[0], v[2])) &&
+           multiply(v[0], v[1]) == multiply(v[1], v[0]) &&
+           subtract(v[0], v[1]) == add(v[0], -v[1]);
+}
+
+static void distributive_holds_n(const int *const *v, size_t n, unsigned char *fail) {
+    const int *a = v[0], *b = v[1], *c = v[2];
+    for (size_t i = 0; i < n; i++) {
+        fail[i] = multiply(a[i], add(b[i], c[i])) != add(multiply(a[i], b[i]), multiply(a[i], c[i])) ||
+                  multiply(a[i], b[i]) != multiply(b[i], a[i]) ||
+                  subtract(a[i], b[i]) != add(a[i], -b[i]);
+    }
+}
+
+// ============ checked / saturating, full int range ============
+
+static int checked_holds(const int *v) {
+    int64_t a = v[0], b = v[1];
+    int64_t exact[3] = {a + b, a - b, a * b};
+    int result[3] = {0, 0, 0};
+    int status[3] = {
+        checked_add(v[0], v[1], &result[0]),
+        checked_subtract(v[0], v[1], &result[1]),
+        checked_multiply(v[0], v[1], &result[2]),
+    };
+
+    for (int k = 0; k < 3; k++) {
+        int fits = exact[k] >= INT_MIN && exact[k] <= INT_MAX;
+        if (status[k] != (fits ? MATH_OK : MATH_ERR_OVERFLOW) || (fits && result[k] != exact[k])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int saturating_holds(const int *v) {
+    int64_t a = v[0], b = v[1];
+    return saturating_add(v[0], v[1]) == clamp64(a + b) &&
+           saturating_subtract(v[0], v[1]) == clamp64(a - b) &&
+           saturating_multiply(v[0], v[1]) == clamp64(a * b) &&
+           saturating_abs_value(v[0]) == clamp64(a < 0 ? -a : a);
+}
+
+// Checks the SIMD batch kernels, whole batch at a time
+static void saturating_holds_n(const int *const *v, size_t n, unsigned char *fail) {
+    int sum[1024], diff[1024], prod[1024], absv[1024];
+
+    for (size_t first = 0; first < n; first += 1024) {
+        size_t m = n - first < 1024 ? n - first : 1024;
+        const int *a = v[0] + first, *b = v[1] + first;
+
+        saturating_add_n(a, b, sum, m);
+        saturating_subtract_n(a, b, diff, m);
+        saturating_multiply_n(a, b, prod, m);
+        saturating_abs_value_n(a, absv, m);
+        for (size_t i = 0; i < m; i++) {
+            int64_t x = a[i], y = b[i];
+            fail[first + i] = sum[i] != clamp64(x + y) || diff[i] != clamp64(x - y) ||
+                              prod[i] != clamp64(x * y) || absv[i] != clamp64(x < 0 ? -x : x);
+        }
+    }
+}
+
+static int min_max_holds(const int *v) {
+    int hi = max_value(v[0], v[1]), lo = min_value(v[0], v[1]);
+    return hi >= v[0] && hi >= v[1] && lo <= v[0] && lo <= v[1] &&
+           (hi == v[0] || hi == v[1]) && (lo == v[0] || lo == v[1]) &&
+           is_even(v[0]) == ((v[0] & 1) == 0) && is_positive(v[0]) == (v[0] > 0);
+}
+
+static void min_max_holds_n(const int *const *v, size_t n, unsigned char *fail) {
+    int hi[1024], lo[1024], even[1024], positive[1024];
+
+    for (size_t first = 0; first < n; first += 1024) {
+        size_t m = n - first < 1024 ? n - first : 1024;
+        const int *a = v[0] + first, *b = v[1] + first;
+
+        max_value_n(a, b, hi, m);
+        min_value_n(a, b, lo, m);
+        is_even_n(a, even, m);
+        is_positive_n(a, positive, m);
+        for (size_t i = 0; i < m; i++) {
+            fail[first + i] = hi[i] != max_value(a[i], b[i]) || lo[i] != min_value(a[i], b[i]) ||
+                              (even[i] != 0) != ((a[i] & 1) == 0) ||
+                              (positive[i] != 0) != (a[i] > 0);
+        }
+    }
+}
+
+// ============ factorial / fibonacci ============
+
+static int factorial_holds(const int *v) {
+    return factorial(v[0]) == v[0] * factorial(v[0] - 1) && factorial(v[0]) > 0;
+}
+
+static int fibonacci_holds(const int *v) {
+    uint64_t wide = 0;
+    return fibonacci(v[0]) == fibonacci(v[0] - 1) + fibonacci(v[0] - 2) &&
+           fibonacci_u64((uint64_t)v[0], &wide) == MATH_OK && wide == (uint64_t)fibonacci(v[0]);
+}
+
+// ============ Engine self-checks: false properties must shrink ============
+
+static int abs_below_100(const int *v) {
+    return v[0] == INT_MIN || abs_value(v[0]) < 100;
+}
+
+static int spread_below_1000(const int *v) {
+    return max_value(v[0], v[1]) - min_value(v[0], v[1]) < 1000;
+}
+
+static int check(const prop_property *p, const prop_config *cfg) {
+    prop_result res;
+    int status = prop_check(p, cfg, &res);
+
+    if (status < 0) {
+        printf("✗ %s: malformed property\n", p->name);
+        return 1;
+    }
+    return prop_report(p, cfg, &res);
+}
+
+// Runs a property that is known to be false and expects the engine to
+// find it and shrink it to exactly `expected`
+static int check_shrinks(const prop_property *p, const prop_config *cfg, const int *expected) {
+    prop_result first, again;
+
+    if (prop_check(p, cfg, &first) != 1) {
+        printf("✗ shrinker: '%s' was not falsified\n", p->name);
+        return 1;
+    }
+    prop_check(p, cfg, &again);
+    if (memcmp(first.shrunk, expected, p->arity * sizeof(int)) != 0 ||
+        memcmp(first.original, again.original, sizeof(first.original)) != 0 ||
+        first.failing_trial != again.failing_trial) {
+        printf("✗ shrinker: '%s' ", p->name);
+        prop_report(p, cfg, &first);
+        return 1;
+    }
+    printf("✓ shrinker: '%s' shrinks to (", p->name);
+    for (size_t k = 0; k < p->arity; k++) {
+        printf(k ? ", %d" : "%d", first.shrunk[k]);
+    }
+    printf(") in %zu steps\n", first.shrink_steps);
+    return 0;
+}
+
+int run_random_properties(void) {
+    static const prop_property properties[] = {
+        {"add: commutative, associative, identity, inverse", 3,
+         {SUM3_RANGE, SUM3_RANGE, SUM3_RANGE}, add_algebra_holds, add_algebra_holds_n},
+        {"multiply distributes over add", 3,
+         {DISTRIBUTE_RANGE, DISTRIBUTE_RANGE, DISTRIBUTE_RANGE}, distributive_holds,
+         distributive_holds_n},
+        {"checked_* == 64-bit result or overflow", 2, {PROP_ANY, PROP_ANY}, checked_holds, NULL},
+        {"saturating_* == clamp(exact)", 2, {PROP_ANY, PROP_ANY}, saturating_holds,
+         saturating_holds_n},
+        {"min/max/parity/sign, scalar == batch", 2, {PROP_ANY, PROP_ANY}, min_max_holds,
+         min_max_holds_n},
+        {"factorial(n) == n * factorial(n - 1)", 1, {{1, 12}}, factorial_holds, NULL},
+        {"fibonacci recurrence, fibonacci_u64 agrees", 1, {{2, 46}}, fibonacci_holds, NULL},
+    };
+    static const prop_property abs_false = {"abs_value(x) < 100", 1, {PROP_ANY}, abs_below_100, NULL};
+    static const prop_property spread_false = {
+        "max - min < 1000", 2, {{-1000000, 1000000}, {-1000000, 1000000}}, spread_below_1000, NULL};
+    prop_config cfg = {prop_default_seed(), TRIALS, 1};
+    int failed = 0;
+
+    printf("=== Random properties ===\n");
+    printf("Testing %d trials per property, seed 0x%llx\n", TRIALS, (unsigned long long)cfg.seed);
+    for (size_t i = 0; i < sizeof(properties) / sizeof(properties[0]); i++) {
+        failed += check(&properties[i], &cfg);
+    }
+
+    // Scalar mode must see the same trials as batched mode
+    cfg.batched = 0;
+    failed += check(&properties[3], &cfg);
+
+    printf("Testing the shrinker on false properties\n");
+    failed += check_shrinks(&abs_false, &cfg, (const int[]){100});
+    failed += check_shrinks(&spread_false, &cfg, (const int[]){0, 1000});
+    printf("\n");
+    return failed;
+}
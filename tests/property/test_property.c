@@ -1,10 +1,16 @@
 #include <stdio.h>
 #include <assert.h>
 #include <setjmp.h>
+#include <limits.h>
+#include <stdint.h>
 #include "math_utils.h"
+#include "exhaustive.h"
+#include "prop.h"
 
-// Property-Based Testing with theft Library
-// Tests mathematical properties that should always hold
+// Property-Based Testing
+// Tests mathematical properties that should always hold: fixed edge-value
+// loops here, random trials with shrinking (random_properties.c) and
+// full-domain sweeps (exhaustive_properties.c)
 
 // Global jump buffer for handling assertion failures
 static jmp_buf jump_buffer;
@@ -205,7 +211,7 @@ void test_factorial_properties() {
 
     // Property 2: factorial(n) = n * factorial(n-1)
     printf("Testing recursive property: n! = n * (n-1)!\n");
-    for (int n = 2; n <= 10; n++) {
+    for (int n = 2; n <= FACTORIAL_MAX_N; n++) {
         int result1 = factorial(n);
         int result2 = multiply(n, factorial(n - 1));
         assert(result1 == result2 && "Recursive property violated!");
@@ -232,7 +238,7 @@ void test_fibonacci_properties() {
 
     // Property 2: fib(n) = fib(n-1) + fib(n-2) for n >= 2
     printf("Testing recursive property: fib(n) = fib(n-1) + fib(n-2)\n");
-    for (int n = 2; n <= 15; n++) {
+    for (int n = 2; n <= FIBONACCI_MAX_N; n++) {
         int result1 = fibonacci(n);
         int result2 = add(fibonacci(n - 1), fibonacci(n - 2));
         assert(result1 == result2 && "Recursive property violated!");
@@ -245,6 +251,129 @@ void test_fibonacci_properties() {
     printf("✓ Base cases property holds\n\n");
 }
 
+// Inputs around zero and both ends of the int range, where overflow lives
+static const int edge_values[] = {
+    INT_MIN, INT_MIN + 1, INT_MIN / 2, -46341, -46340, -65536, -1000, -7, -2, -1,
+    0, 1, 2, 7, 1000, 65536, 46340, 46341, INT_MAX / 2, INT_MAX - 1, INT_MAX
+};
+#define EDGE_COUNT ((int)(sizeof(edge_values) / sizeof(edge_values[0])))
+
+// Clamp an exact 64-bit result to the int range
+static int clamp_to_int(int64_t value) {
+    if (value > INT_MAX) {
+        return INT_MAX;
+    }
+    if (value < INT_MIN) {
+        return INT_MIN;
+    }
+    return (int)value;
+}
+
+// Properties for checked_*()
+void test_checked_properties() {
+    printf("=== Testing checked_*() properties ===\n");
+
+    // Property 1: checked ops succeed exactly when the true result fits,
+    // and then agree with 64-bit arithmetic
+    printf("Testing checked_add/subtract/multiply against 64-bit arithmetic\n");
+    for (int i = 0; i < EDGE_COUNT; i++) {
+        for (int j = 0; j < EDGE_COUNT; j++) {
+            int64_t a = edge_values[i], b = edge_values[j];
+            int64_t exact[3] = {a + b, a - b, a * b};
+            int status[3], result[3] = {0, 0, 0};
+            status[0] = checked_add((int)a, (int)b, &result[0]);
+            status[1] = checked_subtract((int)a, (int)b, &result[1]);
+            status[2] = checked_multiply((int)a, (int)b, &result[2]);
+            for (int k = 0; k < 3; k++) {
+                int fits = exact[k] >= INT_MIN && exact[k] <= INT_MAX;
+                assert(status[k] == (fits ? MATH_OK : MATH_ERR_OVERFLOW) && "Overflow status wrong!");
+                assert((!fits || result[k] == exact[k]) && "Checked result wrong!");
+            }
+        }
+    }
+    printf("✓ Checked arithmetic property holds\n\n");
+
+    // Property 2: *out is untouched on overflow
+    printf("Testing output is preserved on overflow\n");
+    int out = 12345;
+    assert(checked_add(INT_MAX, 1, &out) == MATH_ERR_OVERFLOW && out == 12345 && "Output clobbered!");
+    assert(checked_multiply(INT_MIN, -1, &out) == MATH_ERR_OVERFLOW && out == 12345 && "Output clobbered!");
+    printf("✓ Output preservation property holds\n\n");
+
+    // Property 3: checked_abs_value fails only for INT_MIN
+    printf("Testing checked_abs_value: only INT_MIN overflows\n");
+    for (int i = 0; i < EDGE_COUNT; i++) {
+        int x = edge_values[i];
+        int status = checked_abs_value(x, &out);
+        if (x == INT_MIN) {
+            assert(status == MATH_ERR_OVERFLOW && "abs(INT_MIN) must overflow!");
+        } else {
+            assert(status == MATH_OK && out == abs_value(x) && "Checked abs wrong!");
+        }
+    }
+    printf("✓ Checked abs property holds\n\n");
+}
+
+// Properties for saturating_*()
+void test_saturating_properties() {
+    printf("=== Testing saturating_*() properties ===\n");
+
+    // Property 1: saturating ops equal the clamped exact result
+    printf("Testing saturating ops == clamp(exact result)\n");
+    for (int i = 0; i < EDGE_COUNT; i++) {
+        for (int j = 0; j < EDGE_COUNT; j++) {
+            int64_t a = edge_values[i], b = edge_values[j];
+            assert(saturating_add((int)a, (int)b) == clamp_to_int(a + b) && "Saturating add wrong!");
+            assert(saturating_subtract((int)a, (int)b) == clamp_to_int(a - b) && "Saturating subtract wrong!");
+            assert(saturating_multiply((int)a, (int)b) == clamp_to_int(a * b) && "Saturating multiply wrong!");
+        }
+        int64_t x = edge_values[i];
+        assert(saturating_abs_value((int)x) == clamp_to_int(x < 0 ? -x : x) && "Saturating abs wrong!");
+    }
+    printf("✓ Saturation property holds\n\n");
+
+    // Property 2: saturating_add is commutative even at the limits
+    printf("Testing saturating commutativity\n");
+    for (int i = 0; i < EDGE_COUNT; i++) {
+        for (int j = 0; j < EDGE_COUNT; j++) {
+            int a = edge_values[i], b = edge_values[j];
+            assert(saturating_add(a, b) == saturating_add(b, a) && "Saturating add commutativity violated!");
+            assert(saturating_multiply(a, b) == saturating_multiply(b, a) && "Saturating multiply commutativity violated!");
+        }
+    }
+    printf("✓ Saturating commutativity property holds\n\n");
+
+    // Property 3: batch forms match the scalar forms at every SIMD level
+    printf("Testing saturating_*_n == saturating_* at every SIMD level\n");
+    int a[EDGE_COUNT * EDGE_COUNT], b[EDGE_COUNT * EDGE_COUNT];
+    int sum[EDGE_COUNT * EDGE_COUNT], diff[EDGE_COUNT * EDGE_COUNT];
+    int prod[EDGE_COUNT * EDGE_COUNT], absv[EDGE_COUNT * EDGE_COUNT];
+    size_t n = 0;
+    for (int i = 0; i < EDGE_COUNT; i++) {
+        for (int j = 0; j < EDGE_COUNT; j++) {
+            a[n] = edge_values[i];
+            b[n] = edge_values[j];
+            n++;
+        }
+    }
+    math_simd_level best = math_simd_detect();
+    for (int level = MATH_SIMD_SCALAR; level <= (int)best; level++) {
+        math_simd_force((math_simd_level)level);
+        saturating_add_n(a, b, sum, n);
+        saturating_subtract_n(a, b, diff, n);
+        saturating_multiply_n(a, b, prod, n);
+        saturating_abs_value_n(a, absv, n);
+        for (size_t k = 0; k < n; k++) {
+            assert(sum[k] == saturating_add(a[k], b[k]) && "Batch saturating add wrong!");
+            assert(diff[k] == saturating_subtract(a[k], b[k]) && "Batch saturating subtract wrong!");
+            assert(prod[k] == saturating_multiply(a[k], b[k]) && "Batch saturating multiply wrong!");
+            assert(absv[k] == saturating_abs_value(a[k]) && "Batch saturating abs wrong!");
+        }
+    }
+    math_simd_force(best);
+    printf("✓ Batch saturation property holds\n\n");
+}
+
 int main() {
     printf("========================================\n");
     printf("  Property-Based Testing Suite\n");
@@ -295,6 +424,32 @@ int main() {
         failed = 1;
     }
 
+    if (setjmp(jump_buffer) == 0) {
+        test_checked_properties();
+    } else {
+        printf("✗ Checked arithmetic properties test failed\n\n");
+        failed = 1;
+    }
+
+    if (setjmp(jump_buffer) == 0) {
+        test_saturating_properties();
+    } else {
+        printf("✗ Saturating arithmetic properties test failed\n\n");
+        failed = 1;
+    }
+
+    // Random trials with shrinking; failures are reported with their seed
+    if (run_random_properties() != 0) {
+        printf("✗ Random properties test failed\n\n");
+        failed = 1;
+    }
+
+    // Full-domain checks: every failure is counted, nothing aborts
+    if (run_exhaustive_properties() != 0) {
+        printf("✗ Exhaustive properties test failed\n\n");
+        failed = 1;
+    }
+
     printf("========================================\n");
     if (failed == 0) {
         printf("✓ All property tests passed!\n");
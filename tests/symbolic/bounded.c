@@ -0,0 +1,786 @@
+// bounded - local bounded checker for the KLEE harnesses
+//
+// Implements the klee_* calls of shim/klee/klee.h and symbolic_run without
+// KLEE or a container. Each harness runs natively, once per assignment of
+// its symbolic inputs:
+//
+//   1. A first run records the inputs the harness makes symbolic (name and
+//      size), with every input 0 and klee_assume ignored.
+//   2. Every input gets a domain: the integers in [-span, span], nearest
+//      zero first, then the edges of its type outside the span (MIN,
+//      MIN + 1, MAX - 1, MAX and the values around +-2^7, 2^15, ...). The
+//      span is picked so the product of the domain sizes stays within
+//      --max-inputs; a 1-byte input always gets all 256 values.
+//   3. The harness runs on every combination, last input fastest. A false
+//      klee_assume drops the run; a false klee_assert or a trap (SIGFPE,
+//      SIGSEGV, ...) counts it as failing and keeps the first inputs that
+//      failed at each site.
+//
+// Runs end with siglongjmp back into the checker, so a harness must not
+// hold resources across its asserts. Signed overflow wraps, as in KLEE
+// (the Makefile builds with -fwrapv). Unlike KLEE this is a bounded search,
+// not a proof: a harness only counts as exhaustive when every input's
+// domain covers its whole type.
+//
+// Each harness is checked in its own process, --jobs at a time (default:
+// one per online core), and stops early once it has used its time budget
+// from the harness table. Reports are printed in table order.
+//
+// With --hashes (mutagen --hashes over the harnesses and math_utils.c) and
+// --cache, a harness that passed with the same code hash and budgets is
+// not rerun: its earlier result is reported as cached.
+//
+// Usage: test_symbolic [--max-inputs N] [--jobs N] [--hashes FILE --cache FILE]
+//                      [--list [--verbose]] [HARNESS...]
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE     // MAP_ANONYMOUS
+
+#include "symbolic.h"
+
+#include <klee/klee.h>
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_MAX_INPUTS (UINT64_C(1) << 22)
+#define DEADLINE_CHECK_RUNS 4096
+#define MAX_VARIABLES SYMBOLIC_MAX_INPUTS
+#define MAX_SITES 8
+#define MAX_EDGES 40
+
+// How a run ended; returned by sigsetjmp, so nonzero
+typedef enum {
+    PATH_COMPLETED = 1,
+    PATH_INFEASIBLE,    // a klee_assume was false
+    PATH_FAILED         // a klee_assert was false, or the harness trapped
+} path_end;
+
+// One symbolic input of the harness being checked
+typedef struct {
+    char name[32];
+    size_t size;
+    int64_t *values;    // domain, in the order tried
+    size_t count;
+    size_t index;       // current value
+    int complete;       // the domain is the whole type
+} variable;
+
+// Assertion (or trap) that failed, with the first inputs that reached it
+typedef struct {
+    const char *what;
+    const char *file;
+    unsigned line;
+    int64_t values[MAX_VARIABLES];
+    uint64_t hits;
+} failure_site;
+
+// Shared with the parent, which forks one child per harness
+typedef struct {
+    uint64_t runs;
+    uint64_t domain;        // combinations of input values
+    uint64_t feasible;
+    uint64_t failed;
+    double millis;
+    int exhaustive;
+    int stopped;            // ran out of its time budget
+    int cached;
+} harness_result;
+
+static struct {
+    sigjmp_buf path;
+    volatile sig_atomic_t running;  // inside a harness run
+    int discovering;                // first run: record the inputs
+    variable vars[MAX_VARIABLES];
+    size_t var_count;
+    size_t next_var;                // klee_make_symbolic calls this run
+    const char *problem;            // why the inputs cannot be enumerated
+    int undiscovered;               // a run made an input the first run did not
+    failure_site sites[MAX_SITES];
+    size_t site_count;
+} checker;
+
+static double now_millis(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void store_value(void *addr, size_t size, int64_t v) {
+    switch (size) {
+    case 1: *(int8_t *)addr = (int8_t)v; break;
+    case 2: *(int16_t *)addr = (int16_t)v; break;
+    case 4: *(int32_t *)addr = (int32_t)v; break;
+    default: *(int64_t *)addr = v; break;
+    }
+}
+
+// Ends the current run as failing at a site; the first failure at each
+// site keeps its inputs
+static void __attribute__((noreturn)) fail_path(const char *what, const char *file, unsigned line) {
+    failure_site *site = NULL;
+
+    if (checker.discovering) {
+        siglongjmp(checker.path, PATH_FAILED);
+    }
+    for (size_t i = 0; i < checker.site_count; i++) {
+        if (checker.sites[i].line == line && strcmp(checker.sites[i].what, what) == 0) {
+            site = &checker.sites[i];
+            break;
+        }
+    }
+    if (site == NULL && checker.site_count < MAX_SITES) {
+        site = &checker.sites[checker.site_count++];
+        site->what = what;
+        site->file = file;
+        site->line = line;
+        site->hits = 0;
+        for (size_t i = 0; i < checker.var_count; i++) {
+            site->values[i] = checker.vars[i].values[checker.vars[i].index];
+        }
+    }
+    if (site != NULL) {
+        site->hits++;
+    }
+    siglongjmp(checker.path, PATH_FAILED);
+}
+
+// ========== klee/klee.h ==========
+
+void klee_make_symbolic(void *addr, size_t nbytes, const char *name) {
+    size_t i = checker.next_var++;
+
+    memset(addr, 0, nbytes);
+    if (!checker.running) {
+        return;
+    }
+    if (checker.discovering) {
+        if (i >= MAX_VARIABLES) {
+            checker.problem = "too many symbolic inputs";
+        } else if (nbytes != 1 && nbytes != 2 && nbytes != 4 && nbytes != 8) {
+            checker.problem = "symbolic inputs must be 1, 2, 4 or 8 bytes";
+        } else {
+            variable *v = &checker.vars[checker.var_count++];
+            snprintf(v->name, sizeof(v->name), "%s", name);
+            v->size = nbytes;
+        }
+        return;
+    }
+    if (i >= checker.var_count || checker.vars[i].size != nbytes) {
+        checker.undiscovered = 1;
+        return;
+    }
+    store_value(addr, nbytes, checker.vars[i].values[checker.vars[i].index]);
+}
+
+void klee_assume(uintptr_t condition) {
+    if (!condition && checker.running && !checker.discovering) {
+        siglongjmp(checker.path, PATH_INFEASIBLE);
+    }
+}
+
+void klee_silent_exit(int status) {
+    if (checker.running) {
+        siglongjmp(checker.path, PATH_COMPLETED);
+    }
+    fflush(stdout);
+    exit(status);
+}
+
+int klee_int(const char *name) {
+    int x;
+    klee_make_symbolic(&x, sizeof(x), name);
+    return x;
+}
+
+int klee_range(int begin, int end, const char *name) {
+    int x = klee_int(name);
+    klee_assume(x >= begin && x < end);
+    return x;
+}
+
+void klee_assert_fail(const char *expr, const char *file, unsigned line, const char *function) {
+    (void)function;
+    if (!checker.running) {
+        fprintf(stderr, "%s:%u: klee_assert(%s) failed\n", file, line, expr);
+        abort();
+    }
+    fail_path(expr, file, line);
+}
+
+// ========== Traps ==========
+
+static const struct {
+    int signo;
+    const char *what;
+} traps[] = {
+    {SIGFPE, "arithmetic trap (SIGFPE)"},
+    {SIGSEGV, "invalid memory access (SIGSEGV)"},
+    {SIGBUS, "bus error (SIGBUS)"},
+    {SIGILL, "illegal instruction (SIGILL)"},
+    {SIGABRT, "abort (SIGABRT)"},
+};
+
+#define TRAP_COUNT (sizeof(traps) / sizeof(traps[0]))
+
+static void on_trap(int signo) {
+    if (!checker.running) {
+        signal(signo, SIG_DFL);
+        raise(signo);
+        return;
+    }
+    for (size_t i = 0; i < TRAP_COUNT; i++) {
+        if (traps[i].signo == signo) {
+            fail_path(traps[i].what, NULL, 0);
+        }
+    }
+}
+
+// SA_NODEFER: the handler leaves by siglongjmp, which does not restore the
+// signal mask (saving it per run would cost a system call)
+static void install_trap_handlers(void) {
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_trap;
+    sa.sa_flags = SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    for (size_t i = 0; i < TRAP_COUNT; i++) {
+        sigaction(traps[i].signo, &sa, NULL);
+    }
+}
+
+// ========== Domains ==========
+
+// Largest r with r^k <= n (at least 3: zero and one value either side)
+static uint64_t integer_root(uint64_t n, size_t k) {
+    uint64_t r = 3;
+
+    for (;;) {
+        uint64_t power = 1, next = r + 1;
+        size_t i;
+        for (i = 0; i < k && power <= n / next; i++) {
+            power *= next;
+        }
+        if (i < k) {
+            return r;
+        }
+        r = next;
+    }
+}
+
+static int build_domain(variable *v, uint64_t budget) {
+    int bits = (int)v->size * 8;
+    int64_t hi = (int64_t)(UINT64_MAX >> (65 - bits));
+    int64_t lo = -hi - 1;
+    int64_t edges[MAX_EDGES];
+    size_t edge_count = 0;
+    int64_t candidates[MAX_EDGES] = {lo, lo + 1, hi - 1, hi};
+    size_t candidate_count = 4;
+    uint64_t span;
+
+    for (int k = 7; k < bits - 1; k += 8) {
+        int64_t p = INT64_C(1) << k;
+        candidates[candidate_count++] = p - 1;
+        candidates[candidate_count++] = p;
+        candidates[candidate_count++] = -p;
+        candidates[candidate_count++] = -p - 1;
+    }
+    // The edges count against the budget too
+    span = budget > candidate_count + 3 ? (budget - candidate_count - 1) / 2 : 1;
+    if (v->size == 1 || span > (uint64_t)hi) {
+        span = (uint64_t)hi;
+    }
+    for (size_t i = 0; i < candidate_count; i++) {
+        int64_t e = candidates[i];
+        int inside = e >= -(int64_t)span && e <= (int64_t)span;
+        int seen = 0;
+        for (size_t j = 0; j < edge_count; j++) {
+            seen |= edges[j] == e;
+        }
+        if (!inside && !seen) {
+            edges[edge_count++] = e;
+        }
+    }
+
+    v->count = 2 * span + 1 + edge_count;
+    v->values = malloc(v->count * sizeof(*v->values));
+    if (v->values == NULL) {
+        return -1;
+    }
+    v->values[0] = 0;
+    for (uint64_t i = 1; i <= span; i++) {
+        v->values[2 * i - 1] = -(int64_t)i;
+        v->values[2 * i] = (int64_t)i;
+    }
+    memcpy(v->values + 2 * span + 1, edges, edge_count * sizeof(*edges));
+    v->index = 0;
+    v->complete = span == (uint64_t)hi;  // lo is an edge
+    return 0;
+}
+
+// Advances to the next combination, last input fastest; 0 after the last
+static int next_assignment(void) {
+    for (size_t i = checker.var_count; i-- > 0;) {
+        if (++checker.vars[i].index < checker.vars[i].count) {
+            return 1;
+        }
+        checker.vars[i].index = 0;
+    }
+    return 0;
+}
+
+// ========== Checking ==========
+
+// One run of the harness on the current assignment
+static path_end run_once(const symbolic_harness *h) {
+    int end;
+
+    checker.next_var = 0;
+    checker.running = 1;
+    end = sigsetjmp(checker.path, 0);
+    if (end == 0) {
+        h->run();
+        end = PATH_COMPLETED;
+    }
+    checker.running = 0;
+    return (path_end)end;
+}
+
+static void free_domains(void) {
+    for (size_t i = 0; i < checker.var_count; i++) {
+        free(checker.vars[i].values);
+        checker.vars[i].values = NULL;
+    }
+}
+
+// Checks one harness. Returns 0 when it ran, -1 when its inputs cannot be
+// enumerated (reason in checker.problem).
+static int check_harness(const symbolic_harness *h, uint64_t max_inputs, harness_result *r) {
+    double started = now_millis();
+    double deadline = started + 1e3 * (h->seconds ? h->seconds : SYMBOLIC_DEFAULT_SECONDS);
+    int saved_stdout, devnull;
+
+    memset(r, 0, sizeof(*r));
+    checker.var_count = 0;
+    checker.site_count = 0;
+    checker.problem = NULL;
+    checker.undiscovered = 0;
+
+    // The first run prints whatever the harness prints; later ones are quiet
+    checker.discovering = 1;
+    run_once(h);
+    checker.discovering = 0;
+    if (checker.problem != NULL) {
+        return -1;
+    }
+    r->exhaustive = 1;
+    r->domain = 1;
+    uint64_t budget = integer_root(max_inputs, checker.var_count);
+    for (size_t i = 0; i < checker.var_count; i++) {
+        if (build_domain(&checker.vars[i], budget) != 0) {
+            checker.problem = "out of memory";
+            free_domains();
+            return -1;
+        }
+        r->exhaustive &= checker.vars[i].complete;
+        r->domain *= checker.vars[i].count;
+    }
+
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+        close(devnull);
+    }
+    do {
+        path_end end = run_once(h);
+        r->runs++;
+        r->feasible += end != PATH_INFEASIBLE;
+        r->failed += end == PATH_FAILED;
+        if (r->runs % DEADLINE_CHECK_RUNS == 0 && now_millis() > deadline) {
+            r->stopped = 1;
+            break;
+        }
+    } while (next_assignment());
+    fflush(stdout);
+    if (saved_stdout >= 0) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+    }
+
+    r->millis = now_millis() - started;
+    return 0;
+}
+
+static void print_result(const symbolic_harness *h, const harness_result *r) {
+    const char *scope = r->exhaustive && !r->stopped ? "exhaustive, " : "";
+
+    if (r->cached) {
+        printf("✓ %s: unchanged, %" PRIu64 " of %" PRIu64 " inputs satisfied the assumptions, "
+               "every assertion held (cached)\n", h->name, r->feasible, r->runs);
+        return;
+    }
+    if (r->failed == 0) {
+        printf("✓ %s: %" PRIu64 " of %" PRIu64 " inputs satisfy the assumptions, "
+               "every assertion holds (%s%.0f ms)\n",
+               h->name, r->feasible, r->runs, scope, r->millis);
+    } else {
+        printf("✗ %s: %" PRIu64 " of %" PRIu64 " feasible inputs fail (%s%.0f ms)\n",
+               h->name, r->failed, r->feasible, scope, r->millis);
+    }
+    if (r->stopped) {
+        printf("    stopped at its %u s budget after %" PRIu64 " of %" PRIu64 " inputs\n",
+               h->seconds ? h->seconds : SYMBOLIC_DEFAULT_SECONDS, r->runs, r->domain);
+    }
+    for (size_t i = 0; i < checker.site_count; i++) {
+        const failure_site *site = &checker.sites[i];
+        if (site->file != NULL) {
+            printf("    %s:%u: klee_assert(%s) failed", site->file, site->line, site->what);
+        } else {
+            printf("    %s", site->what);
+        }
+        printf(" %" PRIu64 " times, first with", site->hits);
+        for (size_t j = 0; j < checker.var_count; j++) {
+            printf("%s %s = %" PRId64, j ? "," : "", checker.vars[j].name, site->values[j]);
+        }
+        printf("\n");
+    }
+    if (checker.undiscovered) {
+        printf("    warning: inputs made symbolic after the first assertion were left 0\n");
+    }
+}
+
+int symbolic_check(const symbolic_harness *h, uint64_t max_inputs, symbolic_outcome *out) {
+    harness_result r;
+
+    memset(out, 0, sizeof(*out));
+    install_trap_handlers();
+    if (check_harness(h, max_inputs ? max_inputs : DEFAULT_MAX_INPUTS, &r) != 0) {
+        return -1;
+    }
+    out->runs = r.runs;
+    out->feasible = r.feasible;
+    out->failed = r.failed;
+    out->exhaustive = r.exhaustive && !r.stopped;
+    out->stopped = r.stopped;
+    out->input_count = checker.var_count;
+    for (size_t i = 0; i < checker.var_count; i++) {
+        out->names[i] = checker.vars[i].name;
+        out->inputs[i] = checker.site_count > 0 ? checker.sites[0].values[i] : 0;
+    }
+    free_domains();
+    return 0;
+}
+
+// ========== Result cache ==========
+
+// 64-bit FNV-1a, continued from h
+static uint64_t fnv1a_64(uint64_t h, const char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211u;
+    }
+    return h;
+}
+
+// Code hash of the harness entry (mutagen --hashes: the harness and every
+// math_utils function it reaches) with the budgets it ran under; 0 when
+// the hashes file does not list the entry
+static uint64_t cache_key(const char *hashes_path, const symbolic_harness *h, uint64_t max_inputs) {
+    FILE *in = hashes_path != NULL ? fopen(hashes_path, "r") : NULL;
+    char line[256], function[128], hash[32];
+    uint64_t key = 0;
+
+    while (in != NULL && key == 0 && fgets(line, sizeof(line), in) != NULL) {
+        if (line[0] != '#' && sscanf(line, "%127[^\t]\t%31s", function, hash) == 2 &&
+            strcmp(function, h->entry) == 0) {
+            snprintf(line, sizeof(line), "%s\t%s\t%" PRIu64 "\t%u", h->entry, hash, max_inputs,
+                     h->seconds);
+            key = fnv1a_64(14695981039346656037u, line, strlen(line)) | 1;
+        }
+    }
+    if (in != NULL) {
+        fclose(in);
+    }
+    return key;
+}
+
+// Cache lines: name<TAB>key<TAB>runs<TAB>domain<TAB>feasible; passing
+// harnesses only, so a failure is always rerun and reported in full
+static void read_cache(const char *path, const symbolic_harness *harnesses, size_t count,
+                       const uint64_t *keys, harness_result *results) {
+    FILE *in = path != NULL ? fopen(path, "r") : NULL;
+    char line[256], name[64];
+
+    while (in != NULL && fgets(line, sizeof(line), in) != NULL) {
+        unsigned long long key, runs, domain, feasible;
+        if (line[0] == '#' || sscanf(line, "%63[^\t]\t%llx\t%llu\t%llu\t%llu", name, &key, &runs,
+                                     &domain, &feasible) != 5) {
+            continue;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (keys[i] != 0 && keys[i] == key && strcmp(harnesses[i].name, name) == 0) {
+                results[i].runs = runs;
+                results[i].domain = domain;
+                results[i].feasible = feasible;
+                results[i].cached = 1;
+            }
+        }
+    }
+    if (in != NULL) {
+        fclose(in);
+    }
+}
+
+static int write_cache(const char *path, const symbolic_harness *harnesses, size_t count,
+                       const uint64_t *keys, const harness_result *results, const int *passed) {
+    char tmp[4096];
+    FILE *out;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    out = fopen(tmp, "w");
+    if (out == NULL) {
+        perror(tmp);
+        return -1;
+    }
+    fputs("# harness\tkey\truns\tdomain\tfeasible\n", out);
+    for (size_t i = 0; i < count; i++) {
+        if (keys[i] != 0 && passed[i]) {
+            fprintf(out, "%s\t%016" PRIx64 "\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\n",
+                    harnesses[i].name, keys[i], results[i].runs, results[i].domain,
+                    results[i].feasible);
+        }
+    }
+    if (fclose(out) != 0 || rename(tmp, path) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+// ========== Parallel driver ==========
+
+// Checks one harness in a child process, its report going to out
+static pid_t start_harness(const symbolic_harness *h, uint64_t max_inputs, harness_result *r,
+                           FILE *out) {
+    pid_t pid;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    dup2(fileno(out), STDOUT_FILENO);
+    install_trap_handlers();
+    if (check_harness(h, max_inputs, r) != 0) {
+        printf("✗ %s: %s\n", h->name, checker.problem);
+        fflush(stdout);
+        _exit(1);
+    }
+    print_result(h, r);
+    fflush(stdout);
+    _exit(r->failed == 0 ? 0 : 1);
+}
+
+static void copy_report(FILE *report) {
+    char buf[4096];
+    size_t n;
+
+    rewind(report);
+    while ((n = fread(buf, 1, sizeof(buf), report)) > 0) {
+        fwrite(buf, 1, n, stdout);
+    }
+    fclose(report);
+}
+
+static const symbolic_harness *find_harness(const symbolic_harness *harnesses, size_t count,
+                                            const char *name) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(harnesses[i].name, name) == 0) {
+            return &harnesses[i];
+        }
+    }
+    return NULL;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "Usage: %s [--max-inputs N] [--jobs N] [--hashes FILE --cache FILE] "
+                    "[--list [--verbose]] [HARNESS...]\n", argv0);
+}
+
+int symbolic_run(const symbolic_harness *harnesses, size_t count, int argc, char **argv) {
+    uint64_t max_inputs = DEFAULT_MAX_INPUTS;
+    const char *hashes_path = NULL, *cache_path = NULL;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int list = 0, verbose = 0, first_name = argc, i;
+
+    for (i = 1; i < argc && first_name == argc; i++) {
+        char *end = NULL;
+        if (strcmp(argv[i], "--max-inputs") == 0 && i + 1 < argc) {
+            max_inputs = strtoull(argv[++i], &end, 10);
+            if (*end != '\0' || max_inputs == 0) {
+                fprintf(stderr, "--max-inputs: expected a positive count, got '%s'\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || jobs <= 0) {
+                fprintf(stderr, "--jobs: expected a positive count, got '%s'\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--hashes") == 0 && i + 1 < argc) {
+            hashes_path = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cache_path = argv[++i];
+        } else if (strcmp(argv[i], "--list") == 0) {
+            list = 1;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = 1;
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            first_name = i;
+        }
+    }
+    if (cache_path != NULL && hashes_path == NULL) {
+        fprintf(stderr, "--cache needs --hashes\n");
+        return 2;
+    }
+    if (list) {
+        for (size_t k = 0; k < count; k++) {
+            if (verbose) {
+                printf("%s\t%s\t%u\n", harnesses[k].name, harnesses[k].entry,
+                       harnesses[k].seconds ? harnesses[k].seconds : SYMBOLIC_DEFAULT_SECONDS);
+            } else {
+                printf("%s\n", harnesses[k].name);
+            }
+        }
+        return 0;
+    }
+    for (i = first_name; i < argc; i++) {
+        if (find_harness(harnesses, count, argv[i]) == NULL) {
+            fprintf(stderr, "Unknown harness: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (jobs <= 0) {
+        jobs = 1;
+    }
+
+    // Results live in shared memory so the children can fill them in
+    harness_result *results = mmap(NULL, count * sizeof(*results), PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    uint64_t *keys = calloc(count, sizeof(*keys));
+    pid_t *pids = calloc(count, sizeof(*pids));
+    FILE **reports = calloc(count, sizeof(*reports));
+    int *selected = calloc(count, sizeof(*selected));
+    int *passed = calloc(count, sizeof(*passed));
+    if (results == MAP_FAILED || keys == NULL || pids == NULL || reports == NULL ||
+        selected == NULL || passed == NULL) {
+        perror("symbolic_run");
+        return 2;
+    }
+    memset(results, 0, count * sizeof(*results));
+    for (size_t k = 0; k < count; k++) {
+        selected[k] = first_name == argc;
+        for (i = first_name; i < argc && !selected[k]; i++) {
+            selected[k] = strcmp(argv[i], harnesses[k].name) == 0;
+        }
+        keys[k] = cache_key(hashes_path, &harnesses[k], max_inputs);
+    }
+    read_cache(cache_path, harnesses, count, keys, results);
+
+    double started = now_millis();
+    size_t next = 0, printed = 0, running = 0;
+    size_t passed_count = 0, failed_count = 0, cached_count = 0;
+
+    printf("Bounded checker: at most %" PRIu64 " inputs per harness, %ld jobs\n\n", max_inputs,
+           jobs);
+    // Harnesses start in table order, up to jobs at once; reports are
+    // printed in table order as soon as every earlier one is in
+    while (printed < count) {
+        while (next < count && running < (size_t)jobs) {
+            size_t k = next++;
+            if (!selected[k] || results[k].cached) {
+                continue;
+            }
+            reports[k] = tmpfile();
+            pids[k] = reports[k] != NULL ? start_harness(&harnesses[k], max_inputs, &results[k],
+                                                         reports[k]) : -1;
+            if (pids[k] < 0) {
+                perror(harnesses[k].name);
+                return 2;
+            }
+            running++;
+        }
+        while (printed < count && (!selected[printed] || results[printed].cached ||
+                                   (pids[printed] == 0 && reports[printed] != NULL))) {
+            size_t k = printed++;
+            if (!selected[k]) {
+                continue;
+            }
+            if (results[k].cached) {
+                print_result(&harnesses[k], &results[k]);
+                passed[k] = 1;
+                cached_count++;
+            } else {
+                copy_report(reports[k]);
+                reports[k] = NULL;
+            }
+            if (passed[k]) {
+                passed_count++;
+            } else {
+                failed_count++;
+            }
+        }
+        if (running > 0) {
+            int status;
+            pid_t pid = wait(&status);
+            for (size_t k = 0; k < count && pid > 0; k++) {
+                if (pids[k] != pid) {
+                    continue;
+                }
+                pids[k] = 0;
+                passed[k] = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                if (WIFSIGNALED(status)) {
+                    fprintf(reports[k], "✗ %s: checker died of signal %d\n", harnesses[k].name,
+                            WTERMSIG(status));
+                } else if (WEXITSTATUS(status) > 1) {
+                    fprintf(reports[k], "✗ %s: harness exited with status %d\n",
+                            harnesses[k].name, WEXITSTATUS(status));
+                }
+                running--;
+            }
+        }
+    }
+    fflush(stdout);
+
+    printf("\nHarnesses: %zu passed (%zu cached), %zu failed in %.0f ms\n", passed_count,
+           cached_count, failed_count, now_millis() - started);
+    if (cache_path != NULL) {
+        // Harnesses not run this time keep their cache entries
+        for (size_t k = 0; k < count; k++) {
+            passed[k] |= !selected[k] && results[k].cached;
+        }
+        write_cache(cache_path, harnesses, count, keys, results, passed);
+    }
+    munmap(results, count * sizeof(*results));
+    free(keys);
+    free(pids);
+    free(reports);
+    free(selected);
+    free(passed);
+    return failed_count == 0 ? 0 : 1;
+}
@@ -0,0 +1,315 @@
+// kill_mutants - symbolic-execution-driven killing of surviving mutants
+//
+// Linked against the mutant schemata object (mutagen) and the bounded
+// checker. For every mutant that survived the last mutation_runner run
+// (RESULTS_TSV), in a function of checked_functions.h, it checks a
+// differential harness: the function's arguments are symbolic and
+// klee_assert requires the original (mutation_active_id 0) and the mutant
+// to return the same result. Then:
+//   killed      the first inputs where they differ become a concrete
+//               TEST(...), passing on math_utils.c and failing on the
+//               mutant, written to TESTS_OUT for the function's TEST_GROUP
+//               in tests/mutation/test_mutation.c
+//   equivalent  no difference, with every input's domain the whole int
+//               range: proved, and appended to EQUIVALENT_TSV as
+//                 id<TAB>symbolic<TAB>0
+//   undecided   no difference within the bounded domain
+//
+// Each mutant is checked in a forked child, so a mutant that hangs only
+// costs its time budget. IDs on the command line are checked whatever
+// their status.
+//
+// Usage: kill_mutants [--max-inputs N] [--seconds N] [--tests TESTS_OUT]
+//                     [--equivalent EQUIVALENT_TSV] MUTANTS_TSV RESULTS_TSV [ID...]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "checked_functions.h"
+#include "symbolic.h"
+
+#include <klee/klee.h>
+
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define DEFAULT_SECONDS 30
+#define MAX_SURVIVORS 1024
+
+// Defined by the mutant schemata; selects the mutant every dispatcher runs
+extern int mutation_active_id;
+
+typedef struct {
+    int id;
+    char function[64];
+    char site[128];         // file:line
+    char original[8];
+    char replacement[8];
+} survivor;
+
+// Mutant under check, in the child
+static const checked_function *target;
+static int target_id;
+
+static void differential_harness(void) {
+    int a, b = 0;
+    int out[2] = {0, 0};
+    int result[2];
+
+    klee_make_symbolic(&a, sizeof(a), "a");
+    if (checked_arity(target) == 2) {
+        klee_make_symbolic(&b, sizeof(b), "b");
+    }
+    for (int k = 0; k < 2; k++) {
+        mutation_active_id = k == 0 ? 0 : target_id;
+        result[k] = call_checked(target, a, b, &out[k]);
+    }
+    mutation_active_id = 0;
+    klee_assert(result[0] == result[1] && out[0] == out[1]);
+}
+
+// Runs the differential harness for one mutant in a child. Returns 0 with
+// the outcome, -1 when the child hung or died.
+static int check_mutant(const checked_function *f, int id, uint64_t max_inputs,
+                        unsigned seconds, symbolic_outcome *out) {
+    int fds[2], status;
+    ssize_t got = 0;
+    pid_t pid;
+
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        symbolic_harness h = {"differential", differential_harness, "differential_harness",
+                              seconds};
+        symbolic_outcome o;
+
+        close(fds[0]);
+        // The checker stops at its budget between runs; this catches a
+        // mutant stuck inside one
+        alarm(2 * seconds + 5);
+        target = f;
+        target_id = id;
+        if (symbolic_check(&h, max_inputs, &o) != 0 || write(fds[1], &o, sizeof(o)) != sizeof(o)) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        got = read(fds[0], out, sizeof(*out));
+        waitpid(pid, &status, 0);
+    }
+    close(fds[0]);
+    return got == (ssize_t)sizeof(*out) ? 0 : -1;
+}
+
+// The type edges by name, as test_mutation.c writes them
+static const char *int_literal(int v, char *buf, size_t size) {
+    if (v == INT_MIN) {
+        snprintf(buf, size, "INT_MIN");
+    } else if (v == INT_MIN + 1) {
+        snprintf(buf, size, "INT_MIN + 1");
+    } else if (v == INT_MAX) {
+        snprintf(buf, size, "INT_MAX");
+    } else if (v == INT_MAX - 1) {
+        snprintf(buf, size, "INT_MAX - 1");
+    } else {
+        snprintf(buf, size, "%d", v);
+    }
+    return buf;
+}
+
+// TEST(...) that holds for math_utils.c on (a, b), in the wording of
+// tests/mutation/test_mutation.c
+static void write_test(FILE *out, const checked_function *f, int a, int b) {
+    char args[64], va[16], vb[16], vr[16];
+    int value = 0, result;
+
+    mutation_active_id = 0;
+    result = call_checked(f, a, b, &value);
+    if (checked_arity(f) == 2) {
+        snprintf(args, sizeof(args), "%s, %s", int_literal(a, va, sizeof(va)),
+                 int_literal(b, vb, sizeof(vb)));
+    } else {
+        snprintf(args, sizeof(args), "%s", int_literal(a, va, sizeof(va)));
+    }
+
+    if (f->unary != NULL || f->binary != NULL) {
+        int_literal(result, vr, sizeof(vr));
+        fprintf(out, "TEST(\"%s(%s) == %s\", %s(%s) == %s);\n", f->name, args, vr, f->name, args,
+                vr);
+    } else if (result == MATH_OK) {
+        int_literal(value, vr, sizeof(vr));
+        fprintf(out, "TEST(\"%s(%s) == %s\", %s(%s, &out) == MATH_OK && out == %s);\n", f->name,
+                args, vr, f->name, args, vr);
+    } else if (result == MATH_ERR_OVERFLOW) {
+        fprintf(out, "TEST(\"%s(%s) overflows\", %s(%s, &out) == MATH_ERR_OVERFLOW);\n", f->name,
+                args, f->name, args);
+    } else {
+        fprintf(out, "TEST(\"%s(%s) is a domain error\", %s(%s, &out) == MATH_ERR_DOMAIN);\n",
+                f->name, args, f->name, args);
+    }
+}
+
+// Survivors from RESULTS_TSV (or the IDs given), described by MUTANTS_TSV
+static size_t read_survivors(const char *mutants_path, const char *results_path, char **ids,
+                             int id_count, survivor *out) {
+    FILE *in = fopen(results_path, "r");
+    int wanted[MAX_SURVIVORS];
+    size_t wanted_count = 0, count = 0;
+    char line[1024];
+
+    for (int i = 0; i < id_count && wanted_count < MAX_SURVIVORS; i++) {
+        wanted[wanted_count++] = atoi(ids[i]);
+    }
+    while (id_count == 0 && in != NULL && fgets(line, sizeof(line), in) != NULL) {
+        int id;
+        char status[32];
+        if (line[0] != '#' && sscanf(line, "%d\t%31[^\t]", &id, status) == 2 &&
+            strcmp(status, "survived") == 0 && wanted_count < MAX_SURVIVORS) {
+            wanted[wanted_count++] = id;
+        }
+    }
+    if (in != NULL) {
+        fclose(in);
+    } else if (id_count == 0) {
+        perror(results_path);
+        return 0;
+    }
+
+    in = fopen(mutants_path, "r");
+    if (in == NULL) {
+        perror(mutants_path);
+        return 0;
+    }
+    while (fgets(line, sizeof(line), in) != NULL) {
+        survivor s;
+        char file[96];
+        int line_no;
+        if (line[0] == '#' ||
+            sscanf(line, "%d\t%63[^\t]\t%95[^\t]\t%d\t%*d\t%*[^\t]\t%7[^\t]\t%7[^\t]", &s.id,
+                   s.function, file, &line_no, s.original, s.replacement) != 6) {
+            continue;
+        }
+        for (size_t i = 0; i < wanted_count; i++) {
+            if (wanted[i] == s.id) {
+                snprintf(s.site, sizeof(s.site), "%s:%d", file, line_no);
+                out[count++] = s;
+                break;
+            }
+        }
+    }
+    fclose(in);
+    return count;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "Usage: %s [--max-inputs N] [--seconds N] [--tests TESTS_OUT]\n"
+            "       [--equivalent EQUIVALENT_TSV] MUTANTS_TSV RESULTS_TSV [ID...]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    static survivor survivors[MAX_SURVIVORS];
+    const char *tests_path = NULL, *equivalent_path = NULL;
+    uint64_t max_inputs = 0;
+    unsigned seconds = DEFAULT_SECONDS;
+    size_t killed = 0, equivalent = 0, undecided = 0;
+    FILE *tests = NULL, *equivalents = NULL;
+    int i;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "--max-inputs") == 0 && i + 1 < argc) {
+            max_inputs = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--tests") == 0 && i + 1 < argc) {
+            tests_path = argv[++i];
+        } else if (strcmp(argv[i], "--equivalent") == 0 && i + 1 < argc) {
+            equivalent_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (argc - i < 2 || seconds == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    size_t count = read_survivors(argv[i], argv[i + 1], argv + i + 2, argc - i - 2, survivors);
+    if (tests_path != NULL && (tests = fopen(tests_path, "w")) == NULL) {
+        perror(tests_path);
+        return 1;
+    }
+    if (equivalent_path != NULL && (equivalents = fopen(equivalent_path, "a")) == NULL) {
+        perror(equivalent_path);
+        return 1;
+    }
+    if (tests != NULL) {
+        fprintf(tests, "// Generated by kill_mutants: each TEST holds for math_utils.c and fails\n"
+                       "// on the mutant above it. Add them to the function's TEST_GROUP in\n"
+                       "// tests/mutation/test_mutation.c (checked_* tests use `int out`).\n");
+    }
+
+    printf("Symbolic mutant killing: %zu mutants\n\n", count);
+    for (size_t k = 0; k < count; k++) {
+        const survivor *s = &survivors[k];
+        const checked_function *f = find_checked_function(s->function);
+        symbolic_outcome o;
+
+        printf("%d %s (%s, %s → %s): ", s->id, s->function, s->site, s->original,
+               s->replacement);
+        if (f == NULL) {
+            printf("skipped, no signature in checked_functions.h\n");
+            undecided++;
+        } else if (check_mutant(f, s->id, max_inputs, seconds, &o) != 0) {
+            printf("gave up, the mutant hung or crashed the checker\n");
+            undecided++;
+        } else if (o.failed > 0) {
+            printf("killed by ");
+            write_test(stdout, f, (int)o.inputs[0], (int)o.inputs[1]);
+            if (tests != NULL) {
+                fprintf(tests, "\n// Mutant %d: %s, %s, %s -> %s\n", s->id, s->function, s->site,
+                        s->original, s->replacement);
+                write_test(tests, f, (int)o.inputs[0], (int)o.inputs[1]);
+            }
+            killed++;
+        } else if (o.exhaustive) {
+            printf("equivalent, no difference on any of the %llu inputs\n",
+                   (unsigned long long)o.runs);
+            if (equivalents != NULL) {
+                fprintf(equivalents, "%d\tsymbolic\t0\n", s->id);
+            }
+            equivalent++;
+        } else {
+            printf("undecided, no difference on %llu inputs%s\n", (unsigned long long)o.runs,
+                   o.stopped ? " (time budget reached)" : "");
+            undecided++;
+        }
+    }
+
+    printf("\nKilled: %zu, equivalent: %zu, undecided: %zu\n", killed, equivalent, undecided);
+    if (tests != NULL) {
+        if (fclose(tests) != 0) {
+            perror(tests_path);
+            return 1;
+        }
+        if (killed > 0) {
+            printf("Tests: %s\n", tests_path);
+        }
+    }
+    if (equivalents != NULL && fclose(equivalents) != 0) {
+        perror(equivalent_path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef KLEE_H
+#define KLEE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Stand-in for KLEE's <klee/klee.h>, implemented by the bounded checker
+// (tests/symbolic/bounded.c) so the harnesses build with the normal
+// compiler. Same calls, concrete semantics:
+//   klee_make_symbolic  stores the value the checker picked for this input
+//                       on the current run
+//   klee_assume         ends the run, uncounted, when the condition is false
+//   klee_assert         ends the run as a failure, recording the inputs
+//   klee_silent_exit    ends the run without a failure
+// Only the calls the harnesses use are provided.
+
+void klee_make_symbolic(void *addr, size_t nbytes, const char *name);
+void klee_assume(uintptr_t condition);
+void klee_silent_exit(int status) __attribute__((noreturn));
+
+// A fresh symbolic int, and one in [begin, end)
+int klee_int(const char *name);
+int klee_range(int begin, int end, const char *name);
+
+void klee_assert_fail(const char *expr, const char *file, unsigned line, const char *function)
+    __attribute__((noreturn));
+
+#define klee_assert(expr) \
+    ((expr) ? (void)0 : klee_assert_fail(#expr, __FILE__, __LINE__, __func__))
+
+#endif // KLEE_H
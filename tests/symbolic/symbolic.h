@@ -0,0 +1,62 @@
+#ifndef SYMBOLIC_H
+#define SYMBOLIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Symbolic harness table, shared by the two backends.
+//
+// test_symbolic.c lists its harnesses and hands them to symbolic_run, which
+// each backend defines:
+//   klee_run.c  under KLEE: every harness runs once, with its inputs
+//               symbolic, and KLEE forks a state per feasible path.
+//               test_symbolic.sh skips it and starts KLEE at each
+//               harness function instead.
+//   bounded.c   the local bounded checker: every harness runs natively,
+//               once per assignment of a bounded domain to its inputs
+//               (see shim/klee/klee.h).
+
+// Time budget of a harness without its own
+#define SYMBOLIC_DEFAULT_SECONDS 30
+
+// Every harness is its own entry point: KLEE runs each one separately
+// (--entry-point) and the bounded checker in its own process, both with
+// the harness's time budget
+typedef struct {
+    const char *name;
+    void (*run)(void);
+    const char *entry;      // name of the harness function
+    unsigned seconds;       // time budget; 0 = SYMBOLIC_DEFAULT_SECONDS
+} symbolic_harness;
+
+// Table entry for the harness function test_<name>_symbolic
+#define SYMBOLIC_HARNESS(name, seconds) \
+    {#name, test_##name##_symbolic, "test_" #name "_symbolic", seconds}
+
+// Runs the harnesses selected by the command line (all by default).
+// Returns 0 when no assertion failed, 1 otherwise, 2 on usage errors.
+int symbolic_run(const symbolic_harness *harnesses, size_t count, int argc, char **argv);
+
+// ========== Bounded checker only ==========
+
+#define SYMBOLIC_MAX_INPUTS 8
+
+// What one check found: the first inputs that failed an assertion or
+// trapped, in the order the harness made them symbolic
+typedef struct {
+    uint64_t runs;
+    uint64_t feasible;
+    uint64_t failed;
+    int exhaustive;         // every input's domain was its whole type
+    int stopped;            // ran out of its time budget
+    size_t input_count;
+    const char *names[SYMBOLIC_MAX_INPUTS];
+    int64_t inputs[SYMBOLIC_MAX_INPUTS];    // valid when failed > 0
+} symbolic_outcome;
+
+// Checks one harness in this process, over at most max_inputs inputs
+// (0: the default). Returns 0 when it ran, -1 when its inputs cannot be
+// enumerated. The names stay valid until the next check.
+int symbolic_check(const symbolic_harness *h, uint64_t max_inputs, symbolic_outcome *out);
+
+#endif // SYMBOLIC_H
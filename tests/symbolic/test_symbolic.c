@@ -3,9 +3,11 @@
 #include <assert.h>
 #include <limits.h>
 #include "math_utils.h"
+#include "symbolic.h"
 
 // Symbolic Execution Testing with KLEE
-// Tests code paths and finds edge cases automatically
+// Tests code paths and finds edge cases automatically. Runs under KLEE
+// (test_symbolic.sh) or the local bounded checker (make symbolic-run).
 
 // ========== Test 1: add() with symbolic inputs ==========
 void test_add_symbolic() {
@@ -69,6 +71,10 @@ void test_abs_symbolic() {
     int a;
     klee_make_symbolic(&a, sizeof(a), "a");
 
+    // -INT_MIN does not fit in an int: abs_value(INT_MIN) wraps to INT_MIN
+    // (saturating_abs_value and checked_abs_value handle it)
+    klee_assume(a != INT_MIN);
+
     int result = abs_value(a);
 
     // Property 1: Result is non-negative
@@ -200,8 +206,8 @@ void test_factorial_symbolic() {
         klee_assert(result >= 1);
     }
 
-    // Property 5: factorial(n) > n for n >= 2
-    if (n >= 2) {
+    // Property 5: factorial(n) > n for n >= 3 (2! == 2)
+    if (n >= 3) {
         klee_assert(result > n);
     }
 }
@@ -275,30 +281,39 @@ void test_multiply_distributivity_symbolic() {
     klee_assert(left == right);
 }
 
+// ========== Harness Table ==========
+// Run by symbolic_run: under KLEE (klee_run.c) or the local bounded
+// checker (bounded.c). The number is each harness's time budget in
+// seconds; test_symbolic.sh reads it from here for KLEE's --max-time.
+static const symbolic_harness harnesses[] = {
+    SYMBOLIC_HARNESS(add, 10),
+    SYMBOLIC_HARNESS(subtract, 10),
+    SYMBOLIC_HARNESS(multiply, 10),
+    SYMBOLIC_HARNESS(abs, 10),
+    SYMBOLIC_HARNESS(max, 30),
+    SYMBOLIC_HARNESS(min, 30),
+    SYMBOLIC_HARNESS(is_even, 10),
+    SYMBOLIC_HARNESS(is_positive, 10),
+    SYMBOLIC_HARNESS(factorial, 10),
+    SYMBOLIC_HARNESS(fibonacci, 10),
+    SYMBOLIC_HARNESS(add_commutativity, 30),
+    SYMBOLIC_HARNESS(multiply_distributivity, 60),
+};
+
 // ========== Main Entry Point ==========
-int main() {
+int main(int argc, char **argv) {
     printf("========================================\n");
     printf("  KLEE Symbolic Execution Test Suite\n");
     printf("========================================\n\n");
 
-    // Run all symbolic tests
-    test_add_symbolic();
-    test_subtract_symbolic();
-    test_multiply_symbolic();
-    test_abs_symbolic();
-    test_max_symbolic();
-    test_min_symbolic();
-    test_is_even_symbolic();
-    test_is_positive_symbolic();
-    test_factorial_symbolic();
-    test_fibonacci_symbolic();
-    test_add_commutativity_symbolic();
-    test_multiply_distributivity_symbolic();
-
-    printf("\n========================================\n");
-    printf("All symbolic tests passed!\n");
-    printf("========================================\n\n");
+    int status = symbolic_run(harnesses, sizeof(harnesses) / sizeof(harnesses[0]), argc, argv);
+
+    if (status == 0) {
+        printf("\n========================================\n");
+        printf("All symbolic tests passed!\n");
+        printf("========================================\n\n");
+    }
 
-    klee_silent_exit(0);
-    return 0;
+    klee_silent_exit(status);
+    return status;
 }
@@ -0,0 +1,839 @@
+// mutagen - mutant-schemata generator for the mutation engine
+//
+// Reads a C source file, finds every mutation site inside its function
+// bodies and writes one "schemata" translation unit holding all mutants at
+// once: each mutated function is emitted as the original plus one renamed
+// copy per mutant, and the original name becomes a dispatcher that calls
+// the copy selected at run time by MUTANT_ID (0 runs the original code).
+// A tab-separated mutant list is written alongside for mutation_runner:
+// one line per mutant with its stable ID, function, site (file, line,
+// column), the original and replacement operator, and a hash of the code
+// the mutant's behaviour depends on (see function_hashes) for the
+// mutation_runner result cache.
+//
+// With --hashes, writes only those hashes, one line per function of the
+// SOURCE files (read as one translation unit), for caches of other tools:
+//   function<TAB>code_hash
+// The CONTEXT files are hashed into every function's hash as raw text.
+//
+// Usage: mutagen SOURCE SCHEMATA_OUT MUTANTS_OUT
+//        mutagen --hashes OUT SOURCE... [-- CONTEXT...]
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    TOK_IDENT,
+    TOK_NUMBER,
+    TOK_STRING,
+    TOK_PUNCT
+} token_kind;
+
+typedef struct {
+    token_kind kind;
+    size_t offset;
+    size_t len;
+    int line;
+    int col;
+} token;
+
+typedef struct {
+    token *items;
+    size_t count;
+    size_t cap;
+} token_list;
+
+// Token indices of one function definition
+typedef struct {
+    size_t prefix;      // first token of the return type / specifiers
+    size_t name;
+    size_t open_paren;
+    size_t close_paren;
+    size_t body_open;
+    size_t body_close;
+} function_def;
+
+// Mutation operators come in families; at every binary site each
+// operator is replaced by every other member of its family, e.g. the
+// ROR family turns one `<` into `<=`, `>`, `>=`, `==` and `!=`.
+typedef struct {
+    const char *text;
+    const char *name;
+} operator_token;
+
+typedef struct {
+    const char *name;
+    const operator_token *members;
+    size_t count;
+} operator_family;
+
+static const operator_token arithmetic_operators[] = {
+    {"+", "PLUS"}, {"-", "MINUS"}, {"*", "MUL"}, {"/", "DIV"}, {"%", "MOD"}
+};
+
+static const operator_token relational_operators[] = {
+    {"<", "LT"}, {"<=", "LE"}, {">", "GT"}, {">=", "GE"}, {"==", "EQ"}, {"!=", "NEQ"}
+};
+
+static const operator_token logical_operators[] = {
+    {"&&", "AND"}, {"||", "OR"}
+};
+
+#define FAMILY(name, members) {name, members, sizeof(members) / sizeof(members[0])}
+
+static const operator_family families[] = {
+    FAMILY("AOR", arithmetic_operators),   // Arithmetic Operator Replacement
+    FAMILY("ROR", relational_operators),   // Relational Operator Replacement
+    FAMILY("LOR", logical_operators),      // Logical Operator Replacement
+};
+
+#define FAMILY_COUNT (sizeof(families) / sizeof(families[0]))
+
+// A mutant replaces one operator token. Its ID is derived from the file,
+// function, operator and the site's ordinal among same-text operators in
+// that function, so IDs stay put when unrelated code changes.
+typedef struct {
+    int id;
+    size_t function;    // index into the function list
+    size_t token;
+    const operator_family *family;
+    const operator_token *from;
+    const operator_token *to;
+} mutant;
+
+static const char *source;
+static size_t source_size;
+
+// ============ Lexer ============
+
+static const char *const punctuators[] = {
+    "<<=", ">>=", "...", "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=",
+    "&&", "||", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "##", NULL
+};
+
+typedef struct {
+    size_t pos;
+    int line;
+    int col;
+} lexer;
+
+static void advance(lexer *lx, size_t n) {
+    while (n-- > 0 && lx->pos < source_size) {
+        if (source[lx->pos] == '\n') {
+            lx->line++;
+            lx->col = 1;
+        } else {
+            lx->col++;
+        }
+        lx->pos++;
+    }
+}
+
+static int push_token(token_list *list, token tok) {
+    if (list->count == list->cap) {
+        size_t cap = list->cap ? list->cap * 2 : 256;
+        token *items = realloc(list->items, cap * sizeof(*items));
+        if (items == NULL) {
+            return -1;
+        }
+        list->items = items;
+        list->cap = cap;
+    }
+    list->items[list->count++] = tok;
+    return 0;
+}
+
+// Splits the source into tokens. Comments, whitespace and preprocessor
+// lines are skipped, so sites are only ever found in real code.
+static int tokenize(token_list *out) {
+    lexer lx = {0, 1, 1};
+    int line_start = 1;
+
+    while (lx.pos < source_size) {
+        const char *p = source + lx.pos;
+        size_t rest = source_size - lx.pos;
+        token tok = {TOK_PUNCT, lx.pos, 0, lx.line, lx.col};
+
+        if (*p == '\n') {
+            advance(&lx, 1);
+            line_start = 1;
+            continue;
+        }
+        if (isspace((unsigned char)*p)) {
+            advance(&lx, 1);
+            continue;
+        }
+        if (*p == '#' && line_start) {
+            // Preprocessor line, including backslash continuations
+            while (lx.pos < source_size && source[lx.pos] != '\n') {
+                advance(&lx, source[lx.pos] == '\\' ? 2 : 1);
+            }
+            continue;
+        }
+        line_start = 0;
+
+        if (rest >= 2 && p[0] == '/' && p[1] == '/') {
+            while (lx.pos < source_size && source[lx.pos] != '\n') {
+                advance(&lx, 1);
+            }
+            continue;
+        }
+        if (rest >= 2 && p[0] == '/' && p[1] == '*') {
+            advance(&lx, 2);
+            while (lx.pos + 1 < source_size &&
+                   !(source[lx.pos] == '*' && source[lx.pos + 1] == '/')) {
+                advance(&lx, 1);
+            }
+            advance(&lx, 2);
+            continue;
+        }
+
+        if (isalpha((unsigned char)*p) || *p == '_') {
+            tok.kind = TOK_IDENT;
+            while (lx.pos < source_size &&
+                   (isalnum((unsigned char)source[lx.pos]) || source[lx.pos] == '_')) {
+                advance(&lx, 1);
+            }
+        } else if (isdigit((unsigned char)*p) ||
+                   (*p == '.' && rest >= 2 && isdigit((unsigned char)p[1]))) {
+            tok.kind = TOK_NUMBER;
+            while (lx.pos < source_size) {
+                char c = source[lx.pos];
+                char prev = source[lx.pos - 1];
+                if (isalnum((unsigned char)c) || c == '_' || c == '.' ||
+                    ((c == '+' || c == '-') && strchr("eEpP", prev) != NULL)) {
+                    advance(&lx, 1);
+                } else {
+                    break;
+                }
+            }
+        } else if (*p == '"' || *p == '\'') {
+            char quote = *p;
+            tok.kind = TOK_STRING;
+            advance(&lx, 1);
+            while (lx.pos < source_size && source[lx.pos] != quote) {
+                advance(&lx, source[lx.pos] == '\\' ? 2 : 1);
+            }
+            advance(&lx, 1);
+        } else {
+            size_t len = 1;
+            for (size_t i = 0; punctuators[i] != NULL; i++) {
+                size_t plen = strlen(punctuators[i]);
+                if (plen <= rest && memcmp(p, punctuators[i], plen) == 0) {
+                    len = plen;
+                    break;
+                }
+            }
+            advance(&lx, len);
+        }
+
+        tok.len = lx.pos - tok.offset;
+        if (push_token(out, tok) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int token_is(const token *tok, const char *text) {
+    size_t len = strlen(text);
+    return tok->len == len && memcmp(source + tok->offset, text, len) == 0;
+}
+
+// Index of the bracket closing the one at index open, or count if unbalanced
+static size_t matching_close(const token_list *toks, size_t open) {
+    const char *open_text = token_is(&toks->items[open], "(") ? "(" : "{";
+    const char *close_text = open_text[0] == '(' ? ")" : "}";
+    int depth = 0;
+
+    for (size_t i = open; i < toks->count; i++) {
+        if (token_is(&toks->items[i], open_text)) {
+            depth++;
+        } else if (token_is(&toks->items[i], close_text) && --depth == 0) {
+            return i;
+        }
+    }
+    return toks->count;
+}
+
+// ============ Function and site discovery ============
+
+static int find_functions(const token_list *toks, function_def **out, size_t *count) {
+    size_t cap = 0;
+    size_t boundary = 0;
+    int depth = 0;
+
+    *out = NULL;
+    *count = 0;
+    for (size_t i = 0; i < toks->count; i++) {
+        const token *tok = &toks->items[i];
+
+        if (depth == 0 && tok->kind == TOK_IDENT && i + 1 < toks->count &&
+            token_is(&toks->items[i + 1], "(")) {
+            size_t close = matching_close(toks, i + 1);
+            if (close + 1 < toks->count && token_is(&toks->items[close + 1], "{")) {
+                function_def fn = {boundary, i, i + 1, close, close + 1,
+                                   matching_close(toks, close + 1)};
+                if (fn.body_close == toks->count) {
+                    return -1;
+                }
+                if (*count == cap) {
+                    cap = cap ? cap * 2 : 32;
+                    function_def *grown = realloc(*out, cap * sizeof(*grown));
+                    if (grown == NULL) {
+                        return -1;
+                    }
+                    *out = grown;
+                }
+                (*out)[(*count)++] = fn;
+                i = fn.body_close;
+                boundary = i + 1;
+                continue;
+            }
+        }
+
+        if (token_is(tok, "{")) {
+            depth++;
+        } else if (token_is(tok, "}")) {
+            depth--;
+        } else if (depth == 0 && token_is(tok, ";")) {
+            boundary = i + 1;
+        }
+    }
+    return 0;
+}
+
+// Keywords after which an operator is unary or part of a declarator
+static const char *const unary_context_keywords[] = {
+    "return", "case", "sizeof", "else", "do",
+    "void", "char", "short", "int", "long", "float", "double", "signed",
+    "unsigned", "_Bool", "const", "volatile", "static", "extern", "register",
+    "struct", "union", "enum", NULL
+};
+
+// Binary operators follow an operand: a value name, a literal, or a
+// closing bracket. Typedef names ending in _t start declarations.
+static int is_binary_site(const token_list *toks, size_t index) {
+    const token *prev = &toks->items[index - 1];
+
+    if (prev->kind == TOK_NUMBER || prev->kind == TOK_STRING) {
+        return 1;
+    }
+    if (prev->kind == TOK_PUNCT) {
+        return token_is(prev, ")") || token_is(prev, "]");
+    }
+    for (size_t i = 0; unary_context_keywords[i] != NULL; i++) {
+        if (token_is(prev, unary_context_keywords[i])) {
+            return 0;
+        }
+    }
+    return !(prev->len > 2 && memcmp(source + prev->offset + prev->len - 2, "_t", 2) == 0);
+}
+
+// Functions with variadic parameters cannot be forwarded by a dispatcher
+static int is_variadic(const token_list *toks, const function_def *fn) {
+    for (size_t i = fn->open_paren + 1; i < fn->close_paren; i++) {
+        if (token_is(&toks->items[i], "...")) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// FNV-1a, continued from h
+static uint32_t fnv1a(uint32_t h, const char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// 64-bit FNV-1a, continued from h
+static uint64_t fnv1a_64(uint64_t h, const char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211u;
+    }
+    return h;
+}
+
+#define FNV_64_BASIS 14695981039346656037u
+
+// Hashes, per function, the code a mutant of it can observe: the tokens of
+// the function and of every function of the file it calls, directly or
+// not, plus the raw text outside all function bodies (includes, macros,
+// declarations). Tokens skip whitespace and comments, so reformatting a
+// function keeps its hash; editing one function changes only the hashes of
+// that function and its callers. seed starts every hash.
+static int function_hashes(const token_list *toks, const function_def *fns, size_t fn_count,
+                           uint64_t seed, uint64_t *out) {
+    unsigned char *reaches = calloc(fn_count * fn_count + 1, 1);
+    uint64_t context = seed;
+    size_t pos = 0;
+
+    if (reaches == NULL) {
+        return -1;
+    }
+    for (size_t f = 0; f < fn_count; f++) {
+        context = fnv1a_64(context, source + pos, toks->items[fns[f].prefix].offset - pos);
+        pos = toks->items[fns[f].body_close].offset + 1;
+    }
+    context = fnv1a_64(context, source + pos, source_size - pos);
+
+    // Direct calls, then the transitive closure
+    for (size_t f = 0; f < fn_count; f++) {
+        reaches[f * fn_count + f] = 1;
+        for (size_t i = fns[f].body_open + 1; i < fns[f].body_close; i++) {
+            const token *tok = &toks->items[i];
+            for (size_t g = 0; g < fn_count && tok->kind == TOK_IDENT; g++) {
+                const token *name = &toks->items[fns[g].name];
+                if (tok->len == name->len &&
+                    memcmp(source + tok->offset, source + name->offset, tok->len) == 0) {
+                    reaches[f * fn_count + g] = 1;
+                }
+            }
+        }
+    }
+    for (size_t via = 0; via < fn_count; via++) {
+        for (size_t f = 0; f < fn_count; f++) {
+            for (size_t g = 0; g < fn_count && reaches[f * fn_count + via]; g++) {
+                reaches[f * fn_count + g] |= reaches[via * fn_count + g];
+            }
+        }
+    }
+
+    for (size_t f = 0; f < fn_count; f++) {
+        uint64_t h = context;
+        for (size_t g = 0; g < fn_count; g++) {
+            if (!reaches[f * fn_count + g]) {
+                continue;
+            }
+            for (size_t i = fns[g].prefix; i <= fns[g].body_close; i++) {
+                h = fnv1a_64(h, source + toks->items[i].offset, toks->items[i].len);
+                h = fnv1a_64(h, " ", 1);
+            }
+        }
+        out[f] = h;
+    }
+    free(reaches);
+    return 0;
+}
+
+// Stable positive ID for a mutant; collisions are resolved by rehashing,
+// which is deterministic because sites are visited in source order
+static int stable_id(const char *path, const token *name, const operator_token *from,
+                     int ordinal, const operator_token *to, const mutant *seen,
+                     size_t seen_count) {
+    const char *base = strrchr(path, '/') != NULL ? strrchr(path, '/') + 1 : path;
+    char key[512];
+    int len = snprintf(key, sizeof(key), "%s:%.*s:%s#%d:%s", base, (int)name->len,
+                       source + name->offset, from->text, ordinal, to->text);
+    uint32_t h = fnv1a(2166136261u, key, (size_t)len);
+
+    for (;;) {
+        int id = (int)(h & 0x7fffffffu);
+        int taken = id == 0;
+        for (size_t k = 0; k < seen_count && !taken; k++) {
+            taken = seen[k].id == id;
+        }
+        if (!taken) {
+            return id;
+        }
+        h = fnv1a(h, key, (size_t)len);
+    }
+}
+
+static int find_mutants(const char *path, const token_list *toks, const function_def *fns,
+                        size_t fn_count, mutant **out, size_t *count) {
+    size_t cap = 0;
+
+    *out = NULL;
+    *count = 0;
+    for (size_t f = 0; f < fn_count; f++) {
+        if (is_variadic(toks, &fns[f])) {
+            continue;
+        }
+        for (size_t i = fns[f].body_open + 1; i < fns[f].body_close; i++) {
+            const token *tok = &toks->items[i];
+            if (tok->kind != TOK_PUNCT || !is_binary_site(toks, i)) {
+                continue;
+            }
+            for (size_t fam = 0; fam < FAMILY_COUNT; fam++) {
+                const operator_family *family = &families[fam];
+                const operator_token *from = NULL;
+                for (size_t o = 0; o < family->count && from == NULL; o++) {
+                    if (token_is(tok, family->members[o].text)) {
+                        from = &family->members[o];
+                    }
+                }
+                if (from == NULL) {
+                    continue;
+                }
+
+                // Ordinal of this site among same-text operators in the body
+                int ordinal = 0;
+                for (size_t j = fns[f].body_open + 1; j < i; j++) {
+                    ordinal += token_is(&toks->items[j], from->text) && is_binary_site(toks, j);
+                }
+
+                for (size_t o = 0; o < family->count; o++) {
+                    const operator_token *to = &family->members[o];
+                    if (to == from) {
+                        continue;
+                    }
+                    if (*count == cap) {
+                        cap = cap ? cap * 2 : 64;
+                        mutant *grown = realloc(*out, cap * sizeof(*grown));
+                        if (grown == NULL) {
+                            return -1;
+                        }
+                        *out = grown;
+                    }
+                    (*out)[*count] = (mutant){
+                        stable_id(path, &toks->items[fns[f].name], from, ordinal, to,
+                                  *out, *count),
+                        f, i, family, from, to
+                    };
+                    (*count)++;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// ============ Schemata emission ============
+
+typedef struct {
+    size_t token;
+    const char *text;
+} substitution;
+
+// Writes the source text of tokens first..last, replacing the tokens
+// listed in subs (sorted by token index) with their text
+static void emit_span(FILE *out, const token_list *toks, size_t first, size_t last,
+                      const substitution *subs, size_t sub_count) {
+    size_t pos = toks->items[first].offset;
+    size_t end = toks->items[last].offset + toks->items[last].len;
+
+    for (size_t k = 0; k < sub_count; k++) {
+        const token *tok = &toks->items[subs[k].token];
+        fwrite(source + pos, 1, tok->offset - pos, out);
+        fputs(subs[k].text, out);
+        pos = tok->offset + tok->len;
+    }
+    fwrite(source + pos, 1, end - pos, out);
+}
+
+static int has_token(const token_list *toks, size_t first, size_t last, const char *text) {
+    for (size_t i = first; i <= last; i++) {
+        if (token_is(&toks->items[i], text)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Comma-separated parameter names, as used to forward a call
+static void emit_arguments(FILE *out, const token_list *toks, const function_def *fn) {
+    size_t begin = fn->open_paren + 1;
+    int depth = 0;
+    int first = 1;
+
+    if (fn->close_paren == begin ||
+        (fn->close_paren == begin + 1 && token_is(&toks->items[begin], "void"))) {
+        return;
+    }
+    for (size_t i = begin; i <= fn->close_paren; i++) {
+        const token *tok = &toks->items[i];
+        if (token_is(tok, "(") || token_is(tok, "[")) {
+            depth++;
+        } else if ((token_is(tok, ")") || token_is(tok, "]")) && i < fn->close_paren) {
+            depth--;
+        } else if (depth == 0 && (token_is(tok, ",") || i == fn->close_paren)) {
+            // The parameter name is the last identifier outside brackets
+            int bracket = 0;
+            for (size_t j = i; j-- > begin;) {
+                const token *t = &toks->items[j];
+                if (token_is(t, "]") || token_is(t, ")")) {
+                    bracket++;
+                } else if (token_is(t, "[") || token_is(t, "(")) {
+                    bracket--;
+                } else if (bracket == 0 && t->kind == TOK_IDENT) {
+                    fprintf(out, "%s%.*s", first ? "" : ", ", (int)t->len, source + t->offset);
+                    first = 0;
+                    break;
+                }
+            }
+            begin = i + 1;
+        }
+    }
+}
+
+static void emit_function_copy(FILE *out, const char *path, const token_list *toks,
+                               const function_def *fn, const char *name,
+                               const mutant *m) {
+    substitution subs[2] = {{fn->name, name}, {0, NULL}};
+    size_t sub_count = 1;
+
+    if (m != NULL) {
+        subs[1] = (substitution){m->token, m->to->text};
+        sub_count = 2;
+    }
+    fprintf(out, "\n#line %d \"%s\"\n", toks->items[fn->prefix].line, path);
+    if (!has_token(toks, fn->prefix, fn->name, "static")) {
+        fputs("static ", out);
+    }
+    emit_span(out, toks, fn->prefix, fn->body_close, subs, sub_count);
+}
+
+static void emit_dispatcher(FILE *out, const char *path, const token_list *toks,
+                            const function_def *fn, const mutant *mutants, size_t first,
+                            size_t last) {
+    const token *name = &toks->items[fn->name];
+    int returns_void = has_token(toks, fn->prefix, fn->name, "void") &&
+                       !has_token(toks, fn->prefix, fn->name, "*");
+    const char *call_prefix = returns_void ? "" : "return ";
+    const char *call_suffix = returns_void ? "\n        return;" : "";
+
+    fprintf(out, "\n#line %d \"%s\"\n", toks->items[fn->prefix].line, path);
+    emit_span(out, toks, fn->prefix, fn->close_paren, NULL, 0);
+    fputs(" {\n    switch (mutation_active_id) {\n", out);
+    for (size_t k = first; k < last; k++) {
+        fprintf(out, "    case %d:\n        %s%.*s__mutant_%d(", mutants[k].id, call_prefix,
+                (int)name->len, source + name->offset, mutants[k].id);
+        emit_arguments(out, toks, fn);
+        fprintf(out, ");%s\n", call_suffix);
+    }
+    fprintf(out, "    default:\n        %s%.*s__original(", call_prefix,
+            (int)name->len, source + name->offset);
+    emit_arguments(out, toks, fn);
+    fprintf(out, ");%s\n    }\n}\n", call_suffix);
+}
+
+static int write_schemata(const char *path, const char *out_path, const token_list *toks,
+                          const function_def *fns, const mutant *mutants, size_t mutant_count) {
+    FILE *out = fopen(out_path, "w");
+    size_t pos = 0;
+    size_t k = 0;
+    char name[256];
+
+    if (out == NULL) {
+        perror(out_path);
+        return -1;
+    }
+    fprintf(out, "// Generated by mutagen from %s; do not edit.\n", path);
+    fprintf(out, "// %zu mutants, selected at run time by MUTANT_ID (0 runs the original).\n",
+            mutant_count);
+    fputs("#include <stdlib.h>\n\n"
+          "int mutation_active_id;\n\n"
+          "__attribute__((constructor)) static void mutation_select(void) {\n"
+          "    const char *id = getenv(\"MUTANT_ID\");\n"
+          "    mutation_active_id = id != NULL ? atoi(id) : 0;\n"
+          "}\n", out);
+    fprintf(out, "#line 1 \"%s\"\n", path);
+
+    while (k < mutant_count) {
+        const function_def *fn = &fns[mutants[k].function];
+        const token *fn_name = &toks->items[fn->name];
+        size_t last = k;
+
+        while (last < mutant_count && mutants[last].function == mutants[k].function) {
+            last++;
+        }
+
+        fwrite(source + pos, 1, toks->items[fn->prefix].offset - pos, out);
+        snprintf(name, sizeof(name), "%.*s__original", (int)fn_name->len,
+                 source + fn_name->offset);
+        emit_function_copy(out, path, toks, fn, name, NULL);
+        for (size_t m = k; m < last; m++) {
+            snprintf(name, sizeof(name), "%.*s__mutant_%d", (int)fn_name->len,
+                     source + fn_name->offset, mutants[m].id);
+            emit_function_copy(out, path, toks, fn, name, &mutants[m]);
+        }
+        emit_dispatcher(out, path, toks, fn, mutants, k, last);
+        fprintf(out, "#line %d \"%s\"\n", toks->items[fn->body_close].line, path);
+
+        pos = toks->items[fn->body_close].offset + 1;
+        k = last;
+    }
+    fwrite(source + pos, 1, source_size - pos, out);
+
+    if (fclose(out) != 0) {
+        perror(out_path);
+        return -1;
+    }
+    return 0;
+}
+
+static int write_mutant_list(const char *path, const char *out_path, const token_list *toks,
+                             const function_def *fns, size_t fn_count, const mutant *mutants,
+                             size_t count) {
+    uint64_t *hashes = malloc((fn_count + 1) * sizeof(*hashes));
+    FILE *out;
+
+    if (hashes == NULL || function_hashes(toks, fns, fn_count, FNV_64_BASIS, hashes) != 0) {
+        free(hashes);
+        return -1;
+    }
+    out = fopen(out_path, "w");
+    if (out == NULL) {
+        perror(out_path);
+        free(hashes);
+        return -1;
+    }
+    fputs("# id\tfunction\tfile\tline\tcol\toperator\toriginal\treplacement\tcode_hash\n", out);
+    for (size_t k = 0; k < count; k++) {
+        const token *name = &toks->items[fns[mutants[k].function].name];
+        const token *site = &toks->items[mutants[k].token];
+        fprintf(out, "%d\t%.*s\t%s\t%d\t%d\t%s_%s_TO_%s\t%s\t%s\t%016llx\n", mutants[k].id,
+                (int)name->len, source + name->offset, path, site->line, site->col,
+                mutants[k].family->name, mutants[k].from->name, mutants[k].to->name,
+                mutants[k].from->text, mutants[k].to->text,
+                (unsigned long long)hashes[mutants[k].function]);
+    }
+    free(hashes);
+    if (fclose(out) != 0) {
+        perror(out_path);
+        return -1;
+    }
+    return 0;
+}
+
+static char *read_file(const char *path, size_t *size) {
+    FILE *in = fopen(path, "rb");
+    char *data = NULL;
+    long len;
+
+    if (in == NULL) {
+        perror(path);
+        return NULL;
+    }
+    if (fseek(in, 0, SEEK_END) == 0 && (len = ftell(in)) >= 0 &&
+        fseek(in, 0, SEEK_SET) == 0 && (data = malloc((size_t)len + 1)) != NULL) {
+        *size = fread(data, 1, (size_t)len, in);
+        data[*size] = '\0';
+    }
+    fclose(in);
+    return data;
+}
+
+// Sources joined into one buffer, each ending in a newline
+static char *join_sources(int count, char **paths, size_t *size) {
+    char *joined = NULL;
+
+    *size = 0;
+    for (int i = 0; i < count; i++) {
+        size_t len;
+        char *data = read_file(paths[i], &len);
+        char *grown = data == NULL ? NULL : realloc(joined, *size + len + 2);
+        if (grown == NULL) {
+            free(data);
+            free(joined);
+            return NULL;
+        }
+        joined = grown;
+        memcpy(joined + *size, data, len);
+        *size += len;
+        joined[(*size)++] = '\n';
+        joined[*size] = '\0';
+        free(data);
+    }
+    return joined;
+}
+
+// --hashes: the code hash of every function of the sources
+static int write_hashes(const char *out_path, int argc, char **argv) {
+    token_list toks = {NULL, 0, 0};
+    function_def *fns = NULL;
+    uint64_t *hashes = NULL;
+    uint64_t seed = FNV_64_BASIS;
+    size_t fn_count = 0;
+    int sources = 0, status = 1;
+    FILE *out;
+
+    while (sources < argc && strcmp(argv[sources], "--") != 0) {
+        sources++;
+    }
+    for (int i = sources + 1; i < argc; i++) {
+        size_t size;
+        char *data = read_file(argv[i], &size);
+        if (data == NULL) {
+            return 1;
+        }
+        seed = fnv1a_64(seed, data, size);
+        free(data);
+    }
+    source = join_sources(sources, argv, &source_size);
+    if (source == NULL) {
+        return 1;
+    }
+
+    if (tokenize(&toks) != 0 || find_functions(&toks, &fns, &fn_count) != 0 ||
+        (hashes = malloc((fn_count + 1) * sizeof(*hashes))) == NULL ||
+        function_hashes(&toks, fns, fn_count, seed, hashes) != 0) {
+        fprintf(stderr, "mutagen: failed to parse the sources\n");
+    } else if ((out = fopen(out_path, "w")) == NULL) {
+        perror(out_path);
+    } else {
+        fputs("# function\tcode_hash\n", out);
+        for (size_t f = 0; f < fn_count; f++) {
+            const token *name = &toks.items[fns[f].name];
+            fprintf(out, "%.*s\t%016llx\n", (int)name->len, source + name->offset,
+                    (unsigned long long)hashes[f]);
+        }
+        if (fclose(out) != 0) {
+            perror(out_path);
+        } else {
+            status = 0;
+        }
+    }
+
+    free(hashes);
+    free(fns);
+    free(toks.items);
+    free((char *)source);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    token_list toks = {NULL, 0, 0};
+    function_def *fns = NULL;
+    mutant *mutants = NULL;
+    size_t fn_count = 0;
+    size_t mutant_count = 0;
+    int status = 1;
+
+    if (argc >= 4 && strcmp(argv[1], "--hashes") == 0) {
+        return write_hashes(argv[2], argc - 3, argv + 3);
+    }
+    if (argc != 4) {
+        fprintf(stderr, "Usage: %s SOURCE SCHEMATA_OUT MUTANTS_OUT\n"
+                        "       %s --hashes OUT SOURCE... [-- CONTEXT...]\n", argv[0], argv[0]);
+        return 2;
+    }
+    source = read_file(argv[1], &source_size);
+    if (source == NULL) {
+        return 1;
+    }
+
+    if (tokenize(&toks) != 0 || find_functions(&toks, &fns, &fn_count) != 0 ||
+        find_mutants(argv[1], &toks, fns, fn_count, &mutants, &mutant_count) != 0) {
+        fprintf(stderr, "%s: failed to parse %s\n", argv[0], argv[1]);
+    } else if (write_schemata(argv[1], argv[2], &toks, fns, mutants, mutant_count) == 0 &&
+               write_mutant_list(argv[1], argv[3], &toks, fns, fn_count, mutants,
+                                 mutant_count) == 0) {
+        printf("%zu mutants in %zu functions of %s\n", mutant_count, fn_count, argv[1]);
+        status = 0;
+    }
+
+    free(mutants);
+    free(fns);
+    free(toks.items);
+    free((char *)source);
+    return status;
+}
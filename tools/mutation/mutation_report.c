@@ -0,0 +1,560 @@
+// mutation_report - kill matrices and timings of a mutation run
+//
+// Joins the mutant list written by mutagen with the results written by
+// mutation_runner --results and writes them as JSON and/or a standalone
+// HTML page:
+//   - per function and per operator: mutants, killed, survived, score;
+//     with --header, every function the header declares gets a row, so
+//     functions without mutants show up too
+//   - per test group: mutants reached, kills, kills no other group makes,
+//     time, and a suggested run order (greedy: most new kills per
+//     millisecond first)
+//   - per mutant: status, time and, when the run used --matrix, the result
+//     of every group reaching it (the test-to-mutant kill matrix)
+//
+// Usage: mutation_report [--header FILE] [--json FILE] [--html FILE]
+//                        MUTANTS_TSV RESULTS_TSV
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_GROUPS 64
+#define MAX_FUNCTIONS 256
+#define MAX_OPERATORS 64
+
+typedef enum {
+    CELL_NONE,          // group does not reach the mutant, or did not run alone
+    CELL_SURVIVED,
+    CELL_KILLED,
+    CELL_TIMEOUT
+} cell;
+
+typedef struct {
+    int id;
+    char function[64];
+    char site[300];
+    char op[32];
+    char original[8];
+    char replacement[8];
+    char status[16];
+    double millis;
+    cell cells[MAX_GROUPS];     // indexed like groups
+} mutant;
+
+typedef struct {
+    char name[64];
+    size_t reached;
+    size_t kills;
+    size_t unique_kills;
+    double millis;
+    size_t order;       // 1-based position in the suggested run order, 0 if never useful
+} group;
+
+typedef struct {
+    char name[64];
+    size_t total[MAX_OPERATORS];
+    size_t killed[MAX_OPERATORS];
+    size_t mutants, killed_all, survived, uncovered, equivalent;
+} function_row;
+
+static mutant *mutants;
+static size_t mutant_count;
+static group groups[MAX_GROUPS];
+static size_t group_count;
+static function_row functions[MAX_FUNCTIONS];
+static size_t function_count;
+static char operators[MAX_OPERATORS][32];
+static size_t operator_count;
+
+static int is_detected(const mutant *m) {
+    return strcmp(m->status, "killed") == 0 || strcmp(m->status, "timeout") == 0;
+}
+
+static size_t find_group(const char *name) {
+    size_t g = 0;
+    while (g < group_count && strcmp(groups[g].name, name) != 0) {
+        g++;
+    }
+    if (g == group_count && group_count < MAX_GROUPS) {
+        memset(&groups[g], 0, sizeof(groups[g]));
+        snprintf(groups[g].name, sizeof(groups[g].name), "%s", name);
+        group_count++;
+    }
+    return g;
+}
+
+static function_row *find_function(const char *name) {
+    for (size_t f = 0; f < function_count; f++) {
+        if (strcmp(functions[f].name, name) == 0) {
+            return &functions[f];
+        }
+    }
+    if (function_count == MAX_FUNCTIONS) {
+        return NULL;
+    }
+    function_row *row = &functions[function_count++];
+    memset(row, 0, sizeof(*row));
+    snprintf(row->name, sizeof(row->name), "%s", name);
+    return row;
+}
+
+static size_t find_operator(const char *name) {
+    size_t o = 0;
+    while (o < operator_count && strcmp(operators[o], name) != 0) {
+        o++;
+    }
+    if (o == operator_count && operator_count < MAX_OPERATORS) {
+        snprintf(operators[o], sizeof(operators[o]), "%s", name);
+        operator_count++;
+    }
+    return o;
+}
+
+// ============ Input ============
+
+static int read_mutants(const char *path) {
+    FILE *in = fopen(path, "r");
+    char line[1024];
+    size_t cap = 0;
+
+    if (in == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), in) != NULL) {
+        mutant m;
+        char file[256];
+        int line_number, col;
+
+        memset(&m, 0, sizeof(m));
+        if (line[0] == '#' ||
+            sscanf(line, "%d\t%63[^\t]\t%255[^\t]\t%d\t%d\t%31[^\t]\t%7[^\t]\t%7[^\t\n]", &m.id,
+                   m.function, file, &line_number, &col, m.op, m.original, m.replacement) != 8) {
+            continue;
+        }
+        snprintf(m.site, sizeof(m.site), "%s:%d:%d", file, line_number, col);
+        snprintf(m.status, sizeof(m.status), "pending");
+        if (mutant_count == cap) {
+            cap = cap ? cap * 2 : 64;
+            mutant *grown = realloc(mutants, cap * sizeof(*grown));
+            if (grown == NULL) {
+                fclose(in);
+                return -1;
+            }
+            mutants = grown;
+        }
+        mutants[mutant_count++] = m;
+    }
+    fclose(in);
+    return 0;
+}
+
+static cell parse_cell(const char *status) {
+    return strcmp(status, "killed") == 0 ? CELL_KILLED :
+           strcmp(status, "timeout") == 0 ? CELL_TIMEOUT : CELL_SURVIVED;
+}
+
+static int read_results(const char *path) {
+    FILE *in = fopen(path, "r");
+    char line[16384];
+
+    if (in == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), in) != NULL) {
+        int id, groups_at = 0;
+        char status[16];
+        double millis;
+        mutant *m = NULL;
+
+        if (line[0] == '#' ||
+            sscanf(line, "%d\t%15[^\t]\t%lf\t%n", &id, status, &millis, &groups_at) != 3) {
+            continue;
+        }
+        for (size_t i = 0; i < mutant_count && m == NULL; i++) {
+            m = mutants[i].id == id ? &mutants[i] : NULL;
+        }
+        if (m == NULL) {
+            continue;
+        }
+        snprintf(m->status, sizeof(m->status), "%s", status);
+        m->millis = millis;
+        if (groups_at == 0 || line[groups_at] == '-') {
+            continue;
+        }
+        for (char *entry = strtok(line + groups_at, ",\n"); entry != NULL;
+             entry = strtok(NULL, ",\n")) {
+            char name[64], group_status[16];
+            double group_millis;
+            if (sscanf(entry, "%63[^:]:%15[^:]:%lf", name, group_status, &group_millis) == 3) {
+                size_t g = find_group(name);
+                if (g < MAX_GROUPS) {
+                    m->cells[g] = parse_cell(group_status);
+                    groups[g].millis += group_millis;
+                }
+            }
+        }
+    }
+    fclose(in);
+    return 0;
+}
+
+// Rows for every function declared in the header, in header order: lines
+// that start a declaration and end in ");", named by the identifier
+// before their first "("
+static int read_header(const char *path) {
+    FILE *in = fopen(path, "r");
+    char line[1024];
+
+    if (in == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), in) != NULL) {
+        char *paren = strchr(line, '(');
+        char *end = paren;
+        char name[64];
+
+        if (paren == NULL || strstr(line, ");") == NULL || line[0] == '/' || line[0] == '#' ||
+            line[0] == ' ' || line[0] == '\t' || strncmp(line, "typedef", 7) == 0) {
+            continue;
+        }
+        while (end > line && end[-1] == ' ') {
+            end--;
+        }
+        char *start = end;
+        while (start > line && (start[-1] == '_' || (start[-1] >= 'a' && start[-1] <= 'z') ||
+                                (start[-1] >= 'A' && start[-1] <= 'Z') ||
+                                (start[-1] >= '0' && start[-1] <= '9'))) {
+            start--;
+        }
+        if (start < end && (size_t)(end - start) < sizeof(name)) {
+            snprintf(name, sizeof(name), "%.*s", (int)(end - start), start);
+            find_function(name);
+        }
+    }
+    fclose(in);
+    return 0;
+}
+
+// ============ Aggregation ============
+
+static void aggregate(void) {
+    for (size_t i = 0; i < mutant_count; i++) {
+        const mutant *m = &mutants[i];
+        function_row *row = find_function(m->function);
+        size_t o = find_operator(m->op);
+        int detected = is_detected(m);
+
+        if (row == NULL || o == MAX_OPERATORS) {
+            continue;
+        }
+        row->mutants++;
+        if (strcmp(m->status, "equivalent") == 0) {
+            row->equivalent++;
+            continue;
+        }
+        row->total[o]++;
+        row->killed[o] += detected;
+        row->killed_all += detected;
+        row->survived += strcmp(m->status, "survived") == 0;
+        row->uncovered += strcmp(m->status, "uncovered") == 0;
+
+        size_t killers = 0, killer = 0;
+        for (size_t g = 0; g < group_count; g++) {
+            if (m->cells[g] == CELL_NONE) {
+                continue;
+            }
+            groups[g].reached++;
+            if (m->cells[g] != CELL_SURVIVED) {
+                groups[g].kills++;
+                killers++;
+                killer = g;
+            }
+        }
+        if (killers == 1) {
+            groups[killer].unique_kills++;
+        }
+    }
+
+    // Greedy run order: the group killing the most mutants not yet killed
+    // per millisecond goes next
+    unsigned char *killed = calloc(mutant_count + 1, 1);
+    for (size_t position = 1; killed != NULL; position++) {
+        size_t best = group_count;
+        double best_rate = 0;
+        for (size_t g = 0; g < group_count; g++) {
+            size_t fresh = 0;
+            if (groups[g].order != 0) {
+                continue;
+            }
+            for (size_t i = 0; i < mutant_count; i++) {
+                fresh += !killed[i] && mutants[i].cells[g] >= CELL_KILLED;
+            }
+            double rate = (double)fresh / (groups[g].millis > 1e-3 ? groups[g].millis : 1e-3);
+            if (fresh > 0 && rate > best_rate) {
+                best = g;
+                best_rate = rate;
+            }
+        }
+        if (best == group_count) {
+            break;
+        }
+        groups[best].order = position;
+        for (size_t i = 0; i < mutant_count; i++) {
+            killed[i] |= mutants[i].cells[best] >= CELL_KILLED;
+        }
+    }
+    free(killed);
+}
+
+static double percent(size_t part, size_t whole) {
+    return whole > 0 ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+// ============ JSON ============
+
+static int write_json(const char *path) {
+    FILE *out = fopen(path, "w");
+    size_t detected = 0, scored = 0;
+    double millis = 0;
+
+    if (out == NULL) {
+        perror(path);
+        return -1;
+    }
+    for (size_t i = 0; i < mutant_count; i++) {
+        detected += is_detected(&mutants[i]);
+        scored += strcmp(mutants[i].status, "equivalent") != 0;
+        millis += mutants[i].millis;
+    }
+    fprintf(out, "{\n  \"summary\": {\"mutants\": %zu, \"detected\": %zu, \"scored\": %zu, "
+            "\"score\": %.1f, \"millis\": %.3f},\n", mutant_count, detected, scored,
+            percent(detected, scored), millis);
+
+    fprintf(out, "  \"functions\": [");
+    for (size_t f = 0; f < function_count; f++) {
+        const function_row *row = &functions[f];
+        size_t scored_row = row->mutants - row->equivalent;
+        fprintf(out, "%s\n    {\"name\": \"%s\", \"mutants\": %zu, \"detected\": %zu, "
+                "\"survived\": %zu, \"uncovered\": %zu, \"equivalent\": %zu, \"score\": %.1f, "
+                "\"operators\": {", f ? "," : "", row->name, row->mutants, row->killed_all,
+                row->survived, row->uncovered, row->equivalent,
+                percent(row->killed_all, scored_row));
+        int first = 1;
+        for (size_t o = 0; o < operator_count; o++) {
+            if (row->total[o] > 0) {
+                fprintf(out, "%s\"%s\": {\"mutants\": %zu, \"detected\": %zu}", first ? "" : ", ",
+                        operators[o], row->total[o], row->killed[o]);
+                first = 0;
+            }
+        }
+        fprintf(out, "}}");
+    }
+    fprintf(out, "\n  ],\n");
+
+    fprintf(out, "  \"groups\": [");
+    for (size_t g = 0; g < group_count; g++) {
+        fprintf(out, "%s\n    {\"name\": \"%s\", \"reached\": %zu, \"kills\": %zu, "
+                "\"unique_kills\": %zu, \"millis\": %.3f, \"run_order\": %zu}", g ? "," : "",
+                groups[g].name, groups[g].reached, groups[g].kills, groups[g].unique_kills,
+                groups[g].millis, groups[g].order);
+    }
+    fprintf(out, "\n  ],\n");
+
+    static const char *const cell_names[] = {"", "survived", "killed", "timeout"};
+    fprintf(out, "  \"mutants\": [");
+    for (size_t i = 0; i < mutant_count; i++) {
+        const mutant *m = &mutants[i];
+        fprintf(out, "%s\n    {\"id\": %d, \"function\": \"%s\", \"site\": \"%s\", "
+                "\"operator\": \"%s\", \"original\": \"%s\", \"replacement\": \"%s\", "
+                "\"status\": \"%s\", \"millis\": %.3f, \"groups\": {", i ? "," : "", m->id,
+                m->function, m->site, m->op, m->original, m->replacement, m->status, m->millis);
+        int first = 1;
+        for (size_t g = 0; g < group_count; g++) {
+            if (m->cells[g] != CELL_NONE) {
+                fprintf(out, "%s\"%s\": \"%s\"", first ? "" : ", ", groups[g].name,
+                        cell_names[m->cells[g]]);
+                first = 0;
+            }
+        }
+        fprintf(out, "}}");
+    }
+    fprintf(out, "\n  ]\n}\n");
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+// ============ HTML ============
+
+static void html_escaped(FILE *out, const char *text) {
+    for (; *text != '\0'; text++) {
+        switch (*text) {
+        case '<': fputs("&lt;", out); break;
+        case '>': fputs("&gt;", out); break;
+        case '&': fputs("&amp;", out); break;
+        default: fputc(*text, out);
+        }
+    }
+}
+
+// Background from red (0%) to green (100%)
+static void score_style(FILE *out, size_t part, size_t whole) {
+    int hue = (int)(percent(part, whole) * 1.2);
+    fprintf(out, " style=\"background: hsl(%d, 70%%, 80%%)\"", hue);
+}
+
+static int compare_slowest(const void *a, const void *b) {
+    const mutant *x = *(const mutant *const *)a, *y = *(const mutant *const *)b;
+    return (x->millis < y->millis) - (x->millis > y->millis);
+}
+
+static int write_html(const char *path) {
+    FILE *out = fopen(path, "w");
+    const mutant **by_time = malloc((mutant_count + 1) * sizeof(*by_time));
+
+    if (out == NULL || by_time == NULL) {
+        perror(path);
+        free(by_time);
+        if (out != NULL) {
+            fclose(out);
+        }
+        return -1;
+    }
+    fputs("<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Mutation report</title>\n"
+          "<style>body{font-family:sans-serif} table{border-collapse:collapse;margin-bottom:2em}"
+          " td,th{border:1px solid #ccc;padding:2px 6px;text-align:center}"
+          " td.name{text-align:left} .killed{background:#cfc} .timeout{background:#ffc}"
+          " .survived{background:#fcc}</style></head><body>\n", out);
+
+    fputs("<h1>Mutation report</h1>\n<h2>Functions &times; operators</h2>\n"
+          "<p>Detected / mutants per cell; equivalent mutants are left out.</p>\n"
+          "<table><tr><th>Function</th><th>Score</th>", out);
+    for (size_t o = 0; o < operator_count; o++) {
+        fprintf(out, "<th>%s</th>", operators[o]);
+    }
+    fputs("</tr>\n", out);
+    for (size_t f = 0; f < function_count; f++) {
+        const function_row *row = &functions[f];
+        size_t scored = row->mutants - row->equivalent;
+        fprintf(out, "<tr><td class=\"name\">%s</td>", row->name);
+        if (row->mutants == 0) {
+            fprintf(out, "<td>no mutants</td>");
+        } else {
+            fprintf(out, "<td");
+            score_style(out, row->killed_all, scored);
+            fprintf(out, ">%zu/%zu</td>", row->killed_all, scored);
+        }
+        for (size_t o = 0; o < operator_count; o++) {
+            if (row->total[o] == 0) {
+                fputs("<td></td>", out);
+                continue;
+            }
+            fprintf(out, "<td");
+            score_style(out, row->killed[o], row->total[o]);
+            fprintf(out, ">%zu/%zu</td>", row->killed[o], row->total[o]);
+        }
+        fputs("</tr>\n", out);
+    }
+    fputs("</table>\n", out);
+
+    fputs("<h2>Test groups</h2>\n<p>Run order: greedy, most not-yet-killed mutants per "
+          "millisecond first.</p>\n<table><tr><th>Group</th><th>Run order</th><th>Reached</th>"
+          "<th>Kills</th><th>Unique kills</th><th>ms</th></tr>\n", out);
+    for (size_t g = 0; g < group_count; g++) {
+        char order[24] = "-";
+        if (groups[g].order != 0) {
+            snprintf(order, sizeof(order), "%zu", groups[g].order);
+        }
+        fprintf(out, "<tr><td class=\"name\">%s</td><td>%s</td><td>%zu</td><td>%zu</td>"
+                "<td>%zu</td><td>%.3f</td></tr>\n", groups[g].name, order, groups[g].reached,
+                groups[g].kills, groups[g].unique_kills, groups[g].millis);
+    }
+    fputs("</table>\n", out);
+    if (group_count == 0) {
+        fputs("<p>No per-group results: run mutation_runner with --matrix.</p>\n", out);
+    }
+
+    for (size_t i = 0; i < mutant_count; i++) {
+        by_time[i] = &mutants[i];
+    }
+    qsort(by_time, mutant_count, sizeof(*by_time), compare_slowest);
+    fputs("<h2>Mutants, slowest first</h2>\n<p>K killed, T timed out, S survived; blank: the "
+          "group does not reach the mutant.</p>\n<table><tr><th>ID</th><th>Function</th>"
+          "<th>Site</th><th>Mutation</th><th>Status</th><th>ms</th>", out);
+    for (size_t g = 0; g < group_count; g++) {
+        fprintf(out, "<th>%s</th>", groups[g].name);
+    }
+    fputs("</tr>\n", out);
+    for (size_t i = 0; i < mutant_count; i++) {
+        const mutant *m = by_time[i];
+        static const char *const cell_marks[] = {"", "S", "K", "T"};
+        static const char *const cell_classes[] = {"", "survived", "killed", "timeout"};
+        fprintf(out, "<tr><td>#%d</td><td class=\"name\">%s</td><td class=\"name\">%s</td>"
+                "<td>", m->id, m->function, m->site);
+        html_escaped(out, m->original);
+        fputs(" &rarr; ", out);
+        html_escaped(out, m->replacement);
+        fprintf(out, "</td><td class=\"%s\">%s</td><td>%.3f</td>",
+                is_detected(m) ? "killed" : strcmp(m->status, "survived") == 0 ? "survived" : "",
+                m->status, m->millis);
+        for (size_t g = 0; g < group_count; g++) {
+            fprintf(out, "<td class=\"%s\">%s</td>", cell_classes[m->cells[g]],
+                    cell_marks[m->cells[g]]);
+        }
+        fputs("</tr>\n", out);
+    }
+    fputs("</table>\n</body></html>\n", out);
+    free(by_time);
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+static int usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--header FILE] [--json FILE] [--html FILE] MUTANTS_TSV "
+            "RESULTS_TSV\n", prog);
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    const char *header_path = NULL, *json_path = NULL, *html_path = NULL;
+    const char *paths[2];
+    size_t path_count = 0;
+    int status = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--header") == 0 && i + 1 < argc) {
+            header_path = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--html") == 0 && i + 1 < argc) {
+            html_path = argv[++i];
+        } else if (argv[i][0] != '-' && path_count < 2) {
+            paths[path_count++] = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (path_count != 2) {
+        return usage(argv[0]);
+    }
+    if ((header_path != NULL && read_header(header_path) != 0) || read_mutants(paths[0]) != 0 ||
+        read_results(paths[1]) != 0) {
+        free(mutants);
+        return 1;
+    }
+    aggregate();
+
+    if (json_path != NULL && write_json(json_path) != 0) {
+        status = 1;
+    }
+    if (html_path != NULL && write_html(html_path) != 0) {
+        status = 1;
+    }
+    printf("Report: %zu mutants, %zu functions, %zu test groups", mutant_count, function_count,
+           group_count);
+    printf("%s%s%s%s\n", json_path ? " -> " : "", json_path ? json_path : "",
+           html_path ? " -> " : "", html_path ? html_path : "");
+    free(mutants);
+    return status;
+}
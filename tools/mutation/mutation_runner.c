@@ -0,0 +1,1057 @@
+// mutation_runner - runs a mutant-schemata test binary against every mutant
+//
+// Reads the mutant list written by mutagen, checks that the test binary
+// passes on the original code (MUTANT_ID=0), then runs it once per mutant
+// on a pool of worker processes, one per online core by default. A mutant
+// is killed when the tests fail or crash, and timed out when it runs past
+// --timeout seconds (default: 10x the baseline run, at least 100 ms).
+//
+// Each worker is a fork server (fork_server.h): the test binary is started
+// once with --fork-server and forks a pre-warmed child per mutant, so a
+// mutant costs a fork instead of an exec, dynamic linking and libc start-up.
+// With --exec, or when the binary cannot serve forks, every mutant is run
+// by exec with MUTANT_ID in the environment instead.
+//
+// With --coverage (per-group line coverage from record_coverage.sh), a
+// mutant on a line no test group executes is reported as not covered
+// without running anything, and the others run only the groups that reach
+// their line, passed as arguments to the test binary. Groups are ordered
+// by how much of their work lands on that line, so with --fail-fast the
+// likeliest killer runs first.
+//
+// With --equivalent (tce.sh and the equivalence checker), mutants found
+// equivalent to the original are not run and leave the score's
+// denominator, and a mutant with the same object code as an earlier one
+// takes that mutant's result instead of a run of its own.
+//
+// With --matrix (and --coverage), every group reaching a mutant runs on its
+// own instead of all of them with --fail-fast, and --results gets each
+// group's result and time: the test-to-mutant kill matrix that
+// mutation_report turns into JSON and HTML.
+//
+// With --cache (and --coverage), results persist between runs keyed by the
+// mutant ID, the hash of the code it can observe (from mutagen) and the
+// source hashes of the groups reaching it (from record_coverage.sh). A
+// mutant whose key is in the cache is not run again, so after an edit to
+// one function only that function's mutants, its callers' and those
+// reached by changed tests run.
+//
+// Usage: mutation_runner [--jobs N] [--timeout SECONDS] [--results FILE]
+//                        [--coverage FILE] [--cache FILE] [--equivalent FILE]
+//                        [--matrix] [--exec] MUTANTS_TSV -- TEST_BINARY [ARGS...]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "fork_server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_COVERAGE_GROUPS 64
+
+// Bounds of the per-mutant timer; the automatic timeout is 10x the
+// baseline run, at least MIN_AUTO_TIMEOUT_US
+#define MAX_TIMEOUT_US 600000000u
+#define MIN_AUTO_TIMEOUT_US 100000u
+
+typedef enum {
+    MUTANT_PENDING,
+    MUTANT_KILLED,
+    MUTANT_SURVIVED,
+    MUTANT_TIMEOUT,
+    MUTANT_UNCOVERED,
+    MUTANT_EQUIVALENT,
+    MUTANT_DUPLICATE        // until the mutant it duplicates has run
+} mutant_status;
+
+static const char *const status_names[] = {
+    "pending", "killed", "survived", "timeout", "uncovered", "equivalent", "duplicate"
+};
+
+// Lines of the mutated source one test group executes
+typedef struct {
+    char name[64];
+    char source_hash[32];   // hash of the group's test code
+    long *hits;         // hit count per line, indexed by line number
+    int max_line;
+    long total;         // hits summed over all lines
+} coverage_group;
+
+typedef struct {
+    int id;
+    char function[64];
+    char file[256];
+    int line;
+    int col;
+    char op[32];
+    char original[8];
+    char replacement[8];
+    uint64_t code_hash;     // code the mutant can observe
+    uint64_t cache_key;
+    int cached;             // status and millis came from the cache
+    char pruned_by[16];     // equivalence method, for equivalent and duplicate mutants
+    size_t duplicate_of;    // index of the mutant with the same object code
+    mutant_status status;
+    double millis;
+    size_t groups[MAX_COVERAGE_GROUPS];    // test groups to run, best first
+    size_t group_count;
+    // With --matrix, every group runs on its own: its result and time
+    int matrix;
+    mutant_status group_status[MAX_COVERAGE_GROUPS];
+    double group_millis[MAX_COVERAGE_GROUPS];
+} mutant;
+
+// One test process: a mutant against all its groups, or with --matrix
+// against the single group m->groups[group]
+typedef struct {
+    mutant *m;
+    size_t group;
+    pid_t pid;
+    struct timespec started;
+} run_job;
+
+#define ALL_GROUPS ((size_t)-1)
+
+// One fork server and the job it is running
+typedef struct {
+    pid_t pid;
+    int control;        // requests, to the server
+    int status;         // hello and replies, from the server
+    run_job *current;
+} fork_server;
+
+static coverage_group coverage[MAX_COVERAGE_GROUPS];
+static size_t coverage_count;
+
+static double elapsed_millis(const struct timespec *since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - since->tv_sec) * 1e3 +
+           (double)(now.tv_nsec - since->tv_nsec) / 1e6;
+}
+
+static mutant *read_mutants(const char *path, size_t *count) {
+    FILE *in = fopen(path, "r");
+    mutant *list = NULL;
+    size_t cap = 0;
+    char line[1024];
+
+    *count = 0;
+    if (in == NULL) {
+        perror(path);
+        return NULL;
+    }
+    while (fgets(line, sizeof(line), in) != NULL) {
+        mutant m;
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        memset(&m, 0, sizeof(m));
+        unsigned long long code_hash;
+        if (sscanf(line, "%d\t%63[^\t]\t%255[^\t]\t%d\t%d\t%31[^\t]\t%7[^\t]\t%7[^\t]\t%llx",
+                   &m.id, m.function, m.file, &m.line, &m.col, m.op, m.original,
+                   m.replacement, &code_hash) != 9) {
+            fprintf(stderr, "%s: malformed line: %s", path, line);
+            continue;
+        }
+        m.code_hash = code_hash;
+        if (*count == cap) {
+            cap = cap ? cap * 2 : 64;
+            mutant *grown = realloc(list, cap * sizeof(*grown));
+            if (grown == NULL) {
+                free(list);
+                fclose(in);
+                return NULL;
+            }
+            list = grown;
+        }
+        list[(*count)++] = m;
+    }
+    fclose(in);
+    if (list == NULL) {
+        list = malloc(sizeof(*list));
+    }
+    return list;
+}
+
+static int read_coverage(const char *path) {
+    FILE *in = fopen(path, "r");
+    char line[16384];
+
+    if (in == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), in) != NULL && coverage_count < MAX_COVERAGE_GROUPS) {
+        coverage_group *g = &coverage[coverage_count];
+        char *tab = strchr(line, '\t');
+        char *lines = tab != NULL ? strchr(tab + 1, '\t') : NULL;
+        if (line[0] == '#' || lines == NULL) {
+            continue;
+        }
+        *tab = '\0';
+        *lines = '\0';
+        snprintf(g->name, sizeof(g->name), "%s", line);
+        snprintf(g->source_hash, sizeof(g->source_hash), "%s", tab + 1);
+        g->hits = NULL;
+        g->max_line = 0;
+        g->total = 0;
+
+        for (char *entry = strtok(lines + 1, ",\n"); entry != NULL; entry = strtok(NULL, ",\n")) {
+            int number;
+            long hits;
+            if (sscanf(entry, "%d:%ld", &number, &hits) != 2 || number <= 0) {
+                continue;
+            }
+            if (number > g->max_line) {
+                long *grown = realloc(g->hits, (size_t)(number + 1) * sizeof(*grown));
+                if (grown == NULL) {
+                    fclose(in);
+                    return -1;
+                }
+                memset(grown + g->max_line + 1, 0,
+                       (size_t)(number - g->max_line) * sizeof(*grown));
+                g->hits = grown;
+                g->max_line = number;
+            }
+            g->hits[number] += hits;
+            g->total += hits;
+        }
+        coverage_count++;
+    }
+    fclose(in);
+    return 0;
+}
+
+static long line_hits(const coverage_group *g, int line) {
+    return line <= g->max_line ? g->hits[line] : 0;
+}
+
+// Share of a group's executed-line hits that land on the mutant's line:
+// a group that spends most of its time there is the likeliest to kill it
+static double kill_likelihood(const coverage_group *g, int line) {
+    return g->total > 0 ? (double)line_hits(g, line) / (double)g->total : 0.0;
+}
+
+// Picks the groups reaching each mutant's line, best first; mutants no
+// group reaches are marked uncovered
+static void select_groups(mutant *mutants, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        mutant *m = &mutants[i];
+        m->group_count = 0;
+        for (size_t g = 0; g < coverage_count; g++) {
+            if (line_hits(&coverage[g], m->line) == 0) {
+                continue;
+            }
+            size_t k = m->group_count++;
+            double likelihood = kill_likelihood(&coverage[g], m->line);
+            while (k > 0 && kill_likelihood(&coverage[m->groups[k - 1]], m->line) < likelihood) {
+                m->groups[k] = m->groups[k - 1];
+                k--;
+            }
+            m->groups[k] = g;
+        }
+        if (m->group_count == 0) {
+            m->status = MUTANT_UNCOVERED;
+        }
+    }
+}
+
+// ============ Equivalent and duplicate mutants ============
+
+static size_t find_mutant(const mutant *mutants, size_t count, int id) {
+    size_t i = 0;
+    while (i < count && mutants[i].id != id) {
+        i++;
+    }
+    return i;
+}
+
+// Marks the mutants listed by tce.sh and the equivalence checker:
+//   id<TAB>method<TAB>of
+// with `of` 0 for a mutant equivalent to the original, or the ID of an
+// earlier mutant with the same object code
+static int read_equivalent(const char *path, mutant *mutants, size_t count) {
+    FILE *in = fopen(path, "r");
+    char line[256];
+
+    if (in == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), in) != NULL) {
+        int id, of;
+        char method[16];
+        size_t i, same;
+
+        if (line[0] == '#' || sscanf(line, "%d\t%15[^\t]\t%d", &id, method, &of) != 3 ||
+            (i = find_mutant(mutants, count, id)) == count) {
+            continue;
+        }
+        if (of == 0) {
+            mutants[i].status = MUTANT_EQUIVALENT;
+        } else if ((same = find_mutant(mutants, count, of)) < count &&
+                   mutants[i].status == MUTANT_PENDING) {
+            mutants[i].status = MUTANT_DUPLICATE;
+            mutants[i].duplicate_of = same;
+        } else {
+            continue;
+        }
+        snprintf(mutants[i].pruned_by, sizeof(mutants[i].pruned_by), "%s", method);
+    }
+    fclose(in);
+    return 0;
+}
+
+// ============ Per-group results ============
+
+// Writes a --matrix mutant's groups as name:status:millis,...; "-" when
+// the mutant's groups did not run one at a time
+static void write_group_results(FILE *out, const mutant *m) {
+    if (!m->matrix || m->group_count == 0) {
+        fputc('-', out);
+        return;
+    }
+    for (size_t k = 0; k < m->group_count; k++) {
+        fprintf(out, "%s%s:%s:%.3f", k ? "," : "", coverage[m->groups[k]].name,
+                status_names[m->group_status[k]], m->group_millis[k]);
+    }
+}
+
+static int find_status(const char *name, mutant_status *status) {
+    for (size_t k = 0; k < sizeof(status_names) / sizeof(status_names[0]); k++) {
+        if (strcmp(status_names[k], name) == 0) {
+            *status = (mutant_status)k;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Parses write_group_results output back onto m; 0 when it gives a result
+// for every group m needs
+static int read_group_results(mutant *m, char *text) {
+    size_t found = 0;
+
+    for (char *entry = strtok(text, ",\n"); entry != NULL; entry = strtok(NULL, ",\n")) {
+        char name[64], status[16];
+        double millis;
+        mutant_status parsed;
+
+        if (sscanf(entry, "%63[^:]:%15[^:]:%lf", name, status, &millis) != 3 ||
+            find_status(status, &parsed) != 0) {
+            return -1;
+        }
+        for (size_t k = 0; k < m->group_count; k++) {
+            if (strcmp(coverage[m->groups[k]].name, name) == 0) {
+                m->group_status[k] = parsed;
+                m->group_millis[k] = millis;
+                found++;
+            }
+        }
+    }
+    return found == m->group_count ? 0 : -1;
+}
+
+// ============ Result cache ============
+
+static uint64_t fnv1a_64(uint64_t h, const void *data, size_t len) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211u;
+    }
+    return h;
+}
+
+// Cache key of a covered mutant: its ID, the code it can observe and every
+// group reaching it with that group's test code, in coverage order so the
+// key does not depend on how the groups were ranked
+static uint64_t cache_key(const mutant *m) {
+    uint64_t h = fnv1a_64(14695981039346656037u, &m->id, sizeof(m->id));
+
+    h = fnv1a_64(h, &m->code_hash, sizeof(m->code_hash));
+    for (size_t g = 0; g < coverage_count; g++) {
+        if (line_hits(&coverage[g], m->line) > 0) {
+            h = fnv1a_64(h, coverage[g].name, strlen(coverage[g].name) + 1);
+            h = fnv1a_64(h, coverage[g].source_hash, strlen(coverage[g].source_hash) + 1);
+        }
+    }
+    return h;
+}
+
+// Takes the status of every pending mutant whose key is in the cache; a
+// missing cache file is an empty cache. With matrix set, only entries that
+// have per-group results count. Returns the number reused.
+static size_t read_cache(const char *path, mutant *mutants, size_t count, int matrix) {
+    FILE *in = fopen(path, "r");
+    char line[8192];
+    size_t reused = 0;
+
+    if (in == NULL) {
+        return 0;
+    }
+    while (fgets(line, sizeof(line), in) != NULL) {
+        unsigned long long key;
+        int id, groups_at = 0;
+        char name[16];
+        double millis;
+        mutant_status status;
+
+        if (line[0] == '#' ||
+            sscanf(line, "%llx\t%d\t%15[^\t]\t%lf\t%n", &key, &id, name, &millis,
+                   &groups_at) != 4 || groups_at == 0 || find_status(name, &status) != 0) {
+            continue;
+        }
+        for (size_t i = 0; i < count; i++) {
+            mutant *m = &mutants[i];
+            if (m->id != id || m->cache_key != key || m->status != MUTANT_PENDING) {
+                continue;
+            }
+            m->matrix = line[groups_at] != '-' && read_group_results(m, line + groups_at) == 0;
+            if (!matrix || m->matrix) {
+                m->status = status;
+                m->millis = millis;
+                m->cached = 1;
+                reused++;
+            }
+            break;
+        }
+    }
+    fclose(in);
+    return reused;
+}
+
+// Rewrites the cache with this run's results, dropping stale entries;
+// written to a temporary file first so an interrupted run keeps the old one
+static int write_cache(const char *path, const mutant *mutants, size_t count) {
+    char temp[4096];
+    FILE *out;
+
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+    out = fopen(temp, "w");
+    if (out == NULL) {
+        perror(temp);
+        return -1;
+    }
+    fputs("# key\tid\tstatus\tmillis\tgroups\n", out);
+    for (size_t i = 0; i < count; i++) {
+        const mutant *m = &mutants[i];
+        if ((m->status == MUTANT_KILLED || m->status == MUTANT_SURVIVED ||
+             m->status == MUTANT_TIMEOUT) && m->pruned_by[0] == '\0') {
+            fprintf(out, "%016llx\t%d\t%s\t%.3f\t", (unsigned long long)m->cache_key, m->id,
+                    status_names[m->status], m->millis);
+            write_group_results(out, m);
+            fputc('\n', out);
+        }
+    }
+    if (fclose(out) != 0 || rename(temp, path) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+// ============ Running mutants ============
+
+static void discard_output(void) {
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        close(devnull);
+    }
+}
+
+// Starts the test binary for one mutant with its output discarded
+static pid_t spawn(char **argv, int mutant_id, uint32_t timeout_us) {
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        char id[16];
+        struct itimerval timer = {{0, 0}, {timeout_us / 1000000, timeout_us % 1000000}};
+        discard_output();
+        snprintf(id, sizeof(id), "%d", mutant_id);
+        setenv("MUTANT_ID", id, 1);
+        setitimer(ITIMER_REAL, &timer, NULL);     // the timer survives exec
+        execv(argv[0], argv);
+        _exit(127);
+    }
+    return pid;
+}
+
+static mutant_status classify(int status) {
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM) {
+        return MUTANT_TIMEOUT;
+    }
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        return MUTANT_SURVIVED;
+    }
+    return MUTANT_KILLED;
+}
+
+// Names of the groups a job runs
+static size_t job_groups(const run_job *job, const char **names) {
+    const mutant *m = job->m;
+
+    if (job->group != ALL_GROUPS) {
+        names[0] = coverage[m->groups[job->group]].name;
+        return 1;
+    }
+    for (size_t g = 0; g < m->group_count; g++) {
+        names[g] = coverage[m->groups[g]].name;
+    }
+    return m->group_count;
+}
+
+static void finish_job(run_job *job, int status, double millis) {
+    mutant *m = job->m;
+
+    if (job->group == ALL_GROUPS) {
+        m->status = classify(status);
+        m->millis = millis;
+    } else {
+        m->group_status[job->group] = classify(status);
+        m->group_millis[job->group] = millis;
+    }
+}
+
+// Runs every job, keeping up to jobs test processes in flight
+static int run_exec_pool(run_job *work, size_t count, char **argv, long jobs, uint32_t timeout_us) {
+    size_t argc = 0;
+    size_t next = 0;
+    long running = 0;
+
+    while (argv[argc] != NULL) {
+        argc++;
+    }
+    char **args = malloc((argc + MAX_COVERAGE_GROUPS + 1) * sizeof(*args));
+    if (args == NULL) {
+        return -1;
+    }
+    memcpy(args, argv, argc * sizeof(*args));
+
+    while (next < count || running > 0) {
+        while (running < jobs && next < count) {
+            run_job *job = &work[next++];
+            args[argc + job_groups(job, (const char **)&args[argc])] = NULL;
+            clock_gettime(CLOCK_MONOTONIC, &job->started);
+            job->pid = spawn(args, job->m->id, timeout_us);
+            if (job->pid < 0) {
+                perror("fork");
+                free(args);
+                return -1;
+            }
+            running++;
+        }
+        if (running == 0) {
+            break;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            perror("waitpid");
+            free(args);
+            return -1;
+        }
+        for (size_t i = 0; i < next; i++) {
+            if (work[i].pid == pid) {
+                finish_job(&work[i], status, elapsed_millis(&work[i].started));
+                work[i].pid = 0;
+                running--;
+                break;
+            }
+        }
+    }
+    free(args);
+    return 0;
+}
+
+static int read_full(int fd, void *buf, size_t size) {
+    char *p = buf;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+static void stop_server(fork_server *fs) {
+    close(fs->control);
+    close(fs->status);
+    waitpid(fs->pid, NULL, 0);
+}
+
+// Starts `TEST_BINARY ARGS... --fork-server` on the protocol fds and waits
+// for its hello; returns -1 when the binary does not answer as a server
+static int start_server(fork_server *fs, char **argv) {
+    int control[2], status[2];
+    uint32_t hello;
+    size_t argc = 0;
+
+    if (pipe(control) != 0) {
+        return -1;
+    }
+    if (pipe(status) != 0) {
+        close(control[0]);
+        close(control[1]);
+        return -1;
+    }
+    fs->pid = fork();
+    if (fs->pid == 0) {
+        while (argv[argc] != NULL) {
+            argc++;
+        }
+        char **args = malloc((argc + 2) * sizeof(*args));
+        if (args == NULL || dup2(control[0], FORK_SERVER_CONTROL_FD) < 0 ||
+            dup2(status[1], FORK_SERVER_STATUS_FD) < 0) {
+            _exit(127);
+        }
+        close(control[0]);
+        close(control[1]);
+        close(status[0]);
+        close(status[1]);
+        memcpy(args, argv, argc * sizeof(*args));
+        args[argc] = "--fork-server";
+        args[argc + 1] = NULL;
+        discard_output();
+        setenv("MUTANT_ID", "0", 1);
+        execv(args[0], args);
+        _exit(127);
+    }
+    close(control[0]);
+    close(status[1]);
+    // Servers started later must not inherit this one's ends, or it never
+    // sees its control pipe close
+    fcntl(control[1], F_SETFD, FD_CLOEXEC);
+    fcntl(status[0], F_SETFD, FD_CLOEXEC);
+    fs->control = control[1];
+    fs->status = status[0];
+    fs->current = NULL;
+    if (fs->pid < 0) {
+        close(fs->control);
+        close(fs->status);
+        return -1;
+    }
+    if (read_full(fs->status, &hello, sizeof(hello)) != 0 || hello != FORK_SERVER_HELLO) {
+        stop_server(fs);
+        return -1;
+    }
+    return 0;
+}
+
+// Asks a server to run one job
+static int send_request(fork_server *fs, run_job *job, uint32_t timeout_us) {
+    char message[sizeof(fork_server_request) + FORK_SERVER_MAX_NAMES];
+    fork_server_request request = {job->m->id, timeout_us, 0};
+    char *names = message + sizeof(request);
+    const char *group_names[MAX_COVERAGE_GROUPS];
+    size_t group_count = job_groups(job, group_names);
+
+    for (size_t g = 0; g < group_count; g++) {
+        size_t len = strlen(group_names[g]) + 1;
+        if (request.names_size + len > FORK_SERVER_MAX_NAMES) {
+            break;
+        }
+        memcpy(names + request.names_size, group_names[g], len);
+        request.names_size += (uint32_t)len;
+    }
+    memcpy(message, &request, sizeof(request));
+
+    // One write below PIPE_BUF is atomic; the server is idle and reading
+    size_t size = sizeof(request) + request.names_size;
+    if (write(fs->control, message, size) != (ssize_t)size) {
+        return -1;
+    }
+    fs->current = job;
+    clock_gettime(CLOCK_MONOTONIC, &job->started);
+    return 0;
+}
+
+// Runs every job on jobs fork servers, one job per server at a time
+static int run_server_pool(fork_server *servers, long jobs, run_job *work, size_t count,
+                           uint32_t timeout_us) {
+    struct pollfd fds[jobs];
+    size_t next = 0;
+    long busy = 0;
+
+    for (;;) {
+        for (long s = 0; s < jobs; s++) {
+            if (servers[s].current == NULL && next < count) {
+                if (send_request(&servers[s], &work[next++], timeout_us) != 0) {
+                    perror("fork server");
+                    return -1;
+                }
+                busy++;
+            }
+        }
+        if (busy == 0) {
+            return 0;
+        }
+
+        for (long s = 0; s < jobs; s++) {
+            fds[s].fd = servers[s].current != NULL ? servers[s].status : -1;
+            fds[s].events = POLLIN;
+            fds[s].revents = 0;
+        }
+        if (poll(fds, (nfds_t)jobs, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            return -1;
+        }
+        for (long s = 0; s < jobs; s++) {
+            fork_server_reply reply;
+            run_job *job = servers[s].current;
+
+            if (job == NULL || fds[s].revents == 0) {
+                continue;
+            }
+            if (read_full(servers[s].status, &reply, sizeof(reply)) != 0) {
+                fprintf(stderr, "fork server %d died running mutant #%d\n", (int)servers[s].pid,
+                        job->m->id);
+                return -1;
+            }
+            finish_job(job, reply.status, (double)reply.micros / 1e3);
+            servers[s].current = NULL;
+            busy--;
+        }
+    }
+}
+
+// Runs every pending mutant: on a fork-server pool when the binary
+// supports it, exec per mutant otherwise. With matrix, each of a mutant's
+// groups runs as a job of its own and the mutant is killed when any kills
+// it.
+static int run_pool(mutant *mutants, size_t count, char **argv, long jobs, uint32_t timeout_us,
+                    int use_servers, int matrix, int *served) {
+    fork_server *servers = NULL;
+    run_job *work = NULL;
+    size_t work_count = 0;
+    long started = 0;
+    int status;
+
+    for (size_t i = 0; i < count; i++) {
+        if (mutants[i].status != MUTANT_PENDING) {
+            continue;
+        }
+        mutants[i].matrix = matrix && mutants[i].group_count > 0;
+        size_t n = mutants[i].matrix ? mutants[i].group_count : 1;
+        run_job *grown = realloc(work, (work_count + n) * sizeof(*grown));
+        if (grown == NULL) {
+            free(work);
+            return -1;
+        }
+        work = grown;
+        for (size_t g = 0; g < n; g++) {
+            work[work_count++] = (run_job){&mutants[i], mutants[i].matrix ? g : ALL_GROUPS, 0,
+                                           {0, 0}};
+        }
+    }
+    *served = 0;
+    if (work_count == 0) {
+        return 0;
+    }
+
+    servers = use_servers ? calloc((size_t)jobs, sizeof(*servers)) : NULL;
+    while (servers != NULL && started < jobs && start_server(&servers[started], argv) == 0) {
+        started++;
+    }
+    *served = servers != NULL && started == jobs;
+    if (*served) {
+        status = run_server_pool(servers, jobs, work, work_count, timeout_us);
+    } else {
+        if (use_servers) {
+            fprintf(stderr, "Fork server unavailable, running each mutant by exec\n");
+        }
+        status = run_exec_pool(work, work_count, argv, jobs, timeout_us);
+    }
+    for (long s = 0; s < started; s++) {
+        stop_server(&servers[s]);
+    }
+    free(servers);
+    free(work);
+
+    // A timeout counts only when no group killed the mutant outright
+    for (size_t i = 0; i < count && status == 0; i++) {
+        mutant *m = &mutants[i];
+        if (m->status != MUTANT_PENDING || !m->matrix) {
+            continue;
+        }
+        m->status = MUTANT_SURVIVED;
+        m->millis = 0;
+        for (size_t g = 0; g < m->group_count; g++) {
+            m->millis += m->group_millis[g];
+            if (m->group_status[g] == MUTANT_KILLED ||
+                (m->group_status[g] == MUTANT_TIMEOUT && m->status == MUTANT_SURVIVED)) {
+                m->status = m->group_status[g];
+            }
+        }
+    }
+    return status;
+}
+
+static int write_results(const char *path, const mutant *mutants, size_t count) {
+    FILE *out = fopen(path, "w");
+
+    if (out == NULL) {
+        perror(path);
+        return -1;
+    }
+    fputs("# id\tstatus\tmillis\tgroups\n", out);
+    for (size_t i = 0; i < count; i++) {
+        fprintf(out, "%d\t%s\t%.3f\t", mutants[i].id, status_names[mutants[i].status],
+                mutants[i].millis);
+        write_group_results(out, &mutants[i]);
+        fputc('\n', out);
+    }
+    return fclose(out);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--jobs N] [--timeout SECONDS] [--results FILE]\n"
+            "          [--coverage FILE] [--cache FILE] [--equivalent FILE]\n"
+            "          [--matrix] [--exec] MUTANTS_TSV -- TEST_BINARY [ARGS...]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    double timeout = 0;     // seconds; 0 = derived from the baseline
+    int use_servers = 1;
+    int matrix = 0;
+    const char *results_path = NULL;
+    const char *coverage_path = NULL;
+    const char *cache_path = NULL;
+    const char *equivalent_path = NULL;
+    const char *mutants_path = NULL;
+    char **test_argv = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeout = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--matrix") == 0) {
+            matrix = 1;
+        } else if (strcmp(argv[i], "--exec") == 0) {
+            use_servers = 0;
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            results_path = argv[++i];
+        } else if (strcmp(argv[i], "--coverage") == 0 && i + 1 < argc) {
+            coverage_path = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cache_path = argv[++i];
+        } else if (strcmp(argv[i], "--equivalent") == 0 && i + 1 < argc) {
+            equivalent_path = argv[++i];
+        } else if (strcmp(argv[i], "--") == 0 && i + 1 < argc) {
+            test_argv = &argv[i + 1];
+            break;
+        } else if (mutants_path == NULL && argv[i][0] != '-') {
+            mutants_path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (mutants_path == NULL || test_argv == NULL) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (jobs < 1) {
+        jobs = 1;
+    }
+
+    size_t count;
+    mutant *mutants = read_mutants(mutants_path, &count);
+    if (mutants == NULL) {
+        return 1;
+    }
+
+    // Baseline: the unmutated code must pass before any mutant means anything
+    int status;
+    struct timespec baseline_started;
+    clock_gettime(CLOCK_MONOTONIC, &baseline_started);
+    pid_t baseline = spawn(test_argv, 0, MAX_TIMEOUT_US);
+    if (baseline < 0 || waitpid(baseline, &status, 0) < 0 ||
+        classify(status) != MUTANT_SURVIVED) {
+        fprintf(stderr, "Original tests failed! Fix the code before running mutation tests.\n");
+        free(mutants);
+        return 1;
+    }
+    double baseline_millis = elapsed_millis(&baseline_started);
+    uint32_t timeout_us = timeout > 0 ? (uint32_t)(timeout * 1e6)
+                                      : (uint32_t)(baseline_millis * 1e4);
+    if (timeout_us > MAX_TIMEOUT_US) {
+        timeout_us = MAX_TIMEOUT_US;
+    }
+    if (timeout <= 0 && timeout_us < MIN_AUTO_TIMEOUT_US) {
+        timeout_us = MIN_AUTO_TIMEOUT_US;
+    }
+    printf("✓ Original tests passed (%.1f ms); timeout %.0f ms per mutant\n", baseline_millis,
+           timeout_us / 1e3);
+
+    size_t group_runs = 0;
+    if (coverage_path != NULL) {
+        if (read_coverage(coverage_path) != 0) {
+            free(mutants);
+            return 1;
+        }
+        select_groups(mutants, count);
+        for (size_t i = 0; i < count; i++) {
+            group_runs += mutants[i].group_count;
+        }
+        printf("Coverage: %zu of %zu group runs needed (%zu groups)\n", group_runs,
+               count * coverage_count, coverage_count);
+    }
+
+    size_t equivalent = 0, same_code = 0, duplicates = 0;
+    if (equivalent_path != NULL) {
+        if (read_equivalent(equivalent_path, mutants, count) != 0) {
+            free(mutants);
+            return 1;
+        }
+        for (size_t i = 0; i < count; i++) {
+            equivalent += mutants[i].status == MUTANT_EQUIVALENT;
+            same_code += mutants[i].status == MUTANT_EQUIVALENT &&
+                         strcmp(mutants[i].pruned_by, "object_code") == 0;
+            duplicates += mutants[i].status == MUTANT_DUPLICATE;
+        }
+        printf("Equivalence: %zu equivalent mutants pruned (%zu same object code, %zu same "
+               "results on a small domain), %zu duplicates\n", equivalent, same_code,
+               equivalent - same_code, duplicates);
+    }
+
+    // Keys and the matrix need the reaching groups, so both need coverage
+    size_t reused = 0;
+    if (cache_path != NULL && coverage_path == NULL) {
+        fprintf(stderr, "--cache needs --coverage; running every mutant\n");
+        cache_path = NULL;
+    }
+    if (matrix && coverage_path == NULL) {
+        fprintf(stderr, "--matrix needs --coverage; running every mutant's groups together\n");
+        matrix = 0;
+    }
+    if (cache_path != NULL) {
+        for (size_t i = 0; i < count; i++) {
+            mutants[i].cache_key = cache_key(&mutants[i]);
+        }
+        reused = read_cache(cache_path, mutants, count, matrix);
+        printf("Cache: %zu mutants unchanged since their last run (%s)\n", reused, cache_path);
+    }
+    size_t pending = 0;
+    for (size_t i = 0; i < count; i++) {
+        pending += mutants[i].status == MUTANT_PENDING;
+    }
+    printf("Running %zu mutants on %ld workers...\n\n", pending, jobs);
+
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    int served = 0;
+    if (run_pool(mutants, count, test_argv, jobs, timeout_us, use_servers, matrix, &served) != 0) {
+        free(mutants);
+        return 1;
+    }
+    double wall = elapsed_millis(&started);
+
+    // A duplicate dies exactly when the mutant with its code does
+    for (size_t i = 0; i < count; i++) {
+        if (mutants[i].status == MUTANT_DUPLICATE) {
+            mutants[i].status = mutants[mutants[i].duplicate_of].status;
+        }
+    }
+
+    size_t killed = 0, survived = 0, timed_out = 0, uncovered = 0;
+    double run_millis = 0;
+    size_t run_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        const mutant *m = &mutants[i];
+        const char *mark = m->status == MUTANT_SURVIVED ? "✗ Survived" :
+                           m->status == MUTANT_UNCOVERED ? "✗ Not covered" :
+                           m->status == MUTANT_EQUIVALENT ? "= Equivalent" :
+                           m->status == MUTANT_TIMEOUT ? "✓ Timed out" : "✓ Killed";
+        char site[300], note[64] = "";
+        snprintf(site, sizeof(site), "%s:%d:%d", m->file, m->line, m->col);
+        if (m->status == MUTANT_EQUIVALENT) {
+            snprintf(note, sizeof(note), " (%s)", m->pruned_by);
+        } else if (m->pruned_by[0] != '\0') {
+            snprintf(note, sizeof(note), " (same code as #%d)", mutants[m->duplicate_of].id);
+        } else if (m->cached) {
+            snprintf(note, sizeof(note), " (cached)");
+        }
+        printf("  #%-10d %-22s %-24s %-20s %2s -> %-3s %s%s\n", m->id, m->function, site, m->op,
+               m->original, m->replacement, mark, note);
+        killed += m->status == MUTANT_KILLED;
+        survived += m->status == MUTANT_SURVIVED;
+        timed_out += m->status == MUTANT_TIMEOUT;
+        uncovered += m->status == MUTANT_UNCOVERED;
+        if (m->status != MUTANT_UNCOVERED && m->status != MUTANT_EQUIVALENT &&
+            m->pruned_by[0] == '\0' && !m->cached) {
+            run_millis += m->millis;
+            run_count++;
+        }
+    }
+
+    // Timed-out mutants count as detected, uncovered ones as survivors;
+    // equivalent ones cannot be detected and leave the score
+    printf("\n=== Mutation Testing Report ===\n");
+    printf("Total Mutations:     %zu\n", count);
+    printf("Killed Mutations:    %zu\n", killed + timed_out);
+    printf("Survived Mutations:  %zu\n", survived + uncovered);
+    printf("Timed Out:           %zu\n", timed_out);
+    printf("Not Covered:         %zu\n", uncovered);
+    if (equivalent_path != NULL) {
+        printf("Equivalent (pruned): %zu\n", equivalent);
+        printf("Duplicates (pruned): %zu\n", duplicates);
+    }
+    if (cache_path != NULL) {
+        printf("Reused From Cache:   %zu\n", reused);
+    }
+    if (count > equivalent) {
+        size_t score = (killed + timed_out) * 100 / (count - equivalent);
+        printf("Mutation Score:      %zu%%\n", score);
+        printf("Wall Time:           %.1f ms (%ld workers, %s)\n", wall, jobs,
+               served ? "fork server" : pending > 0 ? "exec" : "nothing to run");
+        if (run_count > 0) {
+            printf("Per Mutant:          %.1f us\n", run_millis * 1e3 / (double)run_count);
+        }
+        if (score >= 80) {
+            printf("✓ Good test coverage!\n");
+        } else if (score >= 60) {
+            printf("⚠ Acceptable test coverage\n");
+        } else {
+            printf("✗ Poor test coverage - add more tests!\n");
+        }
+    }
+
+    if ((results_path != NULL && write_results(results_path, mutants, count) != 0) ||
+        (cache_path != NULL && write_cache(cache_path, mutants, count) != 0)) {
+        free(mutants);
+        return 1;
+    }
+    for (size_t g = 0; g < coverage_count; g++) {
+        free(coverage[g].hits);
+    }
+    free(mutants);
+    return 0;
+}
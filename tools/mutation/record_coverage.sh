@@ -0,0 +1,77 @@
+#!/bin/bash
+
+# record_coverage.sh - per-group line coverage of one source file
+#
+# Runs each test group of a gcov-instrumented test binary on its own and
+# writes the lines of SOURCE that group executed, with hit counts, after a
+# hash of the group's test code:
+#   group<TAB>source_hash<TAB>line:count,line:count,...
+# mutation_runner uses it to skip unreached mutants and to pick (and order)
+# the groups worth running against each mutant. The hash covers the
+# group's TEST_GROUP body, the rest of its file outside any group (includes,
+# helpers) and every DEPENDENCY file, so the runner's result cache reruns a
+# mutant when a test reaching it changes.
+#
+# Usage: record_coverage.sh TEST_BINARY OBJECT_DIR SOURCE OUT [DEPENDENCY...]
+
+set -e
+
+if [ $# -lt 4 ]; then
+    echo "Usage: $0 TEST_BINARY OBJECT_DIR SOURCE OUT [DEPENDENCY...]" >&2
+    exit 2
+fi
+
+BINARY="$1"
+OBJECT_DIR="$2"
+SOURCE="$3"
+OUT="$4"
+shift 4
+DEPENDENCIES=("$@")
+
+# Lines of FILE from START up to the brace closing the block opened there;
+# with START unset, the lines outside every block starting at STARTS
+group_source() {
+    awk -v start="$2" -v starts="$3" '
+        BEGIN { split(starts, list, " "); for (i in list) begins[list[i]] = 1 }
+        (start != "" && NR == start) || (start == "" && NR in begins) { inside = 1 }
+        inside != (start == "") { print }
+        inside {
+            depth += gsub(/{/, "{") - gsub(/}/, "}")
+            if (depth == 0 && /}/) { inside = 0; if (start != "") exit }
+        }' "$1"
+}
+
+hash() {
+    cksum | awk '{ printf "%08x%08x", $1, $2 }'
+}
+
+LISTING=$("${BINARY}" --list --verbose)
+
+{
+    printf '# group\tsource_hash\tline:count,...\n'
+    while IFS=$'\t' read -r group location; do
+        file="${location%:*}"
+        line="${location##*:}"
+        starts=$(printf '%s\n' "${LISTING}" | awk -F'\t' -v file="${file}" '
+            { n = split($2, at, ":"); if (substr($2, 1, length($2) - length(at[n]) - 1) == file) print at[n] }')
+        source_hash=$({
+            group_source "${file}" "${line}"
+            group_source "${file}" "" "${starts}"
+            cat "${DEPENDENCIES[@]}" /dev/null
+        } | hash)
+
+        rm -f "${OBJECT_DIR}"/*.gcda
+        "${BINARY}" "${group}" > /dev/null || true
+        lines=$(gcov -t -o "${OBJECT_DIR}" "${SOURCE}" 2>/dev/null | awk -F: '
+            {
+                count = $1
+                gsub(/[ *]/, "", count)
+                if (count ~ /^[0-9]+$/ && count > 0) {
+                    gsub(/ /, "", $2)
+                    printf "%s%s:%s", sep, $2, count
+                    sep = ","
+                }
+            }')
+        printf '%s\t%s\t%s\n' "${group}" "${source_hash}" "${lines}"
+    done <<< "${LISTING}"
+} > "${OUT}"
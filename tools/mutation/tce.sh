@@ -0,0 +1,71 @@
+#!/bin/bash
+
+# tce.sh - trivial compiler equivalence of schemata mutants
+#
+# Compiles a mutant schemata source (mutagen) with optimization, one
+# section per function, and compares the machine code of every mutant copy
+# with its function's original and with the earlier mutants of the same
+# function. A mutant the optimizer turned into the original's code is
+# equivalent: no test can kill it. A mutant with the same code as an
+# earlier one is a duplicate: it dies exactly when that one does. Writes
+#   id<TAB>object_code<TAB>of
+# where `of` is 0 for an equivalent mutant, or the ID it duplicates.
+#
+# Inlining and interprocedural passes that rewrite a function based on its
+# callers are off, so each copy is compiled on its own body only.
+#
+# Usage: tce.sh SCHEMATA_SOURCE OUT [CFLAGS...]
+
+set -e
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 SCHEMATA_SOURCE OUT [CFLAGS...]" >&2
+    exit 2
+fi
+
+SOURCE="$1"
+OUT="$2"
+shift 2
+OBJECT="${OUT%.*}.o"
+
+"${CC:-gcc}" "$@" -O2 -w -fno-inline -fno-ipa-icf -fno-ipa-sra -fno-ipa-cp \
+    -ffunction-sections -c -o "${OBJECT}" "${SOURCE}"
+
+objdump -dr --no-show-raw-insn "${OBJECT}" | awk '
+    # Function bodies: instructions and relocations without their offsets,
+    # and branches within the function as offsets from its start
+    /^Disassembly of section / {
+        name = $4
+        sub(/^\.text\./, "", name)
+        sub(/:$/, "", name)
+        if (name ~ /__mutant_[0-9]+$/) {
+            order[++count] = name
+        }
+        next
+    }
+    name != "" && (/^ +[0-9a-f]+:\t/ || /^\t+[0-9a-f]+: R_/) {
+        line = $0
+        sub(/^[ \t]+[0-9a-f]+:[ \t]+/, "", line)
+        gsub(/[0-9a-f]+ <[A-Za-z0-9_.]+__(original|mutant_[0-9]+)/, "<", line)
+        code[name] = code[name] line "\n"
+    }
+    END {
+        printf "# id\tmethod\tof\n"
+        for (i = 1; i <= count; i++) {
+            fn = order[i]
+            base = fn
+            sub(/__mutant_[0-9]+$/, "", base)
+            id = substr(fn, length(base) + 10)
+            if (code[fn] == code[base "__original"]) {
+                printf "%s\tobject_code\t0\n", id
+                continue
+            }
+            # The first mutant with this code stands for the others
+            for (j = 1; j < i; j++) {
+                if (order[j] ~ ("^" base "__mutant_") && code[fn] == code[order[j]]) {
+                    printf "%s\tobject_code\t%s\n", id, substr(order[j], length(base) + 10)
+                    break
+                }
+            }
+        }
+    }' > "${OUT}"